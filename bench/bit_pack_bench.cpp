@@ -0,0 +1,80 @@
+#include <memory>
+#include <vector>
+
+#include "modbus/core/bit_pack.hpp"
+#include "modbus/core/modbus_response.hpp"
+#include "modbus/core/requests.hpp"
+#include "modbus/core/types.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+using namespace modbus;
+
+std::vector<bool> make_coils(size_t count) {
+    std::vector<bool> coils(count);
+    for (size_t i = 0; i < count; i++) {
+        coils[i] = (i % 3) == 0;
+    }
+    return coils;
+}
+
+void write_coils_vector_bool(benchmark::State& state) {
+    auto coils = make_coils(state.range(0));
+    for (auto _ : state) {
+        write_multiple_coils_request request{17, 0, coils};
+        benchmark::DoNotOptimize(request.values.data());
+    }
+}
+
+void write_coils_span(benchmark::State& state) {
+    auto vectorCoils = make_coils(state.range(0));
+    std::unique_ptr<bool[]> coils(new bool[vectorCoils.size()]);
+    std::copy(vectorCoils.begin(), vectorCoils.end(), coils.get());
+    std::span<const bool> span(coils.get(), vectorCoils.size());
+
+    for (auto _ : state) {
+        write_multiple_coils_request request{17, 0, span};
+        benchmark::DoNotOptimize(request.values.data());
+    }
+}
+
+modbus_response_t make_response(size_t count) {
+    return modbus_response_t(data_model_t::coil,
+                             std::make_shared<buffer_t>((count + 7) / 8, 0x5A),
+                             0, (uint16_t)count);
+}
+
+/// The coils are read one at a time with getBool.
+void read_coils_get_bool(benchmark::State& state) {
+    auto response = make_response(state.range(0));
+    std::unique_ptr<bool[]> coils(new bool[state.range(0)]);
+    for (auto _ : state) {
+        for (int i = 0; i < state.range(0); i++) {
+            coils[i] = response.getBool(i);
+        }
+        benchmark::DoNotOptimize(coils.get());
+        benchmark::ClobberMemory();
+    }
+}
+
+void read_coils_get_bools(benchmark::State& state) {
+    auto response = make_response(state.range(0));
+    std::unique_ptr<bool[]> coils(new bool[state.range(0)]);
+    for (auto _ : state) {
+        response.getBools(0, std::span(coils.get(), state.range(0)));
+        benchmark::DoNotOptimize(coils.get());
+        benchmark::ClobberMemory();
+    }
+}
+
+} // namespace
+
+// 1968 coils is the largest write, 2000 the largest read
+BENCHMARK(write_coils_vector_bool)->Arg(1968);
+BENCHMARK(write_coils_span)->Arg(1968);
+BENCHMARK(read_coils_get_bool)->Arg(2000);
+BENCHMARK(read_coils_get_bools)->Arg(2000);
+
+BENCHMARK_MAIN();
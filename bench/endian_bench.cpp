@@ -0,0 +1,91 @@
+#include <numeric>
+#include <vector>
+
+#include "modbus/core/endian.hpp"
+#include "modbus/core/types.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+using namespace modbus;
+
+/// The conversion the messages used before the bulk routines were added.
+void store_bytewise(const std::vector<uint16_t>& from, uint8_t* to) {
+    for (auto word : from) {
+        *to++ = (uint8_t)(word >> 8);
+        *to++ = (uint8_t)(word & 0x00FF);
+    }
+}
+
+void load_bytewise(const uint8_t* from, std::vector<uint16_t>& to) {
+    for (auto& word : to) {
+        word = (uint16_t)(*from++ << 8);
+        word += *from++;
+    }
+}
+
+std::vector<uint16_t> make_registers(size_t count) {
+    std::vector<uint16_t> registers(count);
+    std::iota(registers.begin(), registers.end(), (uint16_t)0);
+    return registers;
+}
+
+void set_bytes_processed(benchmark::State& state) {
+    state.SetBytesProcessed((int64_t)state.iterations() * state.range(0) *
+                            sizeof(uint16_t));
+}
+
+void store_registers_bytewise(benchmark::State& state) {
+    auto registers = make_registers(state.range(0));
+    buffer_t data(registers.size() * 2);
+    for (auto _ : state) {
+        store_bytewise(registers, data.data());
+        benchmark::DoNotOptimize(data.data());
+        benchmark::ClobberMemory();
+    }
+    set_bytes_processed(state);
+}
+
+void store_registers_bulk(benchmark::State& state) {
+    auto registers = make_registers(state.range(0));
+    buffer_t data(registers.size() * 2);
+    for (auto _ : state) {
+        store_registers(registers, data.data());
+        benchmark::DoNotOptimize(data.data());
+        benchmark::ClobberMemory();
+    }
+    set_bytes_processed(state);
+}
+
+void load_registers_bytewise(benchmark::State& state) {
+    buffer_t data(state.range(0) * 2, 0x5A);
+    std::vector<uint16_t> registers(state.range(0));
+    for (auto _ : state) {
+        load_bytewise(data.data(), registers);
+        benchmark::DoNotOptimize(registers.data());
+        benchmark::ClobberMemory();
+    }
+    set_bytes_processed(state);
+}
+
+void load_registers_bulk(benchmark::State& state) {
+    buffer_t data(state.range(0) * 2, 0x5A);
+    std::vector<uint16_t> registers(state.range(0));
+    for (auto _ : state) {
+        load_registers(data.data(), registers);
+        benchmark::DoNotOptimize(registers.data());
+        benchmark::ClobberMemory();
+    }
+    set_bytes_processed(state);
+}
+
+} // namespace
+
+// 125 registers is the largest read response, 64K is a full register image
+BENCHMARK(store_registers_bytewise)->Arg(125)->Arg(65536);
+BENCHMARK(store_registers_bulk)->Arg(125)->Arg(65536);
+BENCHMARK(load_registers_bytewise)->Arg(125)->Arg(65536);
+BENCHMARK(load_registers_bulk)->Arg(125)->Arg(65536);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,126 @@
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+#include "modbus/core/encode.hpp"
+#include "modbus/core/frame_pool.hpp"
+#include "modbus/core/requests.hpp"
+#include "modbus/core/responses.hpp"
+#include "modbus/core/tcp_data_unit.hpp"
+#include "modbus/core/tcp_data_unit_view.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+std::atomic<size_t> allocations = 0;
+
+} // namespace
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+using namespace modbus;
+
+/// The storage tcp_data_unit used before frames were pooled.
+template <typename M>
+std::shared_ptr<buffer_t> encode_shared(uint16_t transactionId, const M& pdu) {
+    auto buffer = std::make_shared<buffer_t>(TCP_HEADER_SIZE + pdu.size());
+    encode(transactionId, pdu, *buffer);
+    return buffer;
+}
+
+void report_allocations(benchmark::State& state, size_t before) {
+    state.counters["allocs/op"] =
+        benchmark::Counter((double)(allocations.load() - before),
+                           benchmark::Counter::kAvgIterations);
+}
+
+/// The client encodes a request and keeps an owning copy of the response.
+void client_request_shared(benchmark::State& state) {
+    write_single_register_request request{17, 1, 3};
+    auto response =
+        encode_shared(0x0001, write_single_register_response{17, 1, 3});
+
+    size_t before = allocations.load();
+    uint16_t transactionId = 0;
+    for (auto _ : state) {
+        auto requestBuffer = encode_shared(transactionId++, request);
+        auto responseBuffer = std::make_shared<buffer_t>(*response);
+        benchmark::DoNotOptimize(requestBuffer->data());
+        benchmark::DoNotOptimize(responseBuffer->data());
+    }
+    report_allocations(state, before);
+}
+BENCHMARK(client_request_shared);
+
+void client_request_pooled(benchmark::State& state) {
+    frame_pool pool(16);
+    write_single_register_request request{17, 1, 3};
+    tcp_data_unit response(0x0001, write_single_register_response{17, 1, 3});
+    tcp_data_unit_view responseView = response.view();
+
+    size_t before = allocations.load();
+    uint16_t transactionId = 0;
+    for (auto _ : state) {
+        tcp_data_unit requestDataUnit(transactionId++, request, pool);
+        tcp_data_unit responseDataUnit(responseView, pool);
+        benchmark::DoNotOptimize(requestDataUnit.bytes().data());
+        benchmark::DoNotOptimize(responseDataUnit.bytes().data());
+    }
+    report_allocations(state, before);
+}
+BENCHMARK(client_request_pooled);
+
+/// The server parses a request in place and encodes the response.
+void server_request_shared(benchmark::State& state) {
+    auto request =
+        encode_shared(0x0001, write_single_register_request{17, 1, 3});
+
+    size_t before = allocations.load();
+    for (auto _ : state) {
+        tcp_data_unit_view view(*request, message_type::request);
+        auto pdu = view.pdu<write_single_register_request>();
+        auto responseBuffer = encode_shared(
+            view.transaction_id(),
+            write_single_register_response{pdu->unit_id, pdu->start_address,
+                                           pdu->value});
+        benchmark::DoNotOptimize(responseBuffer->data());
+    }
+    report_allocations(state, before);
+}
+BENCHMARK(server_request_shared);
+
+void server_request_pooled(benchmark::State& state) {
+    frame_pool pool(16);
+    auto request =
+        encode_shared(0x0001, write_single_register_request{17, 1, 3});
+
+    size_t before = allocations.load();
+    for (auto _ : state) {
+        tcp_data_unit_view view(*request, message_type::request);
+        auto pdu = view.pdu<write_single_register_request>();
+        write_single_register_response message{pdu->unit_id,
+                                               pdu->start_address, pdu->value};
+        tcp_data_unit response(view.transaction_id(), message, pool);
+        benchmark::DoNotOptimize(response.bytes().data());
+    }
+    report_allocations(state, before);
+}
+BENCHMARK(server_request_pooled);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,128 @@
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "modbus/client.hpp"
+#include "modbus/server.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+using namespace modbus;
+
+const uint16_t SUBMIT_BENCH_PORT = 5140;
+
+awaitable<tcp_data_unit> zero_handler(tcp_data_unit_view request) {
+    auto read = request.pdu<read_holding_registers_request>();
+    std::vector<uint16_t> values(read ? read->length : 1);
+    co_return tcp_data_unit(
+        request.transaction_id(),
+        read_holding_registers_response(request.unit_id(), values));
+}
+
+/// A server and a client that each run on their own thread, so that the
+/// benchmark thread is foreign to both.
+class loopback {
+  public:
+    loopback()
+        : server_ctx_(1)
+        , client_ctx_(1)
+        , work_(asio::make_work_guard(client_ctx_))
+        , server_(server_ctx_.get_executor(),
+                  request_view_handler_t(zero_handler),
+                  server_config{std::string("127.0.0.1"), SUBMIT_BENCH_PORT})
+        , client_(asio::make_strand(client_ctx_),
+                  client_config("127.0.0.1", SUBMIT_BENCH_PORT)
+                      .set_warm_connections(1)) {
+        co_spawn(server_ctx_, server_.start(), detached);
+        server_thread_ = std::thread([this]() { server_ctx_.run(); });
+        client_thread_ = std::thread([this]() { client_ctx_.run(); });
+    }
+
+    ~loopback() {
+        work_.reset();
+        client_ctx_.stop();
+        client_thread_.join();
+        server_.stop();
+        server_ctx_.stop();
+        server_thread_.join();
+    }
+
+    tcp_client& client() { return client_; }
+    asio::io_context& client_context() { return client_ctx_; }
+
+  private:
+    asio::io_context server_ctx_;
+    asio::io_context client_ctx_;
+    asio::executor_work_guard<asio::io_context::executor_type> work_;
+    tcp_server server_;
+    tcp_client client_;
+    std::thread server_thread_;
+    std::thread client_thread_;
+};
+
+/// Submits a read from the benchmark thread and waits for its future.
+void submit_future(benchmark::State& state) {
+    loopback loop;
+    auto& client = loop.client();
+    for (auto _ : state) {
+        auto response =
+            client
+                .submit(client.create_request(
+                    read_holding_registers_request{1, 0, 1}))
+                .get();
+        benchmark::DoNotOptimize(response);
+    }
+}
+
+/// The pattern submit replaces: spawn a coroutine from the benchmark thread
+/// and fulfil a promise from it.
+void post_promise(benchmark::State& state) {
+    loopback loop;
+    auto& client = loop.client();
+    for (auto _ : state) {
+        auto promise = std::make_shared<std::promise<read_response_t>>();
+        auto request =
+            client.create_request(read_holding_registers_request{1, 0, 1});
+        co_spawn(
+            loop.client_context(),
+            [&client, promise, request]() -> awaitable<void> {
+                promise->set_value(co_await client.send_request(request));
+            },
+            detached);
+        auto response = promise->get_future().get();
+        benchmark::DoNotOptimize(response);
+    }
+}
+
+/// Several threads submit at once.
+void submit_future_contended(benchmark::State& state) {
+    static loopback* loop = nullptr;
+    if (state.thread_index() == 0) {
+        loop = new loopback();
+    }
+    // google benchmark starts every thread's loop together
+    for (auto _ : state) {
+        auto& client = loop->client();
+        auto response =
+            client
+                .submit(client.create_request(
+                    read_holding_registers_request{1, 0, 1}))
+                .get();
+        benchmark::DoNotOptimize(response);
+    }
+    if (state.thread_index() == 0) {
+        delete loop;
+        loop = nullptr;
+    }
+}
+
+} // namespace
+
+BENCHMARK(submit_future)->UseRealTime();
+BENCHMARK(post_promise)->UseRealTime();
+BENCHMARK(submit_future_contended)->Threads(4)->UseRealTime();
+
+BENCHMARK_MAIN();
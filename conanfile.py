@@ -18,15 +18,21 @@ class ModbusClientConan(ConanFile):
     topics = ("modbus", "asio")
     exports = ["LICENSE"]
     exports_sources = ["CMakeLists.txt", "conan.cmake",
-                       "conanfile.py", "modbus/*", "test/*"]
+                       "conanfile.py", "modbus/*", "test/*", "bench/*"]
     generators = "cmake"
     settings = "os", "arch", "compiler", "build_type"
     requires = "cpool/main_23c5e65a0f9b", "boost/1.78.0", "fmt/8.1.1", "abseil/20211102.0"
     build_requires = "gtest/cci.20210126"
     options = {"cxx_standard": [20, 23], "build_testing": [
-        True, False], "trace_logging": [True, False]}
+        True, False], "build_benchmarks": [True, False],
+        "trace_logging": [True, False], "frame_cache_size": "ANY"}
     default_options = {"cxx_standard": 20,
-                       "build_testing": True, "trace_logging": False}
+                       "build_testing": True, "build_benchmarks": False,
+                       "trace_logging": False, "frame_cache_size": 16}
+
+    def build_requirements(self):
+        if self.options.build_benchmarks:
+            self.build_requires("benchmark/1.6.1")
 
     def config_options(self):
         if self.settings.os == "Windows":
@@ -54,7 +60,9 @@ class ModbusClientConan(ConanFile):
         cmake = CMake(self)
         cmake.definitions["CMAKE_CXX_STANDARD"] = self.options.cxx_standard
         cmake.definitions["BUILD_TESTING"] = self.options.build_testing
+        cmake.definitions["BUILD_BENCHMARKS"] = self.options.build_benchmarks
         cmake.definitions["CPOOL_TRACE_LOGGING"] = self.options.trace_logging
+        cmake.definitions["MODBUS_FRAME_CACHE_SIZE"] = self.options.frame_cache_size
         cmake.configure()
         cmake.build()
         cmake.test()
@@ -66,3 +74,6 @@ class ModbusClientConan(ConanFile):
 
     def package_info(self):
         self.cpp_info.libs = ["modbus"]
+        # asio's thread-local frame cache must be the same size everywhere
+        self.cpp_info.defines = [
+            "BOOST_ASIO_RECYCLING_ALLOCATOR_CACHE_SIZE=%s" % self.options.frame_cache_size]
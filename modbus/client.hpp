@@ -1,10 +1,25 @@
 #pragma once
 
 #include "modbus/client/client_config.hpp"
+#include "modbus/client/device_fleet.hpp"
+#include "modbus/client/fleet_config.hpp"
+#include "modbus/client/poll_group.hpp"
+#include "modbus/client/read_cache.hpp"
+#include "modbus/client/rtt_estimator.hpp"
 #include "modbus/client/tcp_client.hpp"
+#include "modbus/client/timer_wheel.hpp"
+#include "modbus/client/unit_scheduler.hpp"
+#include "modbus/client/write_queue.hpp"
+#include "modbus/core/decode.hpp"
+#include "modbus/core/encode.hpp"
 #include "modbus/core/error.hpp"
 #include "modbus/core/modbus_response.hpp"
+#include "modbus/core/read_planner.hpp"
 #include "modbus/core/requests.hpp"
 #include "modbus/core/responses.hpp"
 #include "modbus/core/tcp_data_unit.hpp"
-#include "modbus/core/types.hpp"
\ No newline at end of file
+#include "modbus/core/tcp_data_unit_view.hpp"
+#include "modbus/core/tcp_framer.hpp"
+#include "modbus/core/types.hpp"
+#include "modbus/core/views.hpp"
+#include "modbus/core/visit.hpp"
\ No newline at end of file
@@ -2,36 +2,147 @@
 
 #include <chrono>
 #include <cstdint>
+#include <memory>
 #include <string>
 
+#include "modbus/core/frame_pool.hpp"
 #include "modbus/core/types.hpp"
 
 namespace modbus {
 
 constexpr uint16_t DEFAULT_CLIENT_MAX_CONNECTIONS = 1;
+constexpr uint16_t DEFAULT_CLIENT_PIPELINE_DEPTH = 1;
 constexpr std::chrono::milliseconds DEFAULT_CONNECT_TIMEOUT =
     std::chrono::seconds(10);
+constexpr std::chrono::milliseconds DEFAULT_RETRY_BACKOFF(20);
+
+/**
+ * @brief The options set on each client socket once it has connected. Sizes
+ * and times of 0 leave the system default in place.
+ */
+struct socket_options {
+    /// Sets TCP_NODELAY so that small requests are not held back by Nagle's
+    /// algorithm.
+    bool no_delay;
+    /// Sets SO_KEEPALIVE so that a silent peer is noticed on idle connections.
+    bool keep_alive;
+    /// The idle time before the first keep-alive probe (TCP_KEEPIDLE).
+    std::chrono::seconds keep_alive_idle;
+    /// The time between keep-alive probes (TCP_KEEPINTVL).
+    std::chrono::seconds keep_alive_interval;
+    /// The number of unanswered probes before the connection is dropped
+    /// (TCP_KEEPCNT).
+    uint16_t keep_alive_count;
+    /// The size of the receive buffer (SO_RCVBUF) in bytes.
+    int receive_buffer_size;
+    /// The size of the send buffer (SO_SNDBUF) in bytes.
+    int send_buffer_size;
+
+    socket_options()
+        : no_delay(true)
+        , keep_alive(false)
+        , keep_alive_idle(0)
+        , keep_alive_interval(0)
+        , keep_alive_count(0)
+        , receive_buffer_size(0)
+        , send_buffer_size(0) {}
+
+    socket_options set_no_delay(bool no_delay) {
+        this->no_delay = no_delay;
+        return *this;
+    }
+
+    socket_options set_keep_alive(bool keep_alive) {
+        this->keep_alive = keep_alive;
+        return *this;
+    }
+
+    socket_options set_keep_alive_idle(std::chrono::seconds keep_alive_idle) {
+        this->keep_alive_idle = keep_alive_idle;
+        return *this;
+    }
+
+    socket_options
+    set_keep_alive_interval(std::chrono::seconds keep_alive_interval) {
+        this->keep_alive_interval = keep_alive_interval;
+        return *this;
+    }
+
+    socket_options set_keep_alive_count(uint16_t keep_alive_count) {
+        this->keep_alive_count = keep_alive_count;
+        return *this;
+    }
+
+    socket_options set_receive_buffer_size(int receive_buffer_size) {
+        this->receive_buffer_size = receive_buffer_size;
+        return *this;
+    }
+
+    socket_options set_send_buffer_size(int send_buffer_size) {
+        this->send_buffer_size = send_buffer_size;
+        return *this;
+    }
+};
 
 struct client_config {
     std::string host;
     uint16_t port;
     uint16_t max_connections;
+    /// The number of requests that may be in flight on each connection. With
+    /// a depth of 1 requests take turns; with more, requests are pipelined.
+    /// @see tcp_pipeline
+    uint16_t pipeline_depth;
     std::chrono::milliseconds connect_timeout;
+    /// Whether requests sent without a timeout time out after the timeout
+    /// derived from the measured round trip times. @see rtt_estimator
+    bool adaptive_timeout;
+    /// The number of times a read (function codes 1 to 4) that timed out is
+    /// sent again. Other requests are never retried.
+    uint16_t read_retries;
+    /// The delay before the first retry. It doubles with each retry and is
+    /// jittered by up to half in either direction.
+    std::chrono::milliseconds retry_backoff;
+    /// A read that has not been answered within this percentile of the recent
+    /// round trip times is sent again on another connection and the first
+    /// response wins. 0 disables hedging, which needs max_connections > 1.
+    double hedge_percentile;
+    /// The number of connections opened when the client is created and kept
+    /// open when one fails, up to max_connections. 0 connects on demand.
+    uint16_t warm_connections;
+    /// The options set on each connection.
+    socket_options sockets;
     logging_handler_t logging_handler;
+    std::shared_ptr<frame_pool> frames;
 
     client_config()
         : host("127.0.0.1")
         , port(502)
         , max_connections(DEFAULT_CLIENT_MAX_CONNECTIONS)
+        , pipeline_depth(DEFAULT_CLIENT_PIPELINE_DEPTH)
         , connect_timeout(DEFAULT_CONNECT_TIMEOUT)
-        , logging_handler(null_logging_handler) {}
+        , adaptive_timeout(false)
+        , read_retries(0)
+        , retry_backoff(DEFAULT_RETRY_BACKOFF)
+        , hedge_percentile(0)
+        , warm_connections(0)
+        , sockets()
+        , logging_handler(null_logging_handler)
+        , frames(frame_pool::default_pool()) {}
 
     client_config(std::string host, uint16_t port)
         : host(host)
         , port(port)
         , max_connections(DEFAULT_CLIENT_MAX_CONNECTIONS)
+        , pipeline_depth(DEFAULT_CLIENT_PIPELINE_DEPTH)
         , connect_timeout(DEFAULT_CONNECT_TIMEOUT)
-        , logging_handler(null_logging_handler) {}
+        , adaptive_timeout(false)
+        , read_retries(0)
+        , retry_backoff(DEFAULT_RETRY_BACKOFF)
+        , hedge_percentile(0)
+        , warm_connections(0)
+        , sockets()
+        , logging_handler(null_logging_handler)
+        , frames(frame_pool::default_pool()) {}
 
     client_config set_host(std::string host) {
         this->host = host;
@@ -48,16 +159,56 @@ struct client_config {
         return *this;
     }
 
+    client_config set_pipeline_depth(uint16_t pipeline_depth) {
+        this->pipeline_depth = pipeline_depth;
+        return *this;
+    }
+
     client_config
     set_connect_timeout(std::chrono::milliseconds connect_timeout) {
         this->connect_timeout = connect_timeout;
         return *this;
     }
 
+    client_config set_adaptive_timeout(bool adaptive_timeout) {
+        this->adaptive_timeout = adaptive_timeout;
+        return *this;
+    }
+
+    client_config set_read_retries(uint16_t read_retries) {
+        this->read_retries = read_retries;
+        return *this;
+    }
+
+    client_config set_retry_backoff(std::chrono::milliseconds retry_backoff) {
+        this->retry_backoff = retry_backoff;
+        return *this;
+    }
+
+    client_config set_hedge_percentile(double hedge_percentile) {
+        this->hedge_percentile = hedge_percentile;
+        return *this;
+    }
+
+    client_config set_warm_connections(uint16_t warm_connections) {
+        this->warm_connections = warm_connections;
+        return *this;
+    }
+
+    client_config set_socket_options(socket_options sockets) {
+        this->sockets = sockets;
+        return *this;
+    }
+
     client_config set_logging_handler(logging_handler_t handler) {
         this->logging_handler = handler;
         return *this;
     }
+
+    client_config set_frame_pool(std::shared_ptr<frame_pool> frames) {
+        this->frames = frames;
+        return *this;
+    }
 };
 
 } // namespace modbus
@@ -0,0 +1,308 @@
+#include "modbus/client/device_fleet.hpp"
+
+#include <algorithm>
+
+#include <absl/cleanup/cleanup.h>
+#include <boost/asio/experimental/as_tuple.hpp>
+
+namespace modbus {
+
+using boost::asio::use_awaitable;
+using boost::asio::experimental::as_tuple;
+
+device_fleet::ticket::ticket(cpool::net::any_io_executor exec)
+    : signal(exec, clock_type::time_point::max())
+    , expiry([this]() {
+        expired = true;
+        signal.cancel();
+    }) {}
+
+void device_fleet::ticket_list::push_back(ticket& t) noexcept {
+    t.prev = tail;
+    t.next = nullptr;
+    if (tail != nullptr) {
+        tail->next = &t;
+    } else {
+        head = &t;
+    }
+    tail = &t;
+    size++;
+}
+
+device_fleet::ticket* device_fleet::ticket_list::pop_front() noexcept {
+    ticket* t = head;
+    if (t != nullptr) {
+        erase(*t);
+    }
+    return t;
+}
+
+void device_fleet::ticket_list::erase(ticket& t) noexcept {
+    if (t.prev != nullptr) {
+        t.prev->next = t.next;
+    } else {
+        head = t.next;
+    }
+    if (t.next != nullptr) {
+        t.next->prev = t.prev;
+    } else {
+        tail = t.prev;
+    }
+    t.prev = nullptr;
+    t.next = nullptr;
+    size--;
+}
+
+device_fleet::device_fleet(cpool::net::any_io_executor exec,
+                           fleet_config config)
+    : exec_(exec)
+    , wheel_(exec)
+    , config_(config)
+    , devices_()
+    , in_flight_(0)
+    , ready_()
+    , free_buffers_()
+    , transaction_id_(1)
+    , on_log_(config_.logging_handler) {
+    config_.max_in_flight = std::max<size_t>(config_.max_in_flight, 1);
+    config_.pipeline_depth = std::max<uint16_t>(config_.pipeline_depth, 1);
+}
+
+device_id device_fleet::add_device(std::string host, uint16_t port) {
+    auto& d = devices_.emplace_back();
+    d.host = std::move(host);
+    d.port = port;
+    return static_cast<device_id>(devices_.size() - 1);
+}
+
+bool device_fleet::connected(device_id device) const {
+    const auto& d = devices_.at(device);
+    return d.connection != nullptr && d.connection->connected();
+}
+
+awaitable<read_response_t>
+device_fleet::send_request(device_id device, const tcp_data_unit& request,
+                           std::chrono::milliseconds timeout) {
+    auto deadline = to_deadline(timeout);
+    auto error = co_await acquire(device, deadline);
+    if (error) {
+        co_return read_response_t(tcp_data_unit(), error);
+    }
+    auto defer_release = absl::Cleanup([&]() { release(device); });
+
+    // only requests that have a turn hold a buffer
+    auto buffer = take_buffer();
+    auto defer_return =
+        absl::Cleanup([&]() { return_buffer(std::move(buffer)); });
+
+    auto [response, sendError] =
+        co_await exchange(devices_[device], request.view(), *buffer, deadline);
+    if (sendError) {
+        co_return read_response_t(tcp_data_unit(), sendError);
+    }
+
+    co_return read_response_t(tcp_data_unit(response, *config_.frames),
+                              sendError);
+}
+
+awaitable<read_response_view_t>
+device_fleet::send_request(device_id device, tcp_data_unit_view request,
+                           std::span<uint8_t> response_buffer,
+                           std::chrono::milliseconds timeout) {
+    auto deadline = to_deadline(timeout);
+    auto error = co_await acquire(device, deadline);
+    if (error) {
+        co_return read_response_view_t(tcp_data_unit_view(), error);
+    }
+    auto defer_release = absl::Cleanup([&]() { release(device); });
+
+    co_return co_await exchange(devices_[device], request, response_buffer,
+                                deadline);
+}
+
+awaitable<cpool::error>
+device_fleet::acquire(device_id id, clock_type::time_point deadline) {
+    ticket turn(exec_);
+    auto& d = devices_.at(id);
+    d.stats.requests++;
+    d.waiting.push_back(turn);
+    // a turn that was granted has already left the queue; one that was not
+    // must not be left behind however the wait ends
+    auto defer_remove = absl::Cleanup([&d, &turn]() {
+        if (!turn.granted) {
+            d.waiting.erase(turn);
+        }
+    });
+    schedule(id);
+    dispatch();
+
+    auto error = co_await wait(turn, deadline);
+    if (error) {
+        d.stats.failures++;
+        if (is_timeout(error)) {
+            d.stats.timeouts++;
+        }
+    }
+
+    co_return error;
+}
+
+void device_fleet::release(device_id id) {
+    auto& d = devices_[id];
+    d.in_flight--;
+    in_flight_--;
+    if (d.pipeline != nullptr && d.pipeline->failed()) {
+        // the next request opens the connection again if it was closed
+        d.pipeline.reset();
+    }
+    schedule(id);
+    dispatch();
+}
+
+void device_fleet::schedule(device_id id) {
+    auto& d = devices_[id];
+    if (!d.scheduled && d.waiting.size > 0 &&
+        d.in_flight < config_.pipeline_depth) {
+        d.scheduled = true;
+        ready_.push_back(id);
+    }
+}
+
+void device_fleet::dispatch() {
+    // each device gets one turn before it goes to the back of the ring
+    while (in_flight_ < config_.max_in_flight && !ready_.empty()) {
+        device_id id = ready_.front();
+        ready_.pop_front();
+
+        auto& d = devices_[id];
+        d.scheduled = false;
+        if (d.waiting.size == 0 || d.in_flight >= config_.pipeline_depth) {
+            continue;
+        }
+
+        ticket* turn = d.waiting.pop_front();
+        d.in_flight++;
+        in_flight_++;
+        turn->granted = true;
+        turn->signal.cancel();
+
+        schedule(id);
+    }
+}
+
+awaitable<std::tuple<std::shared_ptr<tcp_pipeline>, cpool::error>>
+device_fleet::get_pipeline(device& d, clock_type::time_point deadline) {
+    using result_t = std::tuple<std::shared_ptr<tcp_pipeline>, cpool::error>;
+
+    // the other requests in flight wait for the one that is connecting
+    while (d.connecting) {
+        ticket opened(exec_);
+        d.connect_waiters.push_back(opened);
+        auto defer_remove = absl::Cleanup([&d, &opened]() {
+            if (!opened.granted) {
+                d.connect_waiters.erase(opened);
+            }
+        });
+        auto error = co_await wait(opened, deadline);
+        if (error) {
+            co_return result_t(nullptr, error);
+        }
+    }
+
+    if (d.pipeline != nullptr && !d.pipeline->failed()) {
+        co_return result_t(d.pipeline, cpool::error());
+    }
+
+    if (d.connection == nullptr) {
+        d.connection =
+            std::make_unique<cpool::tcp_connection>(exec_, d.host, d.port);
+    }
+
+    if (!d.connection->connected()) {
+        on_log_(log_level::info,
+                fmt::format("connecting to {0}:{1}", d.host, d.port));
+        d.connecting = true;
+        d.connection->expires_after(config_.connect_timeout);
+        auto error = co_await d.connection->async_connect();
+        d.connection->expires_never();
+        d.connecting = false;
+        while (auto waiter = d.connect_waiters.pop_front()) {
+            waiter->granted = true;
+            waiter->signal.cancel();
+        }
+
+        if (error) {
+            on_log_(log_level::warn,
+                    fmt::format("failed to connect to {0}:{1}: {2}", d.host,
+                                d.port, error.message()));
+            co_return result_t(nullptr, error);
+        }
+        d.stats.connects++;
+    }
+
+    d.pipeline = std::make_shared<tcp_pipeline>(
+        exec_, d.connection.get(), config_.pipeline_depth, on_log_);
+    co_return result_t(d.pipeline, cpool::error());
+}
+
+awaitable<read_response_view_t>
+device_fleet::exchange(device& d, tcp_data_unit_view request,
+                       std::span<uint8_t> response_buffer,
+                       clock_type::time_point deadline) {
+    auto [pipeline, error] = co_await get_pipeline(d, deadline);
+    if (!error) {
+        auto start = clock_type::now();
+        tcp_data_unit_view response;
+        std::tie(response, error) =
+            co_await pipeline->send_request(request, response_buffer, deadline);
+        if (!error) {
+            auto latency =
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    clock_type::now() - start);
+            d.stats.last_latency = latency;
+            d.stats.max_latency = std::max(d.stats.max_latency, latency);
+            d.stats.total_latency += latency;
+            co_return read_response_view_t(response, error);
+        }
+    }
+
+    d.stats.failures++;
+    if (is_timeout(error)) {
+        d.stats.timeouts++;
+    }
+    co_return read_response_view_t(tcp_data_unit_view(), error);
+}
+
+awaitable<cpool::error>
+device_fleet::wait(ticket& t, clock_type::time_point deadline) {
+    if (deadline != clock_type::time_point::max()) {
+        wheel_.schedule(t.expiry, deadline);
+    }
+
+    while (!t.granted) {
+        if (is_cancelled(co_await asio::this_coro::cancellation_state)) {
+            co_return modbus_client_error_code::cancelled;
+        }
+        if (t.expired) {
+            co_return modbus_client_error_code::write_timeout;
+        }
+        co_await t.signal.async_wait(as_tuple(use_awaitable));
+    }
+
+    co_return cpool::error();
+}
+
+std::unique_ptr<device_fleet::response_buffer_t> device_fleet::take_buffer() {
+    if (free_buffers_.empty()) {
+        return std::make_unique<response_buffer_t>();
+    }
+    auto buffer = std::move(free_buffers_.back());
+    free_buffers_.pop_back();
+    return buffer;
+}
+
+void device_fleet::return_buffer(std::unique_ptr<response_buffer_t> buffer) {
+    free_buffers_.push_back(std::move(buffer));
+}
+
+} // namespace modbus
@@ -0,0 +1,316 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <cpool/tcp_connection.hpp>
+
+#include "modbus/client/fleet_config.hpp"
+#include "modbus/client/tcp_pipeline.hpp"
+#include "modbus/client/timer_wheel.hpp"
+#include "modbus/core/error.hpp"
+#include "modbus/core/tcp_data_unit.hpp"
+#include "modbus/core/tcp_data_unit_view.hpp"
+#include "modbus/core/types.hpp"
+
+namespace modbus {
+
+namespace asio = boost::asio;
+using boost::asio::awaitable;
+
+/// Identifies a device of a device_fleet.
+using device_id = uint32_t;
+
+/**
+ * @brief The traffic to one device of a device_fleet.
+ */
+struct device_stats {
+    /// The number of requests submitted.
+    size_t requests = 0;
+    /// The number of requests that failed, including timeouts.
+    size_t failures = 0;
+    /// The number of requests that timed out waiting for a turn or a response.
+    size_t timeouts = 0;
+    /// The number of times the connection was opened.
+    size_t connects = 0;
+    /// The round trip time of the last response.
+    std::chrono::microseconds last_latency{0};
+    /// The longest round trip time.
+    std::chrono::microseconds max_latency{0};
+    /// The sum of the round trip times of all responses.
+    std::chrono::microseconds total_latency{0};
+
+    /**
+     * @return The number of requests that received a response.
+     */
+    size_t responses() const noexcept { return requests - failures; }
+
+    /**
+     * @return The average round trip time of the responses.
+     */
+    std::chrono::microseconds mean_latency() const noexcept {
+        if (responses() == 0) {
+            return std::chrono::microseconds(0);
+        }
+        return total_latency / static_cast<int64_t>(responses());
+    }
+};
+
+/**
+ * @brief Sends requests to many devices from one executor under a single
+ * concurrency budget.
+ *
+ * @section A tcp_client owns a connection pool per endpoint, which is more
+ * than a poller of thousands of devices needs. A fleet keeps one small record
+ * per device and opens a single connection to it when the first request is
+ * sent. Nothing runs for an idle device: there is no per-device timer or
+ * reader, and the reader of a request only runs while it is in flight. The
+ * deadlines of queued requests are kept on one timer_wheel for the whole
+ * fleet rather than on a timer each.
+ *
+ * @section Requests queue per device. At most pipeline_depth requests are in
+ * flight to each device and at most max_in_flight across the fleet. When the
+ * budget has room, devices with queued requests take turns in round-robin
+ * order, so a device with a deep queue cannot starve the others. Responses
+ * to tcp_data_unit requests are read into buffers that are shared by the
+ * fleet, so queued requests hold no buffer.
+ *
+ * @section A request honours the cancellation slot of the coroutine that
+ * awaits it. A cancelled request leaves the queue of its device at once and
+ * fails with modbus_client_error_code::cancelled.
+ *
+ * @section Devices are never removed, so a device_id stays valid for the life
+ * of the fleet. All members must be called from the executor of the fleet,
+ * and the fleet must be destroyed after that executor has stopped.
+ */
+class device_fleet {
+  public:
+    /**
+     * @brief Creates an empty fleet.
+     * @param exec The Asio executor to use for event handling.
+     * @param config The configuration object.
+     */
+    device_fleet(cpool::net::any_io_executor exec, fleet_config config);
+
+    device_fleet(const device_fleet&) = delete;
+    device_fleet& operator=(const device_fleet&) = delete;
+
+    /**
+     * @brief Adds a device. It is not connected until a request is sent to it.
+     * @param host The host name or address of the device.
+     * @param port The port of the device.
+     * @return The ID to send requests to the device with.
+     */
+    device_id add_device(std::string host, uint16_t port);
+
+    /**
+     * @brief Reserves a transaction ID for creation of a tcp_data_unit
+     * @return uint16_t The transaction ID to use in the request.
+     */
+    uint16_t reserve_transaction_id() { return transaction_id_++; }
+
+    /**
+     * @brief Reserves a transaction ID and creates a tcp_data_unit that can be
+     * sent using send_request.
+     * @param request An object that meets the requirements of is_message and
+     * describes a MODBUS request.
+     * @returns tcp_data_unit The MODBUS request as a TCP Data Unit
+     */
+    template <typename M> tcp_data_unit create_request(const M& request) {
+        return tcp_data_unit(reserve_transaction_id(), request,
+                             *config_.frames);
+    }
+
+    /**
+     * @brief Queues a request behind the other requests to the same device
+     * and sends it when its turn comes.
+     * @param device The device to send the request to.
+     * @param request The request to send to the device.
+     * @param timeout The time to wait for a turn, a connection and a response
+     * before declaring a request a failure.
+     * @return awaitable<read_response_t> An awaitable tuple
+     * with the response and an error if any
+     */
+    [[nodiscard]] awaitable<read_response_t> send_request(
+        device_id device, const tcp_data_unit& request,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Queues a request behind the other requests to the same device
+     * and sends it when its turn comes. The response is read into a buffer
+     * owned by the caller.
+     * @param device The device to send the request to.
+     * @param request A view of the encoded request.
+     * @param response_buffer The buffer the response is read into. It should
+     * hold at least MAX_APU_SIZE bytes and must outlive the returned view.
+     * @param timeout The time to wait for a turn, a connection and a response
+     * before declaring a request a failure.
+     * @return awaitable<read_response_view_t> An awaitable tuple
+     * with a view of the response and an error if any
+     */
+    [[nodiscard]] awaitable<read_response_view_t> send_request(
+        device_id device, tcp_data_unit_view request,
+        std::span<uint8_t> response_buffer,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @return The number of devices in the fleet.
+     */
+    size_t size() const noexcept { return devices_.size(); }
+
+    /**
+     * @return The traffic to device.
+     */
+    const device_stats& stats(device_id device) const {
+        return devices_.at(device).stats;
+    }
+
+    /**
+     * @return true if the connection to device is open.
+     */
+    bool connected(device_id device) const;
+
+    /**
+     * @return The number of requests to device waiting for a turn.
+     */
+    size_t queued(device_id device) const {
+        return devices_.at(device).waiting.size;
+    }
+
+    /**
+     * @return The number of requests in flight to device.
+     */
+    size_t in_flight(device_id device) const {
+        return devices_.at(device).in_flight;
+    }
+
+    /**
+     * @return The number of requests in flight across the fleet.
+     */
+    size_t in_flight() const noexcept { return in_flight_; }
+
+  private:
+    using clock_type = tcp_pipeline::clock_type;
+    using response_buffer_t = std::array<uint8_t, MAX_APU_SIZE>;
+
+    /// A request waiting for its turn or for a connection.
+    struct ticket {
+        explicit ticket(cpool::net::any_io_executor exec);
+
+        /// Cancelled when the wait is over. It never expires by itself.
+        asio::steady_timer signal;
+        /// Cancels signal at the deadline, on the wheel of the fleet.
+        timer_wheel::entry expiry;
+        /// Whether the wait is over.
+        bool granted = false;
+        /// Whether the deadline passed before the wait was over.
+        bool expired = false;
+        ticket* prev = nullptr;
+        ticket* next = nullptr;
+    };
+
+    /// A queue of tickets that are linked through the tickets themselves, so
+    /// that an idle device holds no queue storage.
+    struct ticket_list {
+        ticket* head = nullptr;
+        ticket* tail = nullptr;
+        size_t size = 0;
+
+        void push_back(ticket& t) noexcept;
+        ticket* pop_front() noexcept;
+        void erase(ticket& t) noexcept;
+    };
+
+    struct device {
+        std::string host;
+        uint16_t port;
+        /// Opened by the first request.
+        std::unique_ptr<cpool::tcp_connection> connection;
+        /// The requests in flight over connection.
+        std::shared_ptr<tcp_pipeline> pipeline;
+        /// Whether a request is opening connection.
+        bool connecting = false;
+        /// Requests waiting for connection to open.
+        ticket_list connect_waiters;
+        /// Requests waiting for a turn, oldest first.
+        ticket_list waiting;
+        /// The number of requests in flight.
+        size_t in_flight = 0;
+        /// Whether the device is in the round-robin ring.
+        bool scheduled = false;
+        device_stats stats;
+    };
+
+    /**
+     * @brief Waits for a turn to send a request to the device.
+     * @return write_timeout if the deadline passed first, or cancelled if the
+     * caller was cancelled.
+     */
+    [[nodiscard]] awaitable<cpool::error>
+    acquire(device_id id, clock_type::time_point deadline);
+
+    /**
+     * @brief Ends a turn and hands the freed budget to the next device.
+     */
+    void release(device_id id);
+
+    void schedule(device_id id);
+
+    void dispatch();
+
+    /**
+     * @brief Returns a pipeline over an open connection to the device,
+     * opening the connection if needed.
+     */
+    [[nodiscard]] awaitable<std::tuple<std::shared_ptr<tcp_pipeline>,
+                                       cpool::error>>
+    get_pipeline(device& d, clock_type::time_point deadline);
+
+    /**
+     * @brief Sends a request that has its turn and records its round trip.
+     */
+    [[nodiscard]] awaitable<read_response_view_t>
+    exchange(device& d, tcp_data_unit_view request,
+             std::span<uint8_t> response_buffer,
+             clock_type::time_point deadline);
+
+    /**
+     * @brief Waits until t is granted, the deadline passes or the caller is
+     * cancelled.
+     * @return write_timeout if the deadline passed first, or cancelled if the
+     * caller was cancelled.
+     */
+    [[nodiscard]] awaitable<cpool::error>
+    wait(ticket& t, clock_type::time_point deadline);
+
+    std::unique_ptr<response_buffer_t> take_buffer();
+
+    void return_buffer(std::unique_ptr<response_buffer_t> buffer);
+
+  private:
+    /// The io_service that is used to schedule asynchronous events.
+    cpool::net::any_io_executor exec_;
+    /// Keeps the deadlines of the queued requests of every device.
+    timer_wheel wheel_;
+    /// The configuration options of the fleet.
+    fleet_config config_;
+    /// The devices by ID. A deque keeps references valid as devices are added.
+    std::deque<device> devices_;
+    /// The number of requests in flight across the fleet.
+    size_t in_flight_;
+    /// Devices with waiting requests and room for another, in turn order.
+    std::deque<device_id> ready_;
+    /// Response buffers that are not in use. At most max_in_flight exist.
+    std::vector<std::unique_ptr<response_buffer_t>> free_buffers_;
+    uint16_t transaction_id_;
+    logging_handler_t on_log_;
+};
+
+} // namespace modbus
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "modbus/client/client_config.hpp"
+#include "modbus/core/frame_pool.hpp"
+#include "modbus/core/types.hpp"
+
+namespace modbus {
+
+constexpr size_t DEFAULT_FLEET_MAX_IN_FLIGHT = 64;
+
+struct fleet_config {
+    /// The number of requests that may be in flight across all devices.
+    size_t max_in_flight;
+    /// The number of requests that may be in flight to each device. Each
+    /// device has a single connection, so more than 1 pipelines requests.
+    uint16_t pipeline_depth;
+    std::chrono::milliseconds connect_timeout;
+    logging_handler_t logging_handler;
+    std::shared_ptr<frame_pool> frames;
+
+    fleet_config()
+        : max_in_flight(DEFAULT_FLEET_MAX_IN_FLIGHT)
+        , pipeline_depth(DEFAULT_CLIENT_PIPELINE_DEPTH)
+        , connect_timeout(DEFAULT_CONNECT_TIMEOUT)
+        , logging_handler(null_logging_handler)
+        , frames(frame_pool::default_pool()) {}
+
+    fleet_config set_max_in_flight(size_t max_in_flight) {
+        this->max_in_flight = max_in_flight;
+        return *this;
+    }
+
+    fleet_config set_pipeline_depth(uint16_t pipeline_depth) {
+        this->pipeline_depth = pipeline_depth;
+        return *this;
+    }
+
+    fleet_config
+    set_connect_timeout(std::chrono::milliseconds connect_timeout) {
+        this->connect_timeout = connect_timeout;
+        return *this;
+    }
+
+    fleet_config set_logging_handler(logging_handler_t handler) {
+        this->logging_handler = handler;
+        return *this;
+    }
+
+    fleet_config set_frame_pool(std::shared_ptr<frame_pool> frames) {
+        this->frames = frames;
+        return *this;
+    }
+};
+
+} // namespace modbus
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+namespace modbus {
+
+/**
+ * @brief An unbounded lock-free queue that any number of threads push to and
+ * one thread pops from.
+ *
+ * @section Pushing takes one atomic exchange and never waits for other
+ * threads. Popping does not wait either: while a push is between its exchange
+ * and linking its node, pop returns std::nullopt even though idle() is false,
+ * and the consumer should try again later.
+ *
+ * @tparam T The type of the values. It must be default constructible.
+ */
+template <typename T> class mpsc_queue {
+  public:
+    mpsc_queue()
+        : stub_()
+        , head_(&stub_)
+        , tail_(&stub_) {}
+
+    mpsc_queue(const mpsc_queue&) = delete;
+    mpsc_queue& operator=(const mpsc_queue&) = delete;
+
+    /**
+     * @brief Destroys the values that were never popped. No thread may push
+     * concurrently.
+     */
+    ~mpsc_queue() {
+        while (pop()) {
+        }
+    }
+
+    /**
+     * @brief Adds a value to the back of the queue. May be called from any
+     * thread.
+     */
+    void push(T value) { push(new node(std::move(value))); }
+
+    /**
+     * @brief Removes the value at the front of the queue. May only be called
+     * from one thread at a time.
+     * @return The value, or std::nullopt if the queue is empty or the next
+     * value is still being pushed.
+     */
+    std::optional<T> pop() {
+        node* tail = tail_;
+        node* next = tail->next.load(std::memory_order_acquire);
+        if (tail == &stub_) {
+            if (next == nullptr) {
+                return std::nullopt;
+            }
+            tail_ = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next == nullptr) {
+            if (tail != head_.load(std::memory_order_acquire)) {
+                // a push has exchanged head_ but not linked its node yet
+                return std::nullopt;
+            }
+            // tail is the last node; the stub takes its place so that it can
+            // be unlinked
+            push(&stub_);
+            next = tail->next.load(std::memory_order_acquire);
+            if (next == nullptr) {
+                return std::nullopt;
+            }
+        }
+
+        tail_ = next;
+        std::optional<T> value(std::move(tail->value));
+        delete tail;
+        return value;
+    }
+
+    /**
+     * @return Whether no value is queued or being pushed. May only be called
+     * from the thread that pops.
+     */
+    bool idle() const noexcept {
+        return tail_ == &stub_ &&
+               stub_.next.load(std::memory_order_acquire) == nullptr &&
+               head_.load(std::memory_order_acquire) == &stub_;
+    }
+
+  private:
+    struct node {
+        node()
+            : next(nullptr)
+            , value() {}
+
+        explicit node(T value)
+            : next(nullptr)
+            , value(std::move(value)) {}
+
+        std::atomic<node*> next;
+        T value;
+    };
+
+    void push(node* n) noexcept {
+        n->next.store(nullptr, std::memory_order_relaxed);
+        node* previous = head_.exchange(n, std::memory_order_acq_rel);
+        previous->next.store(n, std::memory_order_release);
+    }
+
+  private:
+    /// Stands in for the last node once it has been popped.
+    node stub_;
+    /// The node pushed last. Producers exchange it.
+    std::atomic<node*> head_;
+    /// The node at the front of the queue, or the stub. Only the consumer
+    /// touches it.
+    node* tail_;
+};
+
+} // namespace modbus
@@ -0,0 +1,127 @@
+#include "modbus/client/poll_group.hpp"
+
+#include <algorithm>
+#include <array>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+
+namespace modbus {
+
+namespace {
+
+std::chrono::microseconds to_micros(poll_group::clock_type::duration d) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(d);
+}
+
+} // namespace
+
+poll_group::poll_group(timer_wheel& wheel, tcp_client& client, read_plan plan,
+                       std::chrono::milliseconds period)
+    : wheel_(wheel)
+    , client_(client)
+    , plan_(std::move(plan))
+    , period_(std::max(period, wheel.tick()))
+    , timeout_(period_)
+    , entry_([this]() { on_deadline(); })
+    , deadline_()
+    , scan_start_()
+    , running_(false)
+    , scanning_(false)
+    , pending_reads_(0)
+    , on_scan_()
+    , stats_() {}
+
+void poll_group::start() {
+    running_ = true;
+    deadline_ = clock_type::now();
+    wheel_.schedule(entry_, deadline_);
+}
+
+void poll_group::stop() noexcept {
+    running_ = false;
+    wheel_.cancel(entry_);
+}
+
+void poll_group::on_deadline() {
+    auto now = clock_type::now();
+    if (scanning_) {
+        stats_.overruns++;
+    } else {
+        auto jitter = to_micros(now - deadline_);
+        stats_.last_jitter = jitter;
+        stats_.max_jitter = std::max(stats_.max_jitter, jitter);
+        stats_.total_jitter += jitter;
+        start_scan(now);
+    }
+
+    // stay on the original grid and skip the slots that have already passed
+    deadline_ += period_;
+    while (deadline_ <= now) {
+        deadline_ += period_;
+        stats_.overruns++;
+    }
+    if (running_) {
+        wheel_.schedule(entry_, deadline_);
+    }
+}
+
+void poll_group::start_scan(clock_type::time_point now) {
+    stats_.scans++;
+    scan_start_ = now;
+    plan_.invalidate();
+
+    auto requests = plan_.requests().size();
+    if (requests == 0) {
+        finish_scan();
+        return;
+    }
+
+    scanning_ = true;
+    pending_reads_ = requests;
+    auto self = shared_from_this();
+    for (size_t i = 0; i < requests; i++) {
+        co_spawn(wheel_.get_executor(), read(self, i), asio::detached);
+    }
+}
+
+awaitable<void> poll_group::read(std::shared_ptr<poll_group> self,
+                                 size_t request) {
+    std::array<uint8_t, MAX_APU_SIZE> requestBuffer;
+    std::array<uint8_t, MAX_APU_SIZE> responseBuffer;
+
+    auto& client = self->client_;
+    size_t size = self->plan_.requests()[request].encode(
+        client.reserve_transaction_id(), requestBuffer);
+    auto frame = decode_frame(std::span<const uint8_t>(requestBuffer.data(),
+                                                       size),
+                              message_type::request);
+
+    bool stored = false;
+    if (frame) {
+        auto [response, error] = co_await client.send_request(
+            *frame, responseBuffer, self->timeout_);
+        stored = !error && self->plan_.store(request, response) ==
+                               modbus_error_code::success;
+    }
+    if (!stored) {
+        self->stats_.failed_reads++;
+    }
+
+    if (--self->pending_reads_ == 0) {
+        self->finish_scan();
+    }
+}
+
+void poll_group::finish_scan() {
+    scanning_ = false;
+    auto duration = to_micros(clock_type::now() - scan_start_);
+    stats_.last_duration = duration;
+    stats_.max_duration = std::max(stats_.max_duration, duration);
+
+    if (on_scan_ && running()) {
+        on_scan_(plan_);
+    }
+}
+
+} // namespace modbus
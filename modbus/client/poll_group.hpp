@@ -0,0 +1,174 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+
+#include <boost/asio.hpp>
+
+#include "modbus/client/tcp_client.hpp"
+#include "modbus/client/timer_wheel.hpp"
+#include "modbus/core/read_planner.hpp"
+
+namespace modbus {
+
+/**
+ * @brief The timing of the scans of a poll_group.
+ */
+struct poll_stats {
+    /// The number of scans started.
+    size_t scans = 0;
+    /// The number of scans skipped because the previous scan was still
+    /// running or the scan started too late to make its slot.
+    size_t overruns = 0;
+    /// The number of requests that failed or returned an exception.
+    size_t failed_reads = 0;
+    /// How late the last scan started.
+    std::chrono::microseconds last_jitter{0};
+    /// The largest start delay of any scan.
+    std::chrono::microseconds max_jitter{0};
+    /// The sum of the start delays of all scans.
+    std::chrono::microseconds total_jitter{0};
+    /// The time the last scan took from start to the last response.
+    std::chrono::microseconds last_duration{0};
+    /// The longest time a scan took.
+    std::chrono::microseconds max_duration{0};
+
+    /**
+     * @return How late scans start on average.
+     */
+    std::chrono::microseconds mean_jitter() const noexcept {
+        if (scans == 0) {
+            return std::chrono::microseconds(0);
+        }
+        return total_jitter / static_cast<int64_t>(scans);
+    }
+};
+
+/**
+ * @brief Reads a set of tags through a tcp_client at a fixed scan rate.
+ *
+ * @section Scans are due at start() + n * period, so the schedule keeps its
+ * phase no matter how late each scan starts or how long it takes. A scan
+ * sends every request of its read_plan at once, so a client with more than one
+ * connection or a pipeline depth above one reads them in parallel. Requests
+ * time out after one period unless set_timeout() says otherwise. If a scan is
+ * still running when the next one is due, the next one is skipped and counted
+ * as an overrun rather than queued behind it.
+ *
+ * @section Deadlines are kept on a timer_wheel that can be shared by any
+ * number of groups with different scan rates. Groups must be owned by a
+ * std::shared_ptr, because a running scan keeps its group alive. All members
+ * must be called from the executor of the wheel.
+ */
+class poll_group : public std::enable_shared_from_this<poll_group> {
+  public:
+    using clock_type = timer_wheel::clock_type;
+    /// Called with the plan after each scan. Tags whose request failed are
+    /// invalid.
+    using scan_handler_t = std::function<void(const read_plan& plan)>;
+
+    /**
+     * @brief Creates a stopped group.
+     * @param wheel The wheel that schedules the scans. It must outlive the
+     * group.
+     * @param client The client that sends the requests. It must outlive the
+     * group.
+     * @param plan The requests that read the tags of the group.
+     * @param period The time between the starts of two scans.
+     */
+    poll_group(timer_wheel& wheel, tcp_client& client, read_plan plan,
+               std::chrono::milliseconds period);
+
+    poll_group(const poll_group&) = delete;
+    poll_group& operator=(const poll_group&) = delete;
+
+    /**
+     * @brief Starts a scan now and schedules one every period from now on.
+     */
+    void start();
+
+    /**
+     * @brief Stops scheduling scans. A scan that is running completes but its
+     * handler is not called.
+     */
+    void stop() noexcept;
+
+    /**
+     * @return true if scans are scheduled.
+     */
+    bool running() const noexcept { return running_; }
+
+    /**
+     * @return true if a scan is waiting for responses.
+     */
+    bool scanning() const noexcept { return scanning_; }
+
+    /**
+     * @brief Sets the handler that is called after each scan.
+     */
+    void set_scan_handler(scan_handler_t handler) {
+        on_scan_ = std::move(handler);
+    }
+
+    /**
+     * @brief Sets the time to wait for the response to each request of a scan.
+     */
+    void set_timeout(std::chrono::milliseconds timeout) noexcept {
+        timeout_ = timeout;
+    }
+
+    /**
+     * @return The time to wait for the response to each request of a scan.
+     */
+    std::chrono::milliseconds timeout() const noexcept { return timeout_; }
+
+    /**
+     * @return The plan with the data of the last scan.
+     */
+    const read_plan& plan() const noexcept { return plan_; }
+
+    /**
+     * @return The time between the starts of two scans.
+     */
+    std::chrono::milliseconds period() const noexcept { return period_; }
+
+    /**
+     * @return The timing of the scans since the group was created.
+     */
+    const poll_stats& stats() const noexcept { return stats_; }
+
+  private:
+    /// Starts the scan that is due, or records an overrun, then schedules the
+    /// next deadline.
+    void on_deadline();
+
+    void start_scan(clock_type::time_point now);
+
+    [[nodiscard]] static awaitable<void> read(std::shared_ptr<poll_group> self,
+                                              size_t request);
+
+    void finish_scan();
+
+  private:
+    timer_wheel& wheel_;
+    tcp_client& client_;
+    read_plan plan_;
+    std::chrono::milliseconds period_;
+    std::chrono::milliseconds timeout_;
+    timer_wheel::entry entry_;
+    /// The deadline of the scan that is due next.
+    clock_type::time_point deadline_;
+    /// The time the running scan started.
+    clock_type::time_point scan_start_;
+    /// Whether scans are scheduled.
+    bool running_;
+    /// Whether a scan is running.
+    bool scanning_;
+    /// The number of requests of the running scan waiting for a response.
+    size_t pending_reads_;
+    scan_handler_t on_scan_;
+    poll_stats stats_;
+};
+
+} // namespace modbus
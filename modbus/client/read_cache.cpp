@@ -0,0 +1,190 @@
+#include "modbus/client/read_cache.hpp"
+
+#include <algorithm>
+
+#include <absl/cleanup/cleanup.h>
+#include <boost/asio/experimental/as_tuple.hpp>
+
+namespace modbus {
+
+using boost::asio::use_awaitable;
+using boost::asio::experimental::as_tuple;
+
+read_cache::read_cache(tcp_client& client, std::chrono::milliseconds max_age)
+    : client_(client)
+    , max_age_(max_age)
+    , entries_()
+    , hits_(0)
+    , misses_(0)
+    , joins_(0) {}
+
+awaitable<cpool::error>
+read_cache::read_coils(uint8_t unitId, uint16_t address, uint16_t quantity,
+                       std::span<bool> out,
+                       std::chrono::milliseconds timeout) {
+    co_return co_await read(unitId, function_code_t::read_coils, address,
+                            quantity, out, timeout);
+}
+
+awaitable<cpool::error>
+read_cache::read_discrete_inputs(uint8_t unitId, uint16_t address,
+                                 uint16_t quantity, std::span<bool> out,
+                                 std::chrono::milliseconds timeout) {
+    co_return co_await read(unitId, function_code_t::read_discrete_inputs,
+                            address, quantity, out, timeout);
+}
+
+awaitable<cpool::error>
+read_cache::read_holding_registers(uint8_t unitId, uint16_t address,
+                                   uint16_t quantity, std::span<uint16_t> out,
+                                   std::chrono::milliseconds timeout) {
+    co_return co_await read(unitId, function_code_t::read_holding_registers,
+                            address, quantity, out, timeout);
+}
+
+awaitable<cpool::error>
+read_cache::read_input_registers(uint8_t unitId, uint16_t address,
+                                 uint16_t quantity, std::span<uint16_t> out,
+                                 std::chrono::milliseconds timeout) {
+    co_return co_await read(unitId, function_code_t::read_input_registers,
+                            address, quantity, out, timeout);
+}
+
+void read_cache::clear() {
+    // reads in flight stay so that matching reads still join them
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (it->second->in_flight) {
+            it->second->values.clear();
+            ++it;
+        } else {
+            it = entries_.erase(it);
+        }
+    }
+}
+
+template <typename T>
+awaitable<cpool::error>
+read_cache::read(uint8_t unitId, function_code_t functionCode,
+                 uint16_t address, uint16_t quantity, std::span<T> out,
+                 std::chrono::milliseconds timeout) {
+    if (quantity == 0 || out.size() < quantity) {
+        co_return modbus_error_code::invalid_quantity;
+    }
+
+    auto key = make_key(unitId, functionCode, address, quantity);
+    auto& slot = entries_[key];
+    if (slot == nullptr) {
+        slot = std::make_shared<entry>();
+    }
+    // the entry may be replaced in entries_ while this read waits
+    auto current = slot;
+
+    auto deadline = to_deadline(timeout);
+
+    if (current->in_flight) {
+        joins_++;
+        ticket joined{asio::steady_timer(co_await asio::this_coro::executor,
+                                         deadline),
+                      false, false};
+        current->waiters.push_back(&joined);
+        // a joiner that was answered or promoted has already been removed
+        auto defer_remove = absl::Cleanup([&current, &joined]() {
+            auto& waiters = current->waiters;
+            auto it = std::find(waiters.begin(), waiters.end(), &joined);
+            if (it != waiters.end()) {
+                waiters.erase(it);
+            }
+        });
+        while (!joined.done && !joined.promoted) {
+            auto [ec] =
+                co_await joined.signal.async_wait(as_tuple(use_awaitable));
+            if (joined.done || joined.promoted) {
+                break;
+            }
+            if (is_cancelled(co_await asio::this_coro::cancellation_state)) {
+                co_return modbus_client_error_code::cancelled;
+            }
+            if (!ec) {
+                co_return modbus_client_error_code::read_timeout;
+            }
+        }
+        if (joined.done) {
+            if (current->error) {
+                co_return current->error;
+            }
+            std::copy(current->values.begin(), current->values.end(),
+                      out.begin());
+            co_return cpool::error();
+        }
+        // the read this one joined was cancelled, so it sends the read again
+        // for itself and the joiners that are left
+        timeout = remaining(deadline);
+    } else if (max_age_.count() > 0 && !current->values.empty() &&
+               clock_type::now() - current->received <= max_age_) {
+        hits_++;
+        std::copy(current->values.begin(), current->values.end(),
+                  out.begin());
+        co_return cpool::error();
+    } else {
+        current->in_flight = true;
+    }
+
+    misses_++;
+    // the joiners are answered however the read ends; if it is cancelled or
+    // throws, the first of them takes it over instead
+    cpool::error error(modbus_client_error_code::cancelled);
+    auto defer_answer = absl::Cleanup([&]() {
+        if (error == cpool::error(modbus_client_error_code::cancelled) &&
+            !current->waiters.empty()) {
+            auto next = current->waiters.front();
+            current->waiters.erase(current->waiters.begin());
+            next->promoted = true;
+            next->signal.cancel();
+            return;
+        }
+
+        current->in_flight = false;
+        current->error = error;
+        if (error) {
+            current->values.clear();
+        } else {
+            current->values.assign(out.begin(), out.begin() + quantity);
+            current->received = clock_type::now();
+        }
+        for (auto waiter : current->waiters) {
+            waiter->done = true;
+            waiter->signal.cancel();
+        }
+        current->waiters.clear();
+
+        // keep nothing that may not be served
+        if (error || max_age_.count() <= 0) {
+            auto it = entries_.find(key);
+            if (it != entries_.end() && it->second == current) {
+                entries_.erase(it);
+            }
+        }
+    });
+
+    if constexpr (std::is_same_v<T, bool>) {
+        if (functionCode == function_code_t::read_coils) {
+            error = co_await client_.read_coils(unitId, address, quantity, out,
+                                                timeout);
+        } else {
+            error = co_await client_.read_discrete_inputs(
+                unitId, address, quantity, out, timeout);
+        }
+    } else {
+        if (functionCode == function_code_t::read_holding_registers) {
+            error = co_await client_.read_holding_registers(
+                unitId, address, quantity, out, timeout);
+        } else {
+            error = co_await client_.read_input_registers(
+                unitId, address, quantity, out, timeout);
+        }
+    }
+
+    co_return error;
+}
+
+} // namespace modbus
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include "modbus/client/tcp_client.hpp"
+#include "modbus/core/types.hpp"
+
+namespace modbus {
+
+/**
+ * @brief Shares the reads sent through a tcp_client between callers that
+ * read the same values.
+ *
+ * @section Reads are keyed by unit ID, function code, address and quantity.
+ * A read that matches one already in flight joins it instead of sending
+ * another request, and every caller receives the same values or error. With
+ * a max_age, the values of a successful read are also kept and a matching
+ * read within max_age of the response is answered without a round trip.
+ * Errors are never cached.
+ *
+ * @section Every read is bounded by its own timeout and cancellation slot,
+ * whether it sent the request or joined one. When the read that sent a
+ * request is cancelled, the first read that joined it sends the request
+ * again and the other joiners keep waiting for that one.
+ *
+ * @section All members must be called from the executor of the client.
+ */
+class read_cache {
+  public:
+    /**
+     * @brief Creates a cache for the reads sent through client.
+     * @param client The client to send the reads through. It must outlive the
+     * cache.
+     * @param max_age How long the values of a read are served to matching
+     * reads. 0 only joins reads that are in flight.
+     */
+    explicit read_cache(
+        tcp_client& client,
+        std::chrono::milliseconds max_age = std::chrono::milliseconds(0));
+
+    read_cache(const read_cache&) = delete;
+    read_cache& operator=(const read_cache&) = delete;
+
+    /**
+     * @brief Reads coils, joining a matching read in flight or answering from
+     * the cache when possible.
+     * @see tcp_client::read_coils
+     */
+    [[nodiscard]] awaitable<cpool::error> read_coils(
+        uint8_t unitId, uint16_t address, uint16_t quantity,
+        std::span<bool> out,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Reads discrete inputs.
+     * @see read_coils
+     */
+    [[nodiscard]] awaitable<cpool::error> read_discrete_inputs(
+        uint8_t unitId, uint16_t address, uint16_t quantity,
+        std::span<bool> out,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Reads holding registers.
+     * @see read_coils
+     */
+    [[nodiscard]] awaitable<cpool::error> read_holding_registers(
+        uint8_t unitId, uint16_t address, uint16_t quantity,
+        std::span<uint16_t> out,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Reads input registers.
+     * @see read_coils
+     */
+    [[nodiscard]] awaitable<cpool::error> read_input_registers(
+        uint8_t unitId, uint16_t address, uint16_t quantity,
+        std::span<uint16_t> out,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Forgets every cached value. Reads in flight are not affected.
+     */
+    void clear();
+
+    /**
+     * @return The number of reads answered from the cache.
+     */
+    size_t hits() const noexcept { return hits_; }
+
+    /**
+     * @return The number of requests sent, including those sent again when
+     * the read that sent them was cancelled.
+     */
+    size_t misses() const noexcept { return misses_; }
+
+    /**
+     * @return The number of reads that joined a read in flight.
+     */
+    size_t joins() const noexcept { return joins_; }
+
+  private:
+    using clock_type = std::chrono::steady_clock;
+
+    /// A read that joined another one in flight.
+    struct ticket {
+        /// Cancelled when the read in flight is answered.
+        asio::steady_timer signal;
+        /// Whether the read in flight was answered.
+        bool done;
+        /// Whether the read in flight was cancelled and this read sends it
+        /// again.
+        bool promoted;
+    };
+
+    /// The latest read of one key.
+    struct entry {
+        /// Whether a request is in flight.
+        bool in_flight = false;
+        /// The reads that joined the request in flight.
+        std::vector<ticket*> waiters;
+        /// The error of the last request.
+        cpool::error error;
+        /// The values of the last successful request. Coils and inputs are
+        /// stored as 0 or 1.
+        std::vector<uint16_t> values;
+        /// When the values were received.
+        clock_type::time_point received;
+    };
+
+    static constexpr uint64_t make_key(uint8_t unitId,
+                                       function_code_t functionCode,
+                                       uint16_t address,
+                                       uint16_t quantity) noexcept {
+        return ((uint64_t)unitId << 40) | ((uint64_t)functionCode << 32) |
+               ((uint64_t)address << 16) | quantity;
+    }
+
+    /**
+     * @brief Answers a read from the cache, by joining a read in flight or by
+     * sending it through the client.
+     */
+    template <typename T>
+    [[nodiscard]] awaitable<cpool::error>
+    read(uint8_t unitId, function_code_t functionCode, uint16_t address,
+         uint16_t quantity, std::span<T> out,
+         std::chrono::milliseconds timeout);
+
+  private:
+    /// The client to send the reads through.
+    tcp_client& client_;
+    /// How long values are served from the cache.
+    std::chrono::milliseconds max_age_;
+    /// The reads in flight and the cached values.
+    std::unordered_map<uint64_t, std::shared_ptr<entry>> entries_;
+    size_t hits_;
+    size_t misses_;
+    size_t joins_;
+};
+
+} // namespace modbus
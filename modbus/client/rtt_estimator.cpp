@@ -0,0 +1,64 @@
+#include "modbus/client/rtt_estimator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace modbus {
+
+namespace {
+
+/// The granularity term of the timeout.
+constexpr std::chrono::microseconds CLOCK_GRANULARITY(1000);
+
+} // namespace
+
+rtt_estimator::rtt_estimator(std::chrono::milliseconds initial,
+                             std::chrono::milliseconds min,
+                             std::chrono::milliseconds max)
+    : min_(min)
+    , max_(std::max(min, max))
+    , rto_(std::clamp(initial, min_, max_))
+    , srtt_(0)
+    , rttvar_(0)
+    , samples_(0)
+    , history_() {}
+
+void rtt_estimator::add_sample(duration rtt) {
+    if (samples_ == 0) {
+        srtt_ = rtt;
+        rttvar_ = rtt / 2;
+    } else {
+        auto error = srtt_ > rtt ? srtt_ - rtt : rtt - srtt_;
+        rttvar_ = (rttvar_ * 3 + error) / 4;
+        srtt_ = (srtt_ * 7 + rtt) / 8;
+    }
+
+    history_[samples_ % history_.size()] = rtt;
+    samples_++;
+    update_timeout();
+}
+
+void rtt_estimator::backoff() { rto_ = std::min(rto_ * 2, max_); }
+
+rtt_estimator::duration rtt_estimator::percentile(double p) const {
+    size_t count = std::min(samples_, history_.size());
+    if (count == 0) {
+        return duration(0);
+    }
+
+    auto sorted = history_;
+    auto end = sorted.begin() + count;
+    size_t rank = static_cast<size_t>(
+        std::ceil(std::clamp(p, 0.0, 1.0) * static_cast<double>(count)));
+    auto nth = sorted.begin() + std::max<size_t>(rank, 1) - 1;
+    std::nth_element(sorted.begin(), nth, end);
+    return *nth;
+}
+
+void rtt_estimator::update_timeout() noexcept {
+    auto rto = srtt_ + std::max(CLOCK_GRANULARITY, rttvar_ * 4);
+    rto_ = std::clamp(std::chrono::ceil<std::chrono::milliseconds>(rto), min_,
+                      max_);
+}
+
+} // namespace modbus
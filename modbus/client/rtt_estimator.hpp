@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+namespace modbus {
+
+/// The timeout used before the first round trip time is measured.
+constexpr std::chrono::milliseconds DEFAULT_INITIAL_RTO(1000);
+/// The shortest timeout an rtt_estimator derives.
+constexpr std::chrono::milliseconds DEFAULT_MIN_RTO(10);
+/// The longest timeout an rtt_estimator derives, including backoff.
+constexpr std::chrono::milliseconds DEFAULT_MAX_RTO(10000);
+/// The number of recent round trip times kept for percentiles.
+constexpr size_t RTT_HISTORY_SIZE = 32;
+
+/**
+ * @brief Estimates the round trip time to a device and derives a request
+ * timeout from it.
+ *
+ * @section The smoothed round trip time, its variance and the timeout follow
+ * the retransmission timer of TCP (RFC 6298):
+ * timeout = srtt + max(1ms, 4 * rttvar), clamped to [min, max]. Each timeout
+ * doubles the timeout until the next sample is added. The minimum is lower
+ * than the 1 s of TCP because MODBUS devices usually sit on a local network.
+ *
+ * @section The last RTT_HISTORY_SIZE samples are also kept, so that a request
+ * can be hedged once it has taken longer than most recent requests.
+ */
+class rtt_estimator {
+  public:
+    using duration = std::chrono::microseconds;
+
+    /**
+     * @param initial The timeout before the first sample.
+     * @param min The shortest timeout.
+     * @param max The longest timeout.
+     */
+    explicit rtt_estimator(
+        std::chrono::milliseconds initial = DEFAULT_INITIAL_RTO,
+        std::chrono::milliseconds min = DEFAULT_MIN_RTO,
+        std::chrono::milliseconds max = DEFAULT_MAX_RTO);
+
+    /**
+     * @brief Adds the round trip time of a request that was answered on its
+     * first attempt. Retried requests must not be sampled because their
+     * response cannot be matched to an attempt.
+     */
+    void add_sample(duration rtt);
+
+    /**
+     * @brief Doubles the timeout after a request timed out.
+     */
+    void backoff();
+
+    /**
+     * @return The timeout to use for the next request.
+     */
+    std::chrono::milliseconds timeout() const noexcept { return rto_; }
+
+    /**
+     * @return The smoothed round trip time.
+     */
+    duration srtt() const noexcept { return srtt_; }
+
+    /**
+     * @return The smoothed mean deviation of the round trip time.
+     */
+    duration rttvar() const noexcept { return rttvar_; }
+
+    /**
+     * @return The number of samples added.
+     */
+    size_t samples() const noexcept { return samples_; }
+
+    /**
+     * @param p The percentile between 0 and 1.
+     * @return The round trip time that p of the recent samples are at or
+     * below, or 0 if there are no samples.
+     */
+    duration percentile(double p) const;
+
+  private:
+    void update_timeout() noexcept;
+
+  private:
+    std::chrono::milliseconds min_;
+    std::chrono::milliseconds max_;
+    std::chrono::milliseconds rto_;
+    duration srtt_;
+    duration rttvar_;
+    size_t samples_;
+    /// The recent samples, oldest overwritten first.
+    std::array<duration, RTT_HISTORY_SIZE> history_;
+};
+
+} // namespace modbus
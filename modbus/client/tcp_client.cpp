@@ -1,28 +1,154 @@
 #include "modbus/client/tcp_client.hpp"
 
+#include <algorithm>
+#include <array>
+
 #include <absl/cleanup/cleanup.h>
+#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/cancellation_signal.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+
+#include "modbus/core/requests.hpp"
+#include "modbus/core/tcp_framer.hpp"
+#include "modbus/core/views.hpp"
 
 namespace modbus {
 
+namespace {
+
+using clock_type = tcp_pipeline::clock_type;
+
+/// The number of round trips measured before reads are hedged.
+constexpr size_t MIN_HEDGE_SAMPLES = 8;
+
+#if defined(TCP_KEEPIDLE)
+using keep_alive_idle =
+    asio::detail::socket_option::integer<IPPROTO_TCP, TCP_KEEPIDLE>;
+using keep_alive_interval =
+    asio::detail::socket_option::integer<IPPROTO_TCP, TCP_KEEPINTVL>;
+using keep_alive_count =
+    asio::detail::socket_option::integer<IPPROTO_TCP, TCP_KEEPCNT>;
+#endif
+
+/// Reads can be sent again without side effects.
+bool is_idempotent(function_code_t functionCode) {
+    switch (functionCode) {
+    case function_code_t::read_coils:
+    case function_code_t::read_discrete_inputs:
+    case function_code_t::read_holding_registers:
+    case function_code_t::read_input_registers:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/// Removes a waiter from waiters when the scope it waits in ends, unless it
+/// was woken and removed already.
+auto remove_waiter(std::deque<asio::steady_timer*>& waiters,
+                   asio::steady_timer* waiter) {
+    return absl::Cleanup([&waiters, waiter]() {
+        auto it = std::find(waiters.begin(), waiters.end(), waiter);
+        if (it != waiters.end()) {
+            waiters.erase(it);
+        }
+    });
+}
+
+} // namespace
+
+struct tcp_client::hedge_state {
+    hedge_state(cpool::net::any_io_executor exec,
+                std::span<const uint8_t> frame)
+        : request(frame.begin(), frame.end())
+        , buffers()
+        , results()
+        , done{false, false}
+        , winner(-1)
+        , signal(exec)
+        , cancellations() {}
+
+    /// A copy of the request, which may outlive the caller.
+    buffer_t request;
+    /// The response buffer of each attempt.
+    std::array<std::array<uint8_t, MAX_APU_SIZE>, 2> buffers;
+    std::array<read_response_view_t, 2> results;
+    std::array<bool, 2> done;
+    /// The attempt that was answered first, or -1.
+    int winner;
+    /// Cancelled when an attempt completes, or expires when it is time to
+    /// hedge.
+    asio::steady_timer signal;
+    /// Cancels each attempt if the caller is cancelled.
+    std::array<asio::cancellation_signal, 2> cancellations;
+};
+
+struct tcp_client::range_state {
+    range_state(cpool::net::any_io_executor exec, size_t chunks)
+        : chunks(chunks)
+        , next(0)
+        , running(0)
+        , errors()
+        , done(exec, asio::steady_timer::time_point::max()) {}
+
+    /// The number of requests the range is split into.
+    size_t chunks;
+    /// The next request to send.
+    size_t next;
+    /// The number of workers that have not finished.
+    size_t running;
+    range_errors_t errors;
+    /// Cancelled when the last worker finishes.
+    asio::steady_timer done;
+};
+
 tcp_client::tcp_client(cpool::net::any_io_executor exec, client_config config)
     : exec_(exec)
     , config_(config)
     , con_pool_(nullptr)
+    , pipelines_()
+    , connecting_(0)
+    , pipeline_waiters_()
+    , warm_ups_()
     , transaction_id_(1)
+    , rtt_()
+    , random_(std::random_device()())
+    , submissions_()
+    , drain_scheduled_(false)
     , on_log_(config_.logging_handler) {
 
-    con_pool_ = std::make_unique<cpool::connection_pool<cpool::tcp_connection>>(
+    con_pool_ = std::make_shared<cpool::connection_pool<cpool::tcp_connection>>(
         exec_, std::bind(&tcp_client::connection_ctor, this),
         config_.max_connections);
+    warm_up();
 }
 
 void tcp_client::set_config(client_config config) {
     config_ = config;
     on_log_ = config.logging_handler;
 
-    con_pool_ = std::make_unique<cpool::connection_pool<cpool::tcp_connection>>(
+    // connections still opening belong to the old pool; open_pipeline hands
+    // them back to it instead of counting them in connecting_
+    for (auto& signal : warm_ups_) {
+        signal.emit(asio::cancellation_type::terminal);
+    }
+    connecting_ = 0;
+
+    // the pipelines keep the old pool alive until their readers, writers and
+    // requests are done with its connections
+    pipelines_.clear();
+    rtt_ = rtt_estimator();
+    con_pool_ = std::make_shared<cpool::connection_pool<cpool::tcp_connection>>(
         exec_, std::bind(&tcp_client::connection_ctor, this),
         config_.max_connections);
+    warm_up();
+
+    // requests and ready() waiting for the old pool check again
+    for (auto waiter : pipeline_waiters_) {
+        waiter->cancel();
+    }
+    pipeline_waiters_.clear();
 }
 
 client_config tcp_client::config() const { return config_; }
@@ -32,78 +158,678 @@ uint16_t tcp_client::reserve_transaction_id() { return transaction_id_++; }
 awaitable<read_response_t>
 tcp_client::send_request(const tcp_data_unit& request,
                          std::chrono::milliseconds timeout) {
-    on_log_(modbus::log_level::trace,
-            fmt::format("getting connection - connections {} - idle {}",
-                        con_pool_->size(), con_pool_->size_idle()));
-    auto connection = co_await con_pool_->get_connection();
-    if (connection == nullptr) {
-        co_return read_response_t(
-            tcp_data_unit(), cpool::error(modbus_client_error_code::stopped));
+    std::array<uint8_t, MAX_APU_SIZE> buffer;
+    auto [response, error] = co_await send_request(request, buffer, timeout);
+    if (error) {
+        co_return read_response_t(tcp_data_unit(), error);
     }
 
-    auto defer_release = absl::Cleanup([&]() {
-        if (connection != nullptr) {
-            connection->expires_never();
+    co_return read_response_t(tcp_data_unit(response, *config_.frames),
+                              error);
+}
 
-            con_pool_->release_connection(connection);
+void tcp_client::submit(tcp_data_unit request, response_handler_t handler,
+                        std::chrono::milliseconds timeout) {
+    submissions_.push(submission{std::move(request), timeout,
+                                 std::move(handler)});
+    schedule_drain();
+}
+
+std::future<read_response_t>
+tcp_client::submit(tcp_data_unit request, std::chrono::milliseconds timeout) {
+    auto promise = std::make_shared<std::promise<read_response_t>>();
+    auto future = promise->get_future();
+    submit(
+        std::move(request),
+        [promise](read_response_t response) {
+            promise->set_value(std::move(response));
+        },
+        timeout);
+    return future;
+}
+
+void tcp_client::schedule_drain() {
+    // one post drains every request submitted before it runs
+    if (!drain_scheduled_.exchange(true, std::memory_order_acq_rel)) {
+        asio::post(exec_, [this]() { drain_submissions(); });
+    }
+}
+
+void tcp_client::drain_submissions() {
+    drain_scheduled_.store(false, std::memory_order_release);
+    while (auto s = submissions_.pop()) {
+        co_spawn(exec_, run_submission(std::move(*s)), asio::detached);
+    }
+
+    // a producer was between queueing its request and linking it
+    if (!submissions_.idle()) {
+        schedule_drain();
+    }
+}
+
+awaitable<void> tcp_client::run_submission(submission s) {
+    auto response = co_await send_request(s.request, s.timeout);
+    s.handler(std::move(response));
+}
+
+awaitable<read_response_view_t>
+tcp_client::send_request(const tcp_data_unit& request,
+                         std::span<uint8_t> response_buffer,
+                         std::chrono::milliseconds timeout) {
+    co_return co_await send_request(request.view(), response_buffer, timeout);
+}
+
+awaitable<read_response_view_t>
+tcp_client::send_request(tcp_data_unit_view request,
+                         std::span<uint8_t> response_buffer,
+                         std::chrono::milliseconds timeout) {
+    co_return co_await send_attempts(request, response_buffer, timeout,
+                                     clock_type::time_point::max());
+}
+
+awaitable<read_response_view_t>
+tcp_client::send_request(tcp_data_unit_view request,
+                         std::span<uint8_t> response_buffer,
+                         clock_type::time_point deadline) {
+    co_return co_await send_attempts(request, response_buffer,
+                                     std::chrono::milliseconds::max(),
+                                     deadline);
+}
+
+awaitable<read_response_view_t>
+tcp_client::send_attempts(tcp_data_unit_view request,
+                          std::span<uint8_t> response_buffer,
+                          std::chrono::milliseconds timeout,
+                          clock_type::time_point deadline) {
+    bool idempotent = is_idempotent(request.function_code());
+    bool hedge = idempotent && config_.hedge_percentile > 0 &&
+                 config_.max_connections > 1;
+    size_t attempts = idempotent ? config_.read_retries + 1 : 1;
+
+    read_response_view_t result;
+    for (size_t attempt = 0; attempt < attempts; attempt++) {
+        if (attempt > 0) {
+            if (clock_type::now() >= deadline) {
+                break;
+            }
+            on_log_(log_level::debug,
+                    fmt::format("retrying request with ID {}",
+                                request.transaction_id()));
+            co_await retry_delay(attempt);
+            if (is_cancelled(co_await asio::this_coro::cancellation_state)) {
+                result = read_response_view_t(
+                    tcp_data_unit_view(),
+                    cpool::error(modbus_client_error_code::cancelled));
+                break;
+            }
         }
-    });
 
-    // clear buffer to remove responses that may have appeared after a timeout
-    auto error = co_await clear_buffer(connection);
+        auto attemptTimeout = timeout;
+        if (timeout == std::chrono::milliseconds::max() &&
+            config_.adaptive_timeout) {
+            attemptTimeout = rtt_.timeout();
+        }
+        auto attemptDeadline = std::min(to_deadline(attemptTimeout), deadline);
+
+        auto start = clock_type::now();
+        bool hedged = false;
+        if (hedge) {
+            result = co_await send_hedged(request, response_buffer,
+                                          attemptDeadline, hedged);
+        } else {
+            result =
+                co_await send_once(request, response_buffer, attemptDeadline);
+        }
+
+        const auto& error = std::get<1>(result);
+        if (!error) {
+            // a retried or hedged response cannot be matched to the attempt
+            // that caused it (Karn's algorithm)
+            if (attempt == 0 && !hedged) {
+                rtt_.add_sample(
+                    std::chrono::duration_cast<rtt_estimator::duration>(
+                        clock_type::now() - start));
+            }
+            break;
+        }
+        if (!is_timeout(error)) {
+            break;
+        }
+        rtt_.backoff();
+    }
+
+    co_return result;
+}
+
+awaitable<cpool::error>
+tcp_client::read_coils(uint8_t unitId, uint16_t address, uint16_t quantity,
+                       std::span<bool> out,
+                       std::chrono::milliseconds timeout) {
+    co_return co_await read_into<read_coils_response_view,
+                                 &read_coils_response_view::values>(
+        read_coils_request{unitId, address, quantity}, out, timeout);
+}
+
+awaitable<cpool::error> tcp_client::read_discrete_inputs(
+    uint8_t unitId, uint16_t address, uint16_t quantity, std::span<bool> out,
+    std::chrono::milliseconds timeout) {
+    co_return co_await read_into<read_discrete_inputs_response_view,
+                                 &read_discrete_inputs_response_view::inputs>(
+        read_discrete_inputs_request{unitId, address, quantity}, out,
+        timeout);
+}
+
+awaitable<cpool::error> tcp_client::read_holding_registers(
+    uint8_t unitId, uint16_t address, uint16_t quantity,
+    std::span<uint16_t> out, std::chrono::milliseconds timeout) {
+    co_return co_await read_into<
+        read_holding_registers_response_view,
+        &read_holding_registers_response_view::values>(
+        read_holding_registers_request{unitId, address, quantity}, out,
+        timeout);
+}
+
+awaitable<cpool::error> tcp_client::read_input_registers(
+    uint8_t unitId, uint16_t address, uint16_t quantity,
+    std::span<uint16_t> out, std::chrono::milliseconds timeout) {
+    co_return co_await read_into<read_input_registers_response_view,
+                                 &read_input_registers_response_view::values>(
+        read_input_registers_request{unitId, address, quantity}, out,
+        timeout);
+}
+
+awaitable<range_errors_t>
+tcp_client::read_range(uint8_t unitId, data_model_t model, uint16_t address,
+                       std::span<uint16_t> out,
+                       std::chrono::milliseconds timeout) {
+    if (model != data_model_t::holding_register &&
+        model != data_model_t::input_register) {
+        co_return range_errors_t{
+            {address, (uint16_t)std::min<size_t>(out.size(), UINT16_MAX),
+             modbus_error_code::invalid_function_code}};
+    }
+    co_return co_await read_chunks(unitId, model, address, out, timeout);
+}
+
+awaitable<range_errors_t>
+tcp_client::read_range(uint8_t unitId, data_model_t model, uint16_t address,
+                       std::span<bool> out,
+                       std::chrono::milliseconds timeout) {
+    if (model != data_model_t::coil && model != data_model_t::input_status) {
+        co_return range_errors_t{
+            {address, (uint16_t)std::min<size_t>(out.size(), UINT16_MAX),
+             modbus_error_code::invalid_function_code}};
+    }
+    co_return co_await read_chunks(unitId, model, address, out, timeout);
+}
+
+awaitable<cpool::error>
+tcp_client::write_single_coil(uint8_t unitId, uint16_t address, bool value,
+                              std::chrono::milliseconds timeout) {
+    std::array<uint8_t, MAX_APU_SIZE> frame;
+    size_t size =
+        encode(reserve_transaction_id(),
+               write_single_coil_request{unitId, address, value}, frame);
+    co_return co_await send_write(std::span(frame).first(size), timeout);
+}
+
+awaitable<cpool::error>
+tcp_client::write_single_register(uint8_t unitId, uint16_t address,
+                                  uint16_t value,
+                                  std::chrono::milliseconds timeout) {
+    std::array<uint8_t, MAX_APU_SIZE> frame;
+    size_t size =
+        encode(reserve_transaction_id(),
+               write_single_register_request{unitId, address, value}, frame);
+    co_return co_await send_write(std::span(frame).first(size), timeout);
+}
+
+awaitable<cpool::error>
+tcp_client::write_coils(uint8_t unitId, uint16_t address,
+                        std::span<const bool> values,
+                        std::chrono::milliseconds timeout) {
+    std::array<uint8_t, MAX_APU_SIZE> frame;
+    size_t size = encode_write_coils(reserve_transaction_id(), unitId,
+                                     address, values, frame);
+    if (size == 0) {
+        co_return modbus_error_code::invalid_quantity;
+    }
+    co_return co_await send_write(std::span(frame).first(size), timeout);
+}
+
+awaitable<cpool::error>
+tcp_client::write_registers(uint8_t unitId, uint16_t address,
+                            std::span<const uint16_t> values,
+                            std::chrono::milliseconds timeout) {
+    std::array<uint8_t, MAX_APU_SIZE> frame;
+    size_t size = encode_write_registers(reserve_transaction_id(), unitId,
+                                         address, values, frame);
+    if (size == 0) {
+        co_return modbus_error_code::invalid_quantity;
+    }
+    co_return co_await send_write(std::span(frame).first(size), timeout);
+}
+
+template <typename V, auto Values, typename R, typename T>
+awaitable<cpool::error>
+tcp_client::read_into(const R& request, std::span<T> out,
+                      std::chrono::milliseconds timeout) {
+    constexpr bool bits = std::is_same_v<T, bool>;
+    constexpr uint16_t maxQuantity = bits ? MAX_READ_BITS : MAX_READ_REGISTERS;
+    size_t quantity = request.length;
+    if (quantity == 0 || quantity > maxQuantity || out.size() < quantity) {
+        co_return modbus_error_code::invalid_quantity;
+    }
+
+    std::array<uint8_t, MAX_APU_SIZE> frame;
+    size_t size = encode(reserve_transaction_id(), request, frame);
+    std::array<uint8_t, MAX_APU_SIZE> buffer;
+    auto [response, error] =
+        co_await exchange(std::span(frame).first(size), buffer, timeout);
     if (error) {
-        co_return read_response_t(tcp_data_unit(), error);
+        co_return error;
+    }
+
+    // coils are packed into whole bytes
+    auto view = response.template pdu<V>();
+    size_t expected = bits ? (quantity + 7) / 8 * 8 : quantity;
+    if (!view || ((*view).*Values).size() != expected) {
+        co_return modbus_error_code::invalid_byte_count;
     }
 
-    // set timeout for response
-    if (timeout != std::chrono::milliseconds::max()) {
-        on_log_(log_level::trace,
-                fmt::format("setting read timeout of {}ms", timeout.count()));
-        connection->expires_after(timeout);
-    } else {
-        connection->expires_never();
+    ((*view).*Values).copy_to(out.first(quantity));
+    co_return cpool::error();
+}
+
+template <typename T>
+awaitable<range_errors_t>
+tcp_client::read_chunks(uint8_t unitId, data_model_t model, uint16_t address,
+                        std::span<T> out, std::chrono::milliseconds timeout) {
+    constexpr size_t chunkSize =
+        std::is_same_v<T, bool> ? MAX_READ_BITS : MAX_READ_REGISTERS;
+    if (out.empty() || address + out.size() > 0x10000) {
+        co_return range_errors_t{
+            {address, (uint16_t)std::min<size_t>(out.size(), UINT16_MAX),
+             modbus_error_code::invalid_quantity}};
+    }
+
+    // keep every connection's pipeline full but do not queue requests behind
+    // ones that cannot be sent yet
+    auto state = std::make_shared<range_state>(
+        exec_, (out.size() + chunkSize - 1) / chunkSize);
+    size_t budget = std::max<size_t>(
+        (size_t)config_.max_connections * config_.pipeline_depth, 1);
+    state->running = std::min(state->chunks, budget);
+    for (size_t i = 0; i < state->running; i++) {
+        co_spawn(exec_,
+                 range_worker(state, unitId, model, address, out, timeout),
+                 asio::detached);
+    }
+
+    while (state->running > 0) {
+        co_await state->done.async_wait(
+            asio::experimental::as_tuple(asio::use_awaitable));
+    }
+
+    std::sort(state->errors.begin(), state->errors.end(),
+              [](const auto& lhs, const auto& rhs) {
+                  return lhs.address < rhs.address;
+              });
+    co_return std::move(state->errors);
+}
+
+template <typename T>
+awaitable<void>
+tcp_client::range_worker(std::shared_ptr<range_state> state, uint8_t unitId,
+                         data_model_t model, uint16_t address,
+                         std::span<T> out, std::chrono::milliseconds timeout) {
+    constexpr size_t chunkSize =
+        std::is_same_v<T, bool> ? MAX_READ_BITS : MAX_READ_REGISTERS;
+    while (state->next < state->chunks) {
+        size_t offset = state->next++ * chunkSize;
+        auto quantity = (uint16_t)std::min(chunkSize, out.size() - offset);
+        auto chunkAddress = (uint16_t)(address + offset);
+        auto chunk = out.subspan(offset, quantity);
+
+        cpool::error error;
+        if constexpr (std::is_same_v<T, bool>) {
+            if (model == data_model_t::coil) {
+                error = co_await read_coils(unitId, chunkAddress, quantity,
+                                            chunk, timeout);
+            } else {
+                error = co_await read_discrete_inputs(unitId, chunkAddress,
+                                                      quantity, chunk, timeout);
+            }
+        } else {
+            if (model == data_model_t::holding_register) {
+                error = co_await read_holding_registers(
+                    unitId, chunkAddress, quantity, chunk, timeout);
+            } else {
+                error = co_await read_input_registers(unitId, chunkAddress,
+                                                      quantity, chunk, timeout);
+            }
+        }
+        if (error) {
+            state->errors.push_back({chunkAddress, quantity, error});
+        }
     }
 
-    auto buf = request.buffer();
+    if (--state->running == 0) {
+        state->done.cancel();
+    }
+}
 
-    on_log_(log_level::debug, fmt::format("sending request with ID {}",
-                                          request.transaction_id()));
-    error = co_await send_request(connection, *buf);
+awaitable<cpool::error>
+tcp_client::send_write(std::span<const uint8_t> frame,
+                       std::chrono::milliseconds timeout) {
+    std::array<uint8_t, MAX_APU_SIZE> buffer;
+    auto [response, error] = co_await exchange(frame, buffer, timeout);
     if (error) {
-        if (error == boost::system::error_code(cpool::net::error::timed_out)) {
-            co_return read_response_t(tcp_data_unit(),
-                                      modbus_client_error_code::write_timeout);
+        co_return error;
+    }
+
+    // the unit id, function code, address and value or quantity of the
+    // request are echoed back
+    constexpr size_t echoSize = 6;
+    auto echo = response.buffer();
+    if (echo.size() != TCP_HEADER_SIZE + echoSize ||
+        !std::equal(echo.begin() + TCP_HEADER_SIZE, echo.end(),
+                    frame.begin() + TCP_HEADER_SIZE)) {
+        co_return modbus_client_error_code::invalid_response;
+    }
+
+    co_return cpool::error();
+}
+
+awaitable<read_response_view_t>
+tcp_client::exchange(std::span<const uint8_t> frame,
+                     std::span<uint8_t> response_buffer,
+                     std::chrono::milliseconds timeout) {
+    auto request = decode_frame(frame, message_type::request);
+    if (!request) {
+        co_return read_response_view_t(tcp_data_unit_view(),
+                                       cpool::error(request.error()));
+    }
+
+    auto [response, error] =
+        co_await send_request(*request, response_buffer, timeout);
+    if (!error && response.is_exception()) {
+        error = cpool::error(response.exception_code());
+    }
+
+    co_return read_response_view_t(response, error);
+}
+
+awaitable<read_response_view_t>
+tcp_client::send_once(tcp_data_unit_view request,
+                      std::span<uint8_t> response_buffer,
+                      clock_type::time_point deadline) {
+    // every connection is read by the reader of its pipeline, which frames
+    // whole responses out of each read and drops responses that nobody is
+    // waiting for
+    auto pipeline = co_await get_pipeline();
+    if (pipeline == nullptr) {
+        co_return read_response_view_t(tcp_data_unit_view(),
+                                       co_await no_pipeline_error());
+    }
+
+    auto result =
+        co_await pipeline->send_request(request, response_buffer, deadline);
+    if (pipeline->failed()) {
+        retire_pipeline(pipeline);
+    }
+
+    co_return result;
+}
+
+awaitable<read_response_view_t>
+tcp_client::send_hedged(tcp_data_unit_view request,
+                        std::span<uint8_t> response_buffer,
+                        clock_type::time_point deadline, bool& hedged) {
+    auto primary = co_await get_pipeline();
+    if (primary == nullptr) {
+        co_return read_response_view_t(tcp_data_unit_view(),
+                                       co_await no_pipeline_error());
+    }
+
+    // each attempt reads into its own buffer because the loser may still be
+    // answered after the caller has moved on
+    auto state = std::make_shared<hedge_state>(exec_, request.buffer());
+    co_spawn(exec_, hedge_attempt(state, 0, primary, deadline),
+             asio::bind_cancellation_slot(state->cancellations[0].slot(),
+                                          asio::detached));
+
+    auto hedgeAt = clock_type::time_point::max();
+    if (rtt_.samples() >= MIN_HEDGE_SAMPLES) {
+        hedgeAt = clock_type::now() + rtt_.percentile(config_.hedge_percentile);
+    }
+    state->signal.expires_at(std::min(hedgeAt, deadline));
+
+    hedged = false;
+    auto finished = [&]() {
+        return state->winner >= 0 ||
+               (state->done[0] && (!hedged || state->done[1]));
+    };
+    while (!finished()) {
+        co_await state->signal.async_wait(
+            asio::experimental::as_tuple(asio::use_awaitable));
+        if (!finished() &&
+            is_cancelled(co_await asio::this_coro::cancellation_state)) {
+            // the attempts run detached, so they are cancelled explicitly
+            for (auto& cancellation : state->cancellations) {
+                cancellation.emit(asio::cancellation_type::terminal);
+            }
+            co_return read_response_view_t(
+                tcp_data_unit_view(),
+                cpool::error(modbus_client_error_code::cancelled));
+        }
+        if (hedged || state->winner >= 0 || state->done[0] ||
+            clock_type::now() < hedgeAt) {
+            continue;
+        }
+
+        // the first attempt is slower than most; try another connection
+        state->signal.expires_at(clock_type::time_point::max());
+        auto second = co_await get_pipeline(primary.get());
+        if (second != nullptr && state->winner < 0 && !state->done[0]) {
+            on_log_(log_level::debug,
+                    fmt::format("hedging request with ID {}",
+                                request.transaction_id()));
+            hedged = true;
+            co_spawn(exec_, hedge_attempt(state, 1, second, deadline),
+                     asio::bind_cancellation_slot(
+                         state->cancellations[1].slot(), asio::detached));
         }
-        co_return read_response_t(tcp_data_unit(), error);
     }
 
-    // we've cleared the buffer but a response could have come in between
-    // clearing the buffer and reading the response from our request iterate
-    // until we've received our response or timedout
-    tcp_data_unit response;
-    do {
-        std::tie(response, error) = co_await read_response(connection);
-        if (error) {
-            break;
+    if (state->winner < 0) {
+        co_return state->results[0];
+    }
+
+    // the loser would otherwise hold its window slot until the deadline
+    state->cancellations[1 - state->winner].emit(
+        asio::cancellation_type::terminal);
+
+    auto frame = std::get<0>(state->results[state->winner]).buffer();
+    if (response_buffer.size() < frame.size()) {
+        co_return read_response_view_t(
+            tcp_data_unit_view(),
+            cpool::error(modbus_error_code::internal_error,
+                         "the response buffer is too small"));
+    }
+    std::copy(frame.begin(), frame.end(), response_buffer.begin());
+    auto response = decode_frame(response_buffer.first(frame.size()),
+                                 message_type::response);
+    co_return read_response_view_t(*response, cpool::error());
+}
+
+awaitable<void>
+tcp_client::hedge_attempt(std::shared_ptr<hedge_state> state, size_t index,
+                          std::shared_ptr<tcp_pipeline> pipeline,
+                          clock_type::time_point deadline) {
+    auto request = decode_frame(state->request, message_type::request);
+    state->results[index] = co_await pipeline->send_request(
+        *request, state->buffers[index], deadline);
+    if (pipeline->failed()) {
+        retire_pipeline(pipeline);
+    }
+
+    state->done[index] = true;
+    if (state->winner < 0 && !std::get<1>(state->results[index])) {
+        state->winner = static_cast<int>(index);
+    }
+    state->signal.cancel();
+}
+
+awaitable<cpool::error> tcp_client::no_pipeline_error() {
+    if (is_cancelled(co_await asio::this_coro::cancellation_state)) {
+        co_return modbus_client_error_code::cancelled;
+    }
+    co_return modbus_client_error_code::stopped;
+}
+
+awaitable<void> tcp_client::retry_delay(size_t retry) {
+    auto backoff =
+        config_.retry_backoff * (1 << std::min<size_t>(retry - 1, 16));
+    std::uniform_real_distribution<double> jitter(0.5, 1.5);
+    asio::steady_timer timer(
+        exec_, std::chrono::duration_cast<clock_type::duration>(
+                   backoff * jitter(random_)));
+    co_await timer.async_wait(
+        asio::experimental::as_tuple(asio::use_awaitable));
+}
+
+awaitable<std::shared_ptr<tcp_pipeline>>
+tcp_client::get_pipeline(const tcp_pipeline* exclude) {
+    while (true) {
+        // prefer the least loaded pipeline and only open another connection
+        // when every pipeline has requests in flight
+        std::shared_ptr<tcp_pipeline> least;
+        for (const auto& pipeline : pipelines_) {
+            if (!pipeline->failed() && pipeline.get() != exclude &&
+                (least == nullptr || pipeline->load() < least->load())) {
+                least = pipeline;
+            }
         }
-        on_log_(log_level::debug, fmt::format("received response with ID {}",
-                                              response.transaction_id()));
-    } while (!error && response.transaction_id() < request.transaction_id());
 
-    if (error == boost::system::error_code(cpool::net::error::timed_out)) {
-        error = cpool::error(modbus_client_error_code::read_timeout);
+        bool canConnect =
+            pipelines_.size() + connecting_ < config_.max_connections;
+        if (least != nullptr && (least->load() == 0 || !canConnect)) {
+            co_return least;
+        }
+
+        if (!canConnect) {
+            if (exclude != nullptr) {
+                co_return nullptr;
+            }
+            // wait for a pipeline that is connecting
+            asio::steady_timer connected(exec_,
+                                         asio::steady_timer::time_point::max());
+            pipeline_waiters_.push_back(&connected);
+            auto defer_remove = remove_waiter(pipeline_waiters_, &connected);
+            co_await connected.async_wait(
+                asio::experimental::as_tuple(asio::use_awaitable));
+            if (is_cancelled(co_await asio::this_coro::cancellation_state)) {
+                co_return nullptr;
+            }
+            continue;
+        }
+
+        connecting_++;
+        auto pipeline = co_await open_pipeline();
+        co_return pipeline != nullptr ? pipeline : least;
+    }
+}
+
+awaitable<std::shared_ptr<tcp_pipeline>> tcp_client::open_pipeline() {
+    // the pool must outlive the wait even if set_config replaces it
+    auto pool = con_pool_;
+    on_log_(log_level::trace,
+            fmt::format("getting connection - connections {} - idle {}",
+                        pool->size(), pool->size_idle()));
+    auto defer_connected = absl::Cleanup([this, pool]() {
+        if (pool == con_pool_) {
+            connecting_--;
+        }
+    });
+    auto connection = co_await pool->get_connection();
+    if (pool != con_pool_) {
+        if (connection != nullptr) {
+            pool->release_connection(connection);
+        }
+        co_return nullptr;
+    }
+    std::move(defer_connected).Invoke();
+
+    std::shared_ptr<tcp_pipeline> pipeline;
+    if (connection != nullptr) {
+        pipeline = std::make_shared<tcp_pipeline>(
+            exec_, connection, config_.pipeline_depth, on_log_, pool);
+        pipelines_.push_back(pipeline);
+    }
+
+    for (auto waiter : pipeline_waiters_) {
+        waiter->cancel();
     }
+    pipeline_waiters_.clear();
 
-    co_return read_response_t(response, error);
+    co_return pipeline;
+}
+
+void tcp_client::warm_up() {
+    // connect in one wave rather than one connection per request
+    size_t target =
+        std::min(config_.warm_connections, config_.max_connections);
+    while (pipelines_.size() + connecting_ < target) {
+        connecting_++;
+        auto signal = warm_ups_.emplace(warm_ups_.end());
+        co_spawn(exec_, open_pipeline(),
+                 asio::bind_cancellation_slot(
+                     signal->slot(),
+                     [this, signal](std::exception_ptr,
+                                    std::shared_ptr<tcp_pipeline>) {
+                         warm_ups_.erase(signal);
+                     }));
+    }
+}
+
+awaitable<cpool::error> tcp_client::ready() {
+    while (connecting_ > 0) {
+        asio::steady_timer connected(exec_,
+                                     asio::steady_timer::time_point::max());
+        pipeline_waiters_.push_back(&connected);
+        auto defer_remove = remove_waiter(pipeline_waiters_, &connected);
+        co_await connected.async_wait(
+            asio::experimental::as_tuple(asio::use_awaitable));
+    }
+
+    if (config_.warm_connections > 0 && pipelines_.empty()) {
+        co_return cpool::error(modbus_client_error_code::disconnected,
+                               "no connection could be opened");
+    }
+    co_return cpool::error();
+}
+
+void tcp_client::retire_pipeline(
+    const std::shared_ptr<tcp_pipeline>& pipeline) {
+    auto it = std::find(pipelines_.begin(), pipelines_.end(), pipeline);
+    if (it == pipelines_.end()) {
+        return;
+    }
+
+    // the pool reconnects the connection the next time it is checked out
+    pipelines_.erase(it);
+    con_pool_->release_connection(pipeline->connection());
+    warm_up();
 }
 
 awaitable<cpool::error>
 tcp_client::send_request(cpool::tcp_connection* connection,
-                         const buffer_t& buf) {
+                         std::span<const uint8_t> buf) {
 
     // write request
     auto [write_error, bytes_written] =
-        co_await connection->async_write(asio::buffer(buf));
+        co_await connection->async_write(asio::buffer(buf.data(), buf.size()));
     if (write_error) {
         on_log_(modbus::log_level::debug,
                 fmt::format("write_error: {}", write_error.message()));
@@ -119,45 +845,40 @@ tcp_client::send_request(cpool::tcp_connection* connection,
 
 awaitable<read_response_t>
 tcp_client::read_response(cpool::tcp_connection* connection) {
-    buffer_t readBuffer(MAX_APU_SIZE);
-    // read header of response
-    auto [read_error, bytes_read] = co_await connection->async_read(
-        asio::buffer(readBuffer, TCP_HEADER_SIZE));
-    if (read_error) {
-        co_return read_response_t(tcp_data_unit(), read_error);
-    }
-    if (bytes_read != TCP_HEADER_SIZE) {
-        co_return read_response_t(
-            tcp_data_unit(),
-            cpool::error(modbus_error_code::malformed_message));
-    }
-
-    // read the response
-    int message_length = readBuffer[4] << 8;
-    message_length += readBuffer[5];
-    if (message_length + TCP_HEADER_SIZE > MAX_APU_SIZE) {
-        co_return read_response_t(
-            tcp_data_unit(),
-            cpool::error(modbus_client_error_code::invalid_response));
-    }
+    std::array<uint8_t, MAX_APU_SIZE> buffer;
+    tcp_framer framer(buffer, message_type::response);
+
+    // read as much as is available with each read until a whole frame has
+    // arrived
+    while (true) {
+        if (auto response = framer.next()) {
+            co_return read_response_t(tcp_data_unit(*response, *config_.frames),
+                                      cpool::error());
+        }
+        if (framer.error() == modbus_error_code::invalid_length) {
+            co_return read_response_t(
+                tcp_data_unit(),
+                cpool::error(modbus_client_error_code::invalid_response));
+        }
+        if (framer.error() != modbus_error_code::success) {
+            co_return read_response_t(tcp_data_unit(),
+                                      cpool::error(framer.error()));
+        }
 
-    std::tie(read_error, bytes_read) =
-        co_await connection->async_read(asio::buffer(
-            asio::buffer(readBuffer) + TCP_HEADER_SIZE, message_length));
-    if (read_error) {
-        co_return read_response_t(tcp_data_unit(), read_error);
-    }
-    if (bytes_read != message_length) {
-        co_return read_response_t(
-            tcp_data_unit(),
-            cpool::error(modbus_client_error_code::disconnected,
-                         "failed to read the response"));
+        auto space = framer.prepare();
+        auto [read_error, bytes_read] = co_await connection->async_read_some(
+            asio::buffer(space.data(), space.size()));
+        if (read_error) {
+            co_return read_response_t(tcp_data_unit(), read_error);
+        }
+        if (bytes_read == 0) {
+            co_return read_response_t(
+                tcp_data_unit(),
+                cpool::error(modbus_client_error_code::disconnected,
+                             "failed to read the response"));
+        }
+        framer.commit(bytes_read);
     }
-
-    auto response = tcp_data_unit(readBuffer, bytes_read + TCP_HEADER_SIZE,
-                                  message_type::response);
-
-    co_return read_response_t(response, cpool::error());
 }
 
 std::error_code
@@ -178,7 +899,8 @@ tcp_client::validate_response(const tcp_data_unit& requestDataUnit,
          functionCode == function_code_t::write_single_register) &&
         !responseDataUnit.is_exception()) {
         // Data should equal the request
-        if (*(requestDataUnit.buffer()) != *(responseDataUnit.buffer())) {
+        if (!std::ranges::equal(requestDataUnit.bytes(),
+                                responseDataUnit.bytes())) {
             return modbus_client_error_code::invalid_response;
         }
     }
@@ -220,6 +942,43 @@ std::unique_ptr<cpool::tcp_connection> tcp_client::connection_ctor() {
     return conn;
 }
 
+void tcp_client::apply_socket_options(cpool::tcp_connection* conn) {
+    const auto& options = config_.sockets;
+    auto set = [&](const auto& option, const char* name) {
+        auto error = conn->set_option(option);
+        if (error) {
+            on_log_(log_level::warn,
+                    fmt::format("failed to set {0} on {1}:{2}: {3}", name,
+                                conn->host(), conn->port(), error.message()));
+        }
+    };
+
+    set(asio::ip::tcp::no_delay(options.no_delay), "TCP_NODELAY");
+    set(asio::socket_base::keep_alive(options.keep_alive), "SO_KEEPALIVE");
+#if defined(TCP_KEEPIDLE)
+    if (options.keep_alive && options.keep_alive_idle.count() > 0) {
+        set(keep_alive_idle((int)options.keep_alive_idle.count()),
+            "TCP_KEEPIDLE");
+    }
+    if (options.keep_alive && options.keep_alive_interval.count() > 0) {
+        set(keep_alive_interval((int)options.keep_alive_interval.count()),
+            "TCP_KEEPINTVL");
+    }
+    if (options.keep_alive && options.keep_alive_count > 0) {
+        set(keep_alive_count(options.keep_alive_count), "TCP_KEEPCNT");
+    }
+#endif
+    if (options.receive_buffer_size > 0) {
+        set(asio::socket_base::receive_buffer_size(
+                options.receive_buffer_size),
+            "SO_RCVBUF");
+    }
+    if (options.send_buffer_size > 0) {
+        set(asio::socket_base::send_buffer_size(options.send_buffer_size),
+            "SO_SNDBUF");
+    }
+}
+
 [[nodiscard]] awaitable<batteries::errors::error>
 tcp_client::on_connection_state_change(
     cpool::tcp_connection* conn, const cpool::client_connection_state state) {
@@ -241,6 +1000,7 @@ tcp_client::on_connection_state_change(
     case cpool::client_connection_state::connected:
         on_log_(log_level::info, fmt::format("connected to {0}:{1}",
                                              conn->host(), conn->port()));
+        apply_socket_options(conn);
         break;
 
     case cpool::client_connection_state::disconnecting:
@@ -1,14 +1,27 @@
 #pragma once
 
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <future>
+#include <list>
 #include <memory>
+#include <random>
+#include <span>
+#include <vector>
 
 #include <boost/asio.hpp>
 #include <cpool/connection_pool.hpp>
 #include <cpool/tcp_connection.hpp>
 
 #include "modbus/client/client_config.hpp"
+#include "modbus/client/mpsc_queue.hpp"
+#include "modbus/client/rtt_estimator.hpp"
+#include "modbus/client/tcp_pipeline.hpp"
+#include "modbus/core/encode.hpp"
 #include "modbus/core/error.hpp"
 #include "modbus/core/tcp_data_unit.hpp"
+#include "modbus/core/tcp_data_unit_view.hpp"
 #include "modbus/core/types.hpp"
 
 namespace modbus {
@@ -19,11 +32,32 @@ using namespace std::chrono_literals;
 using error_code = boost::system::error_code;
 using boost::asio::awaitable;
 
+/**
+ * @brief A request of a read_range that failed.
+ */
+struct range_chunk_error {
+    /// The address of the first value of the request.
+    uint16_t address;
+    /// The number of values the request read.
+    uint16_t quantity;
+    /// The reason the request failed.
+    cpool::error error;
+};
+
+/// The failed requests of a read_range, ordered by address.
+using range_errors_t = std::vector<range_chunk_error>;
+
+/// Receives the response to a request passed to tcp_client::submit.
+using response_handler_t = std::function<void(read_response_t)>;
+
 class tcp_client {
   public:
     /**
      * @brief Creates a tcp_client using properties from config.
-     * @param exec The Asio executor to use for event handling.
+     * @param exec The Asio executor to use for event handling. To share an
+     * io_context run by several threads, pass a strand of it; every member
+     * except create_request, reserve_transaction_id and submit must then be
+     * called from that strand.
      * @param config The configuration object
      */
     tcp_client(cpool::net::any_io_executor exec, client_config config);
@@ -32,7 +66,12 @@ class tcp_client {
     tcp_client& operator=(const tcp_client&) = delete;
 
     /**
-     * @brief Sets the configuration object if the client is not running.
+     * @brief Sets the configuration object and replaces the connection pool.
+     *
+     * @section Requests in flight finish over the connections they were sent
+     * on; the old pool is closed once the last of its pipelines is done.
+     * Later requests use the new pool.
+     *
      * @param config The configuration object that holds the configuration
      * details.
      */
@@ -43,6 +82,12 @@ class tcp_client {
      */
     client_config config() const;
 
+    /**
+     * @brief The round trip times measured by the client and the timeout
+     * derived from them.
+     */
+    const rtt_estimator& rtt() const noexcept { return rtt_; }
+
     /**
      * @brief Reserves a transaction ID and creates a tcp_data_unit that can be
      * sent using send_request.
@@ -52,7 +97,8 @@ class tcp_client {
      *
      */
     template <typename M> tcp_data_unit create_request(const M& request) {
-        return tcp_data_unit(reserve_transaction_id(), request);
+        return tcp_data_unit(reserve_transaction_id(), request,
+                             *config_.frames);
     }
 
     /**
@@ -61,6 +107,37 @@ class tcp_client {
      */
     uint16_t reserve_transaction_id();
 
+    /**
+     * @brief Sends a request from any thread. The request is queued without
+     * locking and sent by the executor of the client.
+     * @param request The request to send to the remote endpoint.
+     * @param handler Called on the executor of the client with the response
+     * and an error if any.
+     * @param timeout The time to wait for a response before declaring a request
+     * a failure.
+     */
+    void submit(
+        tcp_data_unit request, response_handler_t handler,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Sends a request from any thread.
+     * @see submit
+     * @return std::future<read_response_t> Becomes ready with the response and
+     * an error if any. It must not be waited on from the executor of the
+     * client.
+     */
+    [[nodiscard]] std::future<read_response_t> submit(
+        tcp_data_unit request,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Waits for the connections opened because of warm_connections.
+     * @return awaitable<cpool::error> An error if warm_connections is set and
+     * no connection could be opened.
+     */
+    [[nodiscard]] awaitable<cpool::error> ready();
+
     /**
      * @brief Instructs the interface to send a request.
      * @param request The request to send to the remote endpoint.
@@ -73,40 +150,373 @@ class tcp_client {
         const tcp_data_unit& request,
         std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
 
+    /**
+     * @brief Instructs the interface to send a request and reads the response
+     * into a buffer owned by the caller.
+     * @param request The request to send to the remote endpoint.
+     * @param response_buffer The buffer the response is read into. It should
+     * hold at least MAX_APU_SIZE bytes and must outlive the returned view.
+     * @param timeout The time to wait for a response before declaring a request
+     * a failure.
+     * @return awaitable<read_response_view_t> An awaitable tuple
+     * with a view of the response and an error if any
+     */
+    [[nodiscard]] awaitable<read_response_view_t> send_request(
+        const tcp_data_unit& request, std::span<uint8_t> response_buffer,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Sends a request that has already been encoded, for example with
+     * encode(), and reads the response into a buffer owned by the caller.
+     * Neither the request nor the response touch the heap unless the read is
+     * hedged.
+     *
+     * @section Reads that time out are sent again up to read_retries times,
+     * and may be hedged on a second connection; see client_config. Every
+     * other request is sent once.
+     *
+     * @param request A view of the encoded request.
+     * @param response_buffer The buffer the response is read into. It should
+     * hold at least MAX_APU_SIZE bytes and must outlive the returned view.
+     * @param timeout The time to wait for the response to each attempt before
+     * declaring a request a failure. With adaptive_timeout, requests sent
+     * without a timeout use the one derived from the round trip times.
+     * @return awaitable<read_response_view_t> An awaitable tuple
+     * with a view of the response and an error if any
+     */
+    [[nodiscard]] awaitable<read_response_view_t> send_request(
+        tcp_data_unit_view request, std::span<uint8_t> response_buffer,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Sends a request that has already been encoded and gives up at a
+     * fixed point in time, however many attempts that leaves.
+     *
+     * @section Like every other send_request, it honours the cancellation
+     * slot of the awaiting coroutine, for example one bound with
+     * asio::bind_cancellation_slot or the || operator of
+     * asio::experimental::awaitable_operators. A cancelled request stops
+     * waiting for its connection or its response at once and returns
+     * modbus_client_error_code::cancelled. The connection stays in its pool;
+     * its window slot goes to the next request and a late response is
+     * dropped.
+     *
+     * @param request A view of the encoded request.
+     * @param response_buffer The buffer the response is read into. It should
+     * hold at least MAX_APU_SIZE bytes and must outlive the returned view.
+     * @param deadline The time at which to stop waiting for the response and
+     * stop retrying. With adaptive_timeout, each attempt is also limited to
+     * the timeout derived from the round trip times.
+     * @return awaitable<read_response_view_t> An awaitable tuple
+     * with a view of the response and an error if any
+     */
+    [[nodiscard]] awaitable<read_response_view_t>
+    send_request(tcp_data_unit_view request, std::span<uint8_t> response_buffer,
+                 tcp_pipeline::clock_type::time_point deadline);
+
+    /**
+     * @brief Reads coils straight into memory owned by the caller.
+     *
+     * @section The typed methods encode the request on the stack and decode
+     * the response into out, so no tcp_data_unit or vector is created. A
+     * response with an exception is returned as an error whose value is its
+     * exception_code_t.
+     *
+     * @param unitId The unit ID of the device.
+     * @param address The address of the first coil.
+     * @param quantity The number of coils to read, between 1 and
+     * MAX_READ_BITS.
+     * @param out Receives the coil statuses. It must hold at least quantity
+     * values and is only written if the read succeeds.
+     * @param timeout The time to wait for a response before declaring a request
+     * a failure.
+     * @return awaitable<cpool::error> An error if the read failed.
+     */
+    [[nodiscard]] awaitable<cpool::error> read_coils(
+        uint8_t unitId, uint16_t address, uint16_t quantity,
+        std::span<bool> out,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Reads discrete inputs straight into memory owned by the caller.
+     * @see read_coils
+     */
+    [[nodiscard]] awaitable<cpool::error> read_discrete_inputs(
+        uint8_t unitId, uint16_t address, uint16_t quantity,
+        std::span<bool> out,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Reads holding registers straight into memory owned by the caller.
+     * @param quantity The number of registers to read, between 1 and
+     * MAX_READ_REGISTERS.
+     * @param out Receives the register values in host byte order.
+     * @see read_coils
+     */
+    [[nodiscard]] awaitable<cpool::error> read_holding_registers(
+        uint8_t unitId, uint16_t address, uint16_t quantity,
+        std::span<uint16_t> out,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Reads input registers straight into memory owned by the caller.
+     * @see read_holding_registers
+     */
+    [[nodiscard]] awaitable<cpool::error> read_input_registers(
+        uint8_t unitId, uint16_t address, uint16_t quantity,
+        std::span<uint16_t> out,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Reads any number of registers into memory owned by the caller.
+     *
+     * @section The range is split into requests of MAX_READ_REGISTERS which
+     * are sent concurrently, up to pipeline_depth on each of max_connections
+     * connections. Each request is retried like any other read. The values of
+     * a request that fails are left untouched in out.
+     *
+     * @param unitId The unit ID of the device.
+     * @param model Either holding_register or input_register.
+     * @param address The address of the first register.
+     * @param out Receives the register values in host byte order. Its size is
+     * the number of registers read, and address + out.size() may not exceed
+     * 65536. It must remain valid until the returned awaitable completes.
+     * @param timeout The time to wait for the response to each request before
+     * declaring it a failure.
+     * @return awaitable<range_errors_t> The requests that failed, if any.
+     */
+    [[nodiscard]] awaitable<range_errors_t> read_range(
+        uint8_t unitId, data_model_t model, uint16_t address,
+        std::span<uint16_t> out,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Reads any number of coils or discrete inputs into memory owned by
+     * the caller, MAX_READ_BITS at a time.
+     * @param model Either coil or input_status.
+     * @see read_range
+     */
+    [[nodiscard]] awaitable<range_errors_t> read_range(
+        uint8_t unitId, data_model_t model, uint16_t address,
+        std::span<bool> out,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Writes a single coil and checks that the device echoes it.
+     * @see read_coils
+     */
+    [[nodiscard]] awaitable<cpool::error> write_single_coil(
+        uint8_t unitId, uint16_t address, bool value,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Writes a single register and checks that the device echoes it.
+     * @see read_coils
+     */
+    [[nodiscard]] awaitable<cpool::error> write_single_register(
+        uint8_t unitId, uint16_t address, uint16_t value,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Writes coils from memory owned by the caller.
+     * @param values The coil statuses, between 1 and MAX_WRITE_BITS of them.
+     * @see read_coils
+     */
+    [[nodiscard]] awaitable<cpool::error> write_coils(
+        uint8_t unitId, uint16_t address, std::span<const bool> values,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Writes registers from memory owned by the caller.
+     * @param values The register values in host byte order, between 1 and
+     * MAX_WRITE_REGISTERS of them.
+     * @see read_coils
+     */
+    [[nodiscard]] awaitable<cpool::error> write_registers(
+        uint8_t unitId, uint16_t address, std::span<const uint16_t> values,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
     /**
      * @brief Sends the request.
      *
+     * @deprecated Requests are written by the pipeline of their connection.
      * @param connection The connection to use to make the request.
      * @return awaitable<cpool::error> An awaitable tuple
      * with the response and an error if any
      */
+    [[deprecated("requests are written by the pipeline of their connection")]]
     [[nodiscard]] awaitable<cpool::error>
-    send_request(cpool::tcp_connection* connection, const buffer_t& buf);
+    send_request(cpool::tcp_connection* connection,
+                 std::span<const uint8_t> buf);
 
     /**
      * @brief Reads the response.
      *
+     * @deprecated Responses are read by the pipeline of their connection.
      * @param connection The connection to use to make the request.
      * @return awaitable<read_response_t> An awaitable tuple
      * with the response and an error if any
      */
+    [[deprecated("responses are read by the pipeline of their connection")]]
     [[nodiscard]] awaitable<read_response_t>
     read_response(cpool::tcp_connection* connection);
 
     /**
      * @brief Compares a request to the response and determines if any illegal
      * conditions have occurred.
+     *
+     * @deprecated The pipeline matches responses to requests by transaction ID.
      */
+    [[deprecated("the pipeline matches responses to requests")]]
     static std::error_code
     validate_response(const tcp_data_unit& requestDataUnit,
                       const tcp_data_unit& responseDataUnit);
 
+    /**
+     * @brief Discards the bytes waiting on the connection.
+     *
+     * @deprecated The pipeline drops responses that nobody is waiting for.
+     */
+    [[deprecated("the pipeline drops responses that nobody is waiting for")]]
     [[nodiscard]] awaitable<batteries::errors::error>
     clear_buffer(cpool::tcp_connection* connection);
 
   private:
     std::unique_ptr<cpool::tcp_connection> connection_ctor();
 
+    /**
+     * @brief Sends an encoded read and copies the values of the response view
+     * V into out.
+     * @tparam Values The member of V that holds the values.
+     */
+    template <typename V, auto Values, typename R, typename T>
+    [[nodiscard]] awaitable<cpool::error>
+    read_into(const R& request, std::span<T> out,
+              std::chrono::milliseconds timeout);
+
+    /// A request passed to submit.
+    struct submission {
+        tcp_data_unit request;
+        std::chrono::milliseconds timeout;
+        response_handler_t handler;
+    };
+
+    /// Posts drain_submissions unless it is already posted.
+    void schedule_drain();
+
+    /// Starts a coroutine for every submitted request.
+    void drain_submissions();
+
+    [[nodiscard]] awaitable<void> run_submission(submission s);
+
+    /// The shared state of the requests of a read_range.
+    struct range_state;
+
+    /**
+     * @brief Splits a range into requests and waits for workers to send them.
+     */
+    template <typename T>
+    [[nodiscard]] awaitable<range_errors_t>
+    read_chunks(uint8_t unitId, data_model_t model, uint16_t address,
+                std::span<T> out, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Sends the requests of a read_range one after another until none
+     * are left.
+     */
+    template <typename T>
+    [[nodiscard]] awaitable<void>
+    range_worker(std::shared_ptr<range_state> state, uint8_t unitId,
+                 data_model_t model, uint16_t address, std::span<T> out,
+                 std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Sends an encoded write and checks that the response echoes its
+     * address and value or quantity.
+     */
+    [[nodiscard]] awaitable<cpool::error>
+    send_write(std::span<const uint8_t> frame,
+               std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Sends an encoded request and returns an exception response as an
+     * error.
+     */
+    [[nodiscard]] awaitable<read_response_view_t>
+    exchange(std::span<const uint8_t> frame,
+             std::span<uint8_t> response_buffer,
+             std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Sends a request, retrying reads that time out, until it succeeds
+     * or the deadline passes.
+     * @param timeout The timeout of each attempt, or max() for none.
+     * @param deadline The time at which to give up on every attempt.
+     */
+    [[nodiscard]] awaitable<read_response_view_t>
+    send_attempts(tcp_data_unit_view request,
+                  std::span<uint8_t> response_buffer,
+                  std::chrono::milliseconds timeout,
+                  tcp_pipeline::clock_type::time_point deadline);
+
+    /// The shared state of the two attempts of a hedged read.
+    struct hedge_state;
+
+    /**
+     * @brief Sends a request once over the least loaded pipeline.
+     */
+    [[nodiscard]] awaitable<read_response_view_t>
+    send_once(tcp_data_unit_view request, std::span<uint8_t> response_buffer,
+              tcp_pipeline::clock_type::time_point deadline);
+
+    /**
+     * @brief Sends a read and, if it is slower than hedge_percentile of the
+     * recent round trips, a copy of it over a second pipeline.
+     * @param hedged Set to whether the copy was sent.
+     */
+    [[nodiscard]] awaitable<read_response_view_t>
+    send_hedged(tcp_data_unit_view request,
+                std::span<uint8_t> response_buffer,
+                tcp_pipeline::clock_type::time_point deadline, bool& hedged);
+
+    [[nodiscard]] awaitable<void>
+    hedge_attempt(std::shared_ptr<hedge_state> state, size_t index,
+                  std::shared_ptr<tcp_pipeline> pipeline,
+                  tcp_pipeline::clock_type::time_point deadline);
+
+    /// The reason get_pipeline returned nullptr.
+    [[nodiscard]] awaitable<cpool::error> no_pipeline_error();
+
+    /// Sleeps for the jittered backoff before a retry.
+    [[nodiscard]] awaitable<void> retry_delay(size_t retry);
+
+    /**
+     * @brief Returns the least loaded pipeline, connecting a new one if every
+     * pipeline is busy and the pool has room.
+     * @param exclude A pipeline not to return. If it is the only choice
+     * nullptr is returned instead of waiting.
+     * @return The pipeline, or nullptr if none could be connected or the
+     * request was cancelled while it waited.
+     */
+    [[nodiscard]] awaitable<std::shared_ptr<tcp_pipeline>>
+    get_pipeline(const tcp_pipeline* exclude = nullptr);
+
+    /**
+     * @brief Checks a connection out of the pool and starts a pipeline over
+     * it. The caller counts the connection in connecting_ beforehand.
+     * @return The pipeline, or nullptr if the connection failed or set_config
+     * replaced the pool in the meantime.
+     */
+    [[nodiscard]] awaitable<std::shared_ptr<tcp_pipeline>> open_pipeline();
+
+    /// Opens pipelines until there are warm_connections of them.
+    void warm_up();
+
+    void retire_pipeline(const std::shared_ptr<tcp_pipeline>& pipeline);
+
+    /// Sets the socket options of the config on a connection.
+    void apply_socket_options(cpool::tcp_connection* conn);
+
     [[nodiscard]] awaitable<batteries::errors::error>
     on_connection_state_change(cpool::tcp_connection* conn,
                                const cpool::client_connection_state state);
@@ -119,11 +529,40 @@ class tcp_client {
     client_config config_;
 
     /// The connection to the server. @see cpool::tcp_connection.
-    std::unique_ptr<cpool::connection_pool<cpool::tcp_connection>> con_pool_;
+    /// Shared with the pipelines over its connections, which keep it alive
+    /// after set_config replaces it.
+    std::shared_ptr<cpool::connection_pool<cpool::tcp_connection>> con_pool_;
+
+    /// The pipelines over connections checked out of con_pool_. A connection
+    /// stays checked out for the life of its pipeline and goes back to the
+    /// pool only when the pipeline fails.
+    std::vector<std::shared_ptr<tcp_pipeline>> pipelines_;
+
+    /// The number of pipelines waiting for a connection.
+    size_t connecting_;
+
+    /// Requests waiting for a pipeline to connect.
+    std::deque<asio::steady_timer*> pipeline_waiters_;
+
+    /// Cancels the pipelines that warm_up is opening. Each is removed when
+    /// its coroutine completes.
+    std::list<asio::cancellation_signal> warm_ups_;
 
     // The transaction id for the request
     std::atomic<uint16_t> transaction_id_;
 
+    /// The round trip times to the server.
+    rtt_estimator rtt_;
+
+    /// Jitters the retry backoff.
+    std::minstd_rand random_;
+
+    /// Requests submitted from any thread.
+    mpsc_queue<submission> submissions_;
+
+    /// Whether drain_submissions is posted and has not started.
+    std::atomic_bool drain_scheduled_;
+
     // event handlers
     /// Called when there is a call to log_message. Does nothing if set to
     /// nullptr.
@@ -0,0 +1,283 @@
+#include "modbus/client/tcp_pipeline.hpp"
+
+#include <algorithm>
+
+#include <absl/cleanup/cleanup.h>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <fmt/format.h>
+
+namespace modbus {
+
+using boost::asio::use_awaitable;
+using boost::asio::experimental::as_tuple;
+
+tcp_pipeline::pending_request::pending_request(
+    cpool::net::any_io_executor exec, std::span<uint8_t> buffer,
+    clock_type::time_point deadline)
+    : buffer(buffer)
+    , response()
+    , error()
+    , done(false)
+    , signal(exec, deadline) {}
+
+tcp_pipeline::tcp_pipeline(cpool::net::any_io_executor exec,
+                           cpool::tcp_connection* connection, size_t window,
+                           logging_handler_t on_log,
+                           std::shared_ptr<void> owner)
+    : exec_(exec)
+    , owner_(owner)
+    , connection_(connection)
+    , in_flight_(window)
+    , slot_waiters_()
+    , framer_(message_type::response)
+    , outgoing_()
+    , writing_buffer_()
+    , writing_(false)
+    , reading_(false)
+    , failed_(false)
+    , logging_(is_logging(on_log))
+    , on_log_(on_log) {}
+
+awaitable<read_response_view_t>
+tcp_pipeline::send_request(tcp_data_unit_view request,
+                           std::span<uint8_t> response_buffer,
+                           clock_type::time_point deadline) {
+    // a cancellation emitted before the request started is not delivered to
+    // the waits below
+    if (is_cancelled(co_await asio::this_coro::cancellation_state)) {
+        co_return read_response_view_t(
+            tcp_data_unit_view(),
+            cpool::error(modbus_client_error_code::cancelled));
+    }
+
+    auto error = co_await wait_for_slot(deadline);
+    if (error) {
+        co_return read_response_view_t(tcp_data_unit_view(), error);
+    }
+
+    pending_request pending(exec_, response_buffer, deadline);
+    if (!in_flight_.insert(request.transaction_id(), &pending)) {
+        co_return read_response_view_t(
+            tcp_data_unit_view(),
+            cpool::error(modbus_client_error_code::invalid_response,
+                         fmt::format("transaction ID {} is already in flight",
+                                     request.transaction_id())));
+    }
+
+    // however the request ends, it leaves the table; a response that arrives
+    // later is dropped, so the slot can be used by the next request straight
+    // away
+    auto transactionId = request.transaction_id();
+    auto defer_release = absl::Cleanup([this, transactionId, &pending]() {
+        if (in_flight_.find(transactionId) == &pending) {
+            in_flight_.erase(transactionId);
+            wake_slot_waiter();
+        }
+    });
+
+    if (!reading_) {
+        reading_ = true;
+        co_spawn(exec_, read_responses(shared_from_this()), asio::detached);
+    }
+
+    if (logging_) {
+        on_log_(log_level::debug, fmt::format("sending request with ID {}",
+                                              request.transaction_id()));
+    }
+    write(request.buffer());
+
+    // the reader cancels the signal once the response arrives or the
+    // connection fails; otherwise the signal expires at the deadline, or is
+    // cancelled through the cancellation slot of the caller
+    while (!pending.done) {
+        co_await pending.signal.async_wait(as_tuple(use_awaitable));
+        if (pending.done) {
+            break;
+        }
+        if (is_cancelled(co_await asio::this_coro::cancellation_state)) {
+            co_return read_response_view_t(
+                tcp_data_unit_view(),
+                cpool::error(modbus_client_error_code::cancelled));
+        }
+        if (clock_type::now() >= deadline) {
+            co_return read_response_view_t(
+                tcp_data_unit_view(),
+                cpool::error(modbus_client_error_code::read_timeout));
+        }
+    }
+
+    co_return read_response_view_t(pending.response, pending.error);
+}
+
+awaitable<cpool::error>
+tcp_pipeline::wait_for_slot(clock_type::time_point deadline) {
+    while (!failed_ && in_flight_.full()) {
+        asio::steady_timer slot(exec_, deadline);
+        slot_waiters_.push_back(&slot);
+        // a waiter that was woken has already been removed; one that was not
+        // must not be left behind however the wait ends
+        auto defer_remove = absl::Cleanup([this, &slot]() {
+            auto it =
+                std::find(slot_waiters_.begin(), slot_waiters_.end(), &slot);
+            if (it != slot_waiters_.end()) {
+                slot_waiters_.erase(it);
+            }
+        });
+        co_await slot.async_wait(as_tuple(use_awaitable));
+
+        bool woken = std::find(slot_waiters_.begin(), slot_waiters_.end(),
+                               &slot) == slot_waiters_.end();
+        if (is_cancelled(co_await asio::this_coro::cancellation_state)) {
+            // pass the wake-up on to the next waiter
+            if (woken) {
+                wake_slot_waiter();
+            }
+            co_return modbus_client_error_code::cancelled;
+        }
+        if (!woken && clock_type::now() >= deadline) {
+            co_return modbus_client_error_code::write_timeout;
+        }
+    }
+
+    if (failed_) {
+        co_return modbus_client_error_code::disconnected;
+    }
+    co_return cpool::error();
+}
+
+void tcp_pipeline::write(std::span<const uint8_t> frame) {
+    outgoing_.insert(outgoing_.end(), frame.begin(), frame.end());
+    if (!writing_) {
+        writing_ = true;
+        co_spawn(exec_, write_frames(shared_from_this()), asio::detached);
+    }
+}
+
+awaitable<void>
+tcp_pipeline::write_frames(std::shared_ptr<tcp_pipeline> self) {
+    // frames queued while a write is in progress go out with the next write;
+    // a failed write fails every request in flight
+    while (!outgoing_.empty() && !failed_) {
+        std::swap(outgoing_, writing_buffer_);
+        outgoing_.clear();
+
+        auto [write_error, bytes_written] =
+            co_await connection_->async_write(asio::buffer(
+                writing_buffer_.data(), writing_buffer_.size()));
+        cpool::error error;
+        if (write_error) {
+            if (logging_) {
+                on_log_(log_level::debug,
+                        fmt::format("write_error: {}", write_error.message()));
+            }
+            error = write_error;
+        } else if (bytes_written != writing_buffer_.size()) {
+            error = cpool::error(
+                fmt::format("tried to write {0} bytes, wrote {1}",
+                            writing_buffer_.size(), bytes_written));
+        }
+
+        if (error) {
+            fail(error);
+        }
+    }
+    writing_ = false;
+    outgoing_.clear();
+}
+
+awaitable<void>
+tcp_pipeline::read_responses(std::shared_ptr<tcp_pipeline> self) {
+    // the reader stops once nothing is in flight; any partial frame stays in
+    // the framer for the next reader
+    while (!failed_) {
+        while (auto response = framer_.next()) {
+            complete(*response);
+        }
+        if (framer_.error() != modbus_error_code::success) {
+            fail(cpool::error(modbus_client_error_code::invalid_response));
+            break;
+        }
+        if (in_flight_.empty()) {
+            break;
+        }
+
+        auto space = framer_.prepare();
+        auto [read_error, bytes_read] = co_await connection_->async_read_some(
+            asio::buffer(space.data(), space.size()));
+        if (read_error) {
+            fail(read_error);
+            break;
+        }
+        if (bytes_read == 0) {
+            fail(cpool::error(modbus_client_error_code::disconnected,
+                              "failed to read the response"));
+            break;
+        }
+        framer_.commit(bytes_read);
+    }
+
+    reading_ = false;
+}
+
+void tcp_pipeline::complete(tcp_data_unit_view response) {
+    if (logging_) {
+        on_log_(log_level::debug, fmt::format("received response with ID {}",
+                                              response.transaction_id()));
+    }
+    auto pending = in_flight_.erase(response.transaction_id());
+    if (pending == nullptr) {
+        if (logging_) {
+            on_log_(log_level::debug,
+                    fmt::format("dropped response with ID {}; no request is "
+                                "waiting for it",
+                                response.transaction_id()));
+        }
+        return;
+    }
+
+    auto bytes = response.buffer();
+    if (bytes.size() > pending->buffer.size()) {
+        pending->error =
+            cpool::error(modbus_error_code::internal_error,
+                         "the response buffer is too small");
+    } else {
+        std::copy(bytes.begin(), bytes.end(), pending->buffer.begin());
+        pending->response = *decode_frame(
+            pending->buffer.first(bytes.size()), message_type::response);
+    }
+
+    pending->done = true;
+    pending->signal.cancel();
+    wake_slot_waiter();
+}
+
+void tcp_pipeline::fail(cpool::error error) {
+    if (logging_) {
+        on_log_(log_level::debug,
+                fmt::format("pipeline failed: {}", error.message()));
+    }
+    failed_ = true;
+    framer_.reset();
+
+    in_flight_.clear([&](pending_request* pending) {
+        pending->error = error;
+        pending->done = true;
+        pending->signal.cancel();
+    });
+
+    while (!slot_waiters_.empty()) {
+        wake_slot_waiter();
+    }
+}
+
+void tcp_pipeline::wake_slot_waiter() {
+    if (slot_waiters_.empty()) {
+        return;
+    }
+
+    slot_waiters_.front()->cancel();
+    slot_waiters_.pop_front();
+}
+
+} // namespace modbus
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <span>
+
+#include <boost/asio.hpp>
+#include <boost/asio/experimental/as_tuple.hpp>
+#include <cpool/tcp_connection.hpp>
+
+#include "modbus/client/transaction_table.hpp"
+#include "modbus/core/error.hpp"
+#include "modbus/core/tcp_data_unit_view.hpp"
+#include "modbus/core/tcp_framer.hpp"
+#include "modbus/core/types.hpp"
+
+namespace modbus {
+
+namespace asio = boost::asio;
+using boost::asio::awaitable;
+
+/**
+ * @brief Checks the state read with co_await
+ * asio::this_coro::cancellation_state. The state is read inline rather than
+ * through a coroutine, which would not run once the coroutine is cancelled.
+ * @return Whether the operation that the coroutine belongs to has been
+ * cancelled through its cancellation slot.
+ */
+inline bool is_cancelled(const asio::cancellation_state& state) noexcept {
+    return state.cancelled() != asio::cancellation_type::none;
+}
+
+/**
+ * @return The time at which a wait of timeout that starts now ends. A timeout
+ * of std::chrono::milliseconds::max() never ends.
+ */
+inline std::chrono::steady_clock::time_point
+to_deadline(std::chrono::milliseconds timeout) {
+    if (timeout == std::chrono::milliseconds::max()) {
+        return std::chrono::steady_clock::time_point::max();
+    }
+    return std::chrono::steady_clock::now() + timeout;
+}
+
+/**
+ * @return The part of a wait that ends at deadline that is still left, at
+ * least 1ms. A deadline of std::chrono::steady_clock::time_point::max() leaves
+ * std::chrono::milliseconds::max().
+ */
+inline std::chrono::milliseconds
+remaining(std::chrono::steady_clock::time_point deadline) {
+    if (deadline == std::chrono::steady_clock::time_point::max()) {
+        return std::chrono::milliseconds::max();
+    }
+    return std::max(std::chrono::ceil<std::chrono::milliseconds>(
+                        deadline - std::chrono::steady_clock::now()),
+                    std::chrono::milliseconds(1));
+}
+
+/**
+ * @return Whether a request failed because it ran out of time, either before
+ * or after it was sent.
+ */
+inline bool is_timeout(const cpool::error& error) {
+    return error == cpool::error(modbus_client_error_code::write_timeout) ||
+           error == cpool::error(modbus_client_error_code::read_timeout);
+}
+
+/**
+ * @brief Sends requests over a single connection without waiting for the
+ * responses to earlier requests.
+ *
+ * @section Up to window requests may be in flight at once. Requests that
+ * arrive while the window is full wait for a slot. Frames that are written
+ * while another write is in progress are sent together by the active writer.
+ *
+ * @section While any request is in flight a reader coroutine reads from the
+ * connection, splits the stream into frames and hands each response to the
+ * request with the same transaction ID. Responses that nobody is waiting for,
+ * such as responses to requests that timed out, are dropped. Each read takes
+ * as much as the socket holds, so a transaction usually costs one write and
+ * one read. The pipeline never gives its connection back by itself, even
+ * when it is idle.
+ *
+ * @section A request honours the cancellation slot of the coroutine that
+ * awaits it. A cancelled request gives up its window slot at once and fails
+ * with modbus_client_error_code::cancelled; its response, if one arrives, is
+ * dropped like a late one, so the connection stays usable. Frames are written
+ * by a coroutine of their own so that cancelling a request never interrupts
+ * a write half way through a frame.
+ *
+ * @section If the connection fails every request in flight fails with the
+ * same error and the pipeline stops accepting requests; failed() is then
+ * true and the connection should be returned to its pool. All members must be
+ * called from the executor of the connection.
+ */
+class tcp_pipeline : public std::enable_shared_from_this<tcp_pipeline> {
+  public:
+    using clock_type = std::chrono::steady_clock;
+
+    /**
+     * @brief Creates a pipeline over a connection.
+     * @param exec The executor that runs the reader coroutine.
+     * @param connection The connection. It must outlive the pipeline unless
+     * owner keeps it alive.
+     * @param window The maximum number of requests in flight.
+     * @param on_log The logging handler.
+     * @param owner Kept alive for as long as the pipeline, for example the
+     * pool the connection was checked out of. The reader and writer
+     * coroutines hold the pipeline, so the connection outlives them too.
+     */
+    tcp_pipeline(cpool::net::any_io_executor exec,
+                 cpool::tcp_connection* connection, size_t window,
+                 logging_handler_t on_log,
+                 std::shared_ptr<void> owner = nullptr);
+
+    tcp_pipeline(const tcp_pipeline&) = delete;
+    tcp_pipeline& operator=(const tcp_pipeline&) = delete;
+
+    /**
+     * @brief Sends a request and waits for the response with the same
+     * transaction ID.
+     * @param request A view of the encoded request.
+     * @param response_buffer The buffer the response is copied into. It should
+     * hold at least MAX_APU_SIZE bytes and must outlive the returned view.
+     * @param deadline The time at which to give up waiting for a window slot
+     * or for the response.
+     * @return awaitable<read_response_view_t> An awaitable tuple
+     * with a view of the response and an error if any
+     */
+    [[nodiscard]] awaitable<read_response_view_t>
+    send_request(tcp_data_unit_view request,
+                 std::span<uint8_t> response_buffer,
+                 clock_type::time_point deadline);
+
+    /**
+     * @return The connection the requests are sent over.
+     */
+    cpool::tcp_connection* connection() const noexcept { return connection_; }
+
+    /**
+     * @return The maximum number of requests in flight.
+     */
+    size_t window() const noexcept { return in_flight_.max_size(); }
+
+    /**
+     * @return The number of requests in flight or waiting for a window slot.
+     */
+    size_t load() const noexcept {
+        return in_flight_.size() + slot_waiters_.size();
+    }
+
+    /**
+     * @return true if the connection failed and no more requests can be sent.
+     */
+    bool failed() const noexcept { return failed_; }
+
+  private:
+    /// A request waiting for its response.
+    struct pending_request {
+        pending_request(cpool::net::any_io_executor exec,
+                        std::span<uint8_t> buffer,
+                        clock_type::time_point deadline);
+
+        /// The buffer the response is copied into.
+        std::span<uint8_t> buffer;
+        /// The response, once it has arrived.
+        tcp_data_unit_view response;
+        /// The reason the request failed.
+        cpool::error error;
+        /// Whether the response arrived or the request failed.
+        bool done;
+        /// Cancelled to wake the request, or expires at the deadline.
+        asio::steady_timer signal;
+    };
+
+    [[nodiscard]] awaitable<cpool::error>
+    wait_for_slot(clock_type::time_point deadline);
+
+    void write(std::span<const uint8_t> frame);
+
+    [[nodiscard]] awaitable<void>
+    write_frames(std::shared_ptr<tcp_pipeline> self);
+
+
+    [[nodiscard]] awaitable<void> read_responses(
+        std::shared_ptr<tcp_pipeline> self);
+
+    void complete(tcp_data_unit_view response);
+
+    void fail(cpool::error error);
+
+    void wake_slot_waiter();
+
+  private:
+    /// The executor that runs the reader coroutine.
+    cpool::net::any_io_executor exec_;
+    /// Keeps the owner of the connection alive.
+    std::shared_ptr<void> owner_;
+    /// The connection the requests are sent over.
+    cpool::tcp_connection* connection_;
+    /// The requests in flight by transaction ID.
+    transaction_table<pending_request> in_flight_;
+    /// Requests waiting for a window slot.
+    std::deque<asio::steady_timer*> slot_waiters_;
+    /// Splits the responses into frames.
+    tcp_framer framer_;
+    /// Frames waiting to be written.
+    buffer_t outgoing_;
+    /// The frames being written.
+    buffer_t writing_buffer_;
+    /// Whether a write is in progress.
+    bool writing_;
+    /// Whether the reader coroutine is running.
+    bool reading_;
+    /// Whether the connection failed.
+    bool failed_;
+    /// Whether on_log_ goes anywhere; the messages of each request are only
+    /// formatted if it does.
+    bool logging_;
+    /// The logging handler.
+    logging_handler_t on_log_;
+};
+
+} // namespace modbus
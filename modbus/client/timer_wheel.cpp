@@ -0,0 +1,178 @@
+#include "modbus/client/timer_wheel.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/experimental/as_tuple.hpp>
+
+namespace modbus {
+
+using boost::asio::use_awaitable;
+using boost::asio::experimental::as_tuple;
+
+timer_wheel::entry::entry(std::function<void()> callback)
+    : callback_(std::move(callback))
+    , wheel_(nullptr)
+    , deadline_()
+    , tick_(0)
+    , head_(nullptr)
+    , prev_(nullptr)
+    , next_(nullptr) {}
+
+timer_wheel::entry::~entry() {
+    if (wheel_ != nullptr) {
+        wheel_->cancel(*this);
+    }
+}
+
+timer_wheel::timer_wheel(cpool::net::any_io_executor exec,
+                         std::chrono::milliseconds tick, size_t slots)
+    : exec_(exec)
+    , tick_(std::max(tick, std::chrono::milliseconds(1)))
+    , epoch_(clock_type::now())
+    , slots_(std::bit_ceil(std::max<size_t>(slots, 2)), nullptr)
+    , mask_(slots_.size() - 1)
+    , current_tick_(0)
+    , due_(nullptr)
+    , size_(0)
+    , running_(false)
+    , wake_tick_(0)
+    , timer_(exec) {}
+
+timer_wheel::~timer_wheel() {
+    for (auto& head : slots_) {
+        while (head != nullptr) {
+            head->wheel_ = nullptr;
+            unlink(*head);
+        }
+    }
+    while (due_ != nullptr) {
+        due_->wheel_ = nullptr;
+        unlink(*due_);
+    }
+    timer_.cancel();
+}
+
+void timer_wheel::schedule(entry& e, clock_type::time_point deadline) {
+    if (e.scheduled()) {
+        unlink(e);
+    } else {
+        size_++;
+    }
+
+    e.wheel_ = this;
+    e.deadline_ = deadline;
+    e.tick_ = std::max(to_tick(deadline), current_tick_);
+    link(&slots_[e.tick_ & mask_], e);
+
+    if (!running_) {
+        running_ = true;
+        co_spawn(exec_, run(), asio::detached);
+    } else if (e.tick_ < wake_tick_) {
+        // wake the run coroutine early
+        timer_.cancel();
+    }
+}
+
+void timer_wheel::cancel(entry& e) noexcept {
+    if (e.wheel_ != this || !e.scheduled()) {
+        return;
+    }
+
+    unlink(e);
+    size_--;
+    if (size_ == 0) {
+        // let the run coroutine stop
+        timer_.cancel();
+    }
+}
+
+awaitable<void> timer_wheel::run() {
+    while (size_ > 0) {
+        auto now = clock_type::now();
+        uint64_t nowTick = (now - epoch_) / tick_;
+        if (nowTick >= current_tick_) {
+            expire(nowTick);
+        }
+        if (size_ == 0) {
+            break;
+        }
+
+        wake_tick_ = next_tick();
+        timer_.expires_at(epoch_ + wake_tick_ * tick_);
+        co_await timer_.async_wait(as_tuple(use_awaitable));
+    }
+
+    running_ = false;
+}
+
+uint64_t timer_wheel::to_tick(clock_type::time_point time) const noexcept {
+    if (time <= epoch_) {
+        return 0;
+    }
+    // round up so that no callback runs before its deadline
+    return (time - epoch_ + tick_ - clock_type::duration(1)) / tick_;
+}
+
+void timer_wheel::link(entry** head, entry& e) noexcept {
+    e.head_ = head;
+    e.prev_ = nullptr;
+    e.next_ = *head;
+    if (*head != nullptr) {
+        (*head)->prev_ = &e;
+    }
+    *head = &e;
+}
+
+void timer_wheel::unlink(entry& e) noexcept {
+    if (e.prev_ != nullptr) {
+        e.prev_->next_ = e.next_;
+    } else {
+        *e.head_ = e.next_;
+    }
+    if (e.next_ != nullptr) {
+        e.next_->prev_ = e.prev_;
+    }
+    e.head_ = nullptr;
+    e.prev_ = nullptr;
+    e.next_ = nullptr;
+}
+
+void timer_wheel::expire(uint64_t nowTick) {
+    // a slot may also hold entries for later rotations
+    uint64_t ticks = std::min<uint64_t>(nowTick - current_tick_ + 1,
+                                        slots_.size());
+    for (uint64_t i = 0; i < ticks; i++) {
+        entry* e = slots_[(current_tick_ + i) & mask_];
+        while (e != nullptr) {
+            entry* next = e->next_;
+            if (e->tick_ <= nowTick) {
+                unlink(*e);
+                link(&due_, *e);
+            }
+            e = next;
+        }
+    }
+    current_tick_ = nowTick + 1;
+
+    // callbacks may schedule or cancel any entry, including due ones
+    while (due_ != nullptr) {
+        entry* e = due_;
+        unlink(*e);
+        size_--;
+        e->callback_();
+    }
+}
+
+uint64_t timer_wheel::next_tick() const noexcept {
+    for (uint64_t i = 0; i < slots_.size(); i++) {
+        if (slots_[(current_tick_ + i) & mask_] != nullptr) {
+            return current_tick_ + i;
+        }
+    }
+    return current_tick_ + slots_.size();
+}
+
+} // namespace modbus
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <cpool/types.hpp>
+
+namespace modbus {
+
+namespace asio = boost::asio;
+using boost::asio::awaitable;
+
+/// The default resolution of a timer_wheel.
+constexpr std::chrono::milliseconds DEFAULT_WHEEL_TICK(1);
+/// The default number of slots of a timer_wheel.
+constexpr size_t DEFAULT_WHEEL_SLOTS = 1024;
+
+/**
+ * @brief Runs callbacks at deadlines using a single asio timer.
+ *
+ * @section Entries are hashed into a ring of slots by the tick their deadline
+ * falls in, so scheduling and cancelling take constant time no matter how many
+ * entries are on the wheel. The timer only wakes for ticks that have entries;
+ * an entry that is more than one rotation away costs one extra wakeup per
+ * rotation. Callbacks run on the executor of the wheel, at most one tick late.
+ *
+ * @section Share one wheel between everything that polls on an executor. The
+ * wheel must be destroyed after its executor has stopped, and all members
+ * must be called from that executor.
+ */
+class timer_wheel {
+  public:
+    using clock_type = std::chrono::steady_clock;
+
+    /**
+     * @brief A callback that can be put on a timer_wheel. Destroying an entry
+     * takes it off the wheel.
+     */
+    class entry {
+      public:
+        explicit entry(std::function<void()> callback);
+        ~entry();
+
+        entry(const entry&) = delete;
+        entry& operator=(const entry&) = delete;
+
+        /**
+         * @return true if the entry is waiting for its deadline.
+         */
+        bool scheduled() const noexcept { return head_ != nullptr; }
+
+        /**
+         * @return The deadline the entry was last scheduled for.
+         */
+        clock_type::time_point deadline() const noexcept { return deadline_; }
+
+      private:
+        friend class timer_wheel;
+
+        std::function<void()> callback_;
+        timer_wheel* wheel_;
+        clock_type::time_point deadline_;
+        uint64_t tick_;
+        /// The head of the list the entry is linked into.
+        entry** head_;
+        entry* prev_;
+        entry* next_;
+    };
+
+    /**
+     * @brief Creates a wheel.
+     * @param exec The executor that runs the callbacks.
+     * @param tick The resolution of the wheel.
+     * @param slots The number of ticks in one rotation. It is rounded up to a
+     * power of two.
+     */
+    explicit timer_wheel(cpool::net::any_io_executor exec,
+                         std::chrono::milliseconds tick = DEFAULT_WHEEL_TICK,
+                         size_t slots = DEFAULT_WHEEL_SLOTS);
+    ~timer_wheel();
+
+    timer_wheel(const timer_wheel&) = delete;
+    timer_wheel& operator=(const timer_wheel&) = delete;
+
+    /**
+     * @brief Puts an entry on the wheel, or moves it if it is already there.
+     * @param e The entry. Its callback runs once at deadline.
+     * @param deadline The time to run the callback. Deadlines in the past run
+     * on the next tick.
+     */
+    void schedule(entry& e, clock_type::time_point deadline);
+
+    /**
+     * @brief Takes an entry off the wheel. Does nothing if it is not on it.
+     */
+    void cancel(entry& e) noexcept;
+
+    /**
+     * @return The number of entries on the wheel.
+     */
+    size_t size() const noexcept { return size_; }
+
+    /**
+     * @return The resolution of the wheel.
+     */
+    std::chrono::milliseconds tick() const noexcept { return tick_; }
+
+    /**
+     * @return The executor that runs the callbacks.
+     */
+    cpool::net::any_io_executor get_executor() const noexcept { return exec_; }
+
+  private:
+    [[nodiscard]] awaitable<void> run();
+
+    uint64_t to_tick(clock_type::time_point time) const noexcept;
+
+    void link(entry** head, entry& e) noexcept;
+
+    void unlink(entry& e) noexcept;
+
+    /// Runs the callbacks of the entries that are due at nowTick.
+    void expire(uint64_t nowTick);
+
+    /// @return The first tick from current_tick_ that has entries.
+    uint64_t next_tick() const noexcept;
+
+  private:
+    cpool::net::any_io_executor exec_;
+    std::chrono::milliseconds tick_;
+    /// The time of tick 0.
+    clock_type::time_point epoch_;
+    /// The head of the list of entries of each slot.
+    std::vector<entry*> slots_;
+    size_t mask_;
+    /// The first tick that has not been expired.
+    uint64_t current_tick_;
+    /// The entries that are due and waiting for their callbacks to run.
+    entry* due_;
+    size_t size_;
+    /// Whether the run coroutine is running.
+    bool running_;
+    /// The tick the run coroutine is sleeping until.
+    uint64_t wake_tick_;
+    asio::steady_timer timer_;
+};
+
+} // namespace modbus
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace modbus {
+
+/**
+ * @brief Maps the transaction IDs of requests that are in flight to the
+ * objects waiting for their responses.
+ *
+ * @section Lookups match transaction IDs exactly, so IDs may wrap around from
+ * 0xFFFF to 0 while requests are in flight. The table is open addressed with
+ * a power of two number of slots and at least half of the slots are always
+ * free, so insert, find and erase take constant time. Consecutive transaction
+ * IDs fall into consecutive slots.
+ *
+ * @tparam T The type of the waiting objects. The table does not own them.
+ */
+template <typename T> class transaction_table {
+  public:
+    /**
+     * @brief Creates a table.
+     * @param max_size The maximum number of transactions in flight.
+     */
+    explicit transaction_table(size_t max_size)
+        : slots_(std::bit_ceil(2 * std::max<size_t>(max_size, 1)))
+        , mask_(slots_.size() - 1)
+        , size_(0)
+        , max_size_(std::max<size_t>(max_size, 1)) {}
+
+    /**
+     * @brief Adds a transaction.
+     * @param transactionId The transaction ID of the request.
+     * @param value The object waiting for the response. Must not be nullptr.
+     * @return false if the table is full or transactionId is already in
+     * flight.
+     */
+    bool insert(uint16_t transactionId, T* value) noexcept {
+        if (size_ == max_size_) {
+            return false;
+        }
+
+        size_t index = transactionId & mask_;
+        while (slots_[index].value != nullptr) {
+            if (slots_[index].transaction_id == transactionId) {
+                return false;
+            }
+            index = (index + 1) & mask_;
+        }
+
+        slots_[index] = slot{transactionId, value};
+        size_++;
+        return true;
+    }
+
+    /**
+     * @return The object waiting for transactionId, or nullptr if the
+     * transaction is not in flight.
+     */
+    T* find(uint16_t transactionId) const noexcept {
+        size_t index = transactionId & mask_;
+        while (slots_[index].value != nullptr) {
+            if (slots_[index].transaction_id == transactionId) {
+                return slots_[index].value;
+            }
+            index = (index + 1) & mask_;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Removes a transaction.
+     * @return The object that was waiting for transactionId, or nullptr if the
+     * transaction is not in flight.
+     */
+    T* erase(uint16_t transactionId) noexcept {
+        size_t index = transactionId & mask_;
+        while (slots_[index].value != nullptr &&
+               slots_[index].transaction_id != transactionId) {
+            index = (index + 1) & mask_;
+        }
+
+        T* value = slots_[index].value;
+        if (value == nullptr) {
+            return nullptr;
+        }
+
+        // shift the rest of the probe sequence back so that lookups never
+        // stop early at the hole
+        size_t hole = index;
+        size_t next = (hole + 1) & mask_;
+        while (slots_[next].value != nullptr) {
+            size_t home = slots_[next].transaction_id & mask_;
+            if (((next - home) & mask_) >= ((next - hole) & mask_)) {
+                slots_[hole] = slots_[next];
+                hole = next;
+            }
+            next = (next + 1) & mask_;
+        }
+        slots_[hole] = slot{};
+        size_--;
+
+        return value;
+    }
+
+    /**
+     * @brief Calls f with each object in the table and then empties it.
+     */
+    template <typename F> void clear(F&& f) {
+        for (auto& entry : slots_) {
+            if (entry.value != nullptr) {
+                T* value = entry.value;
+                entry = slot{};
+                f(value);
+            }
+        }
+        size_ = 0;
+    }
+
+    /**
+     * @return The number of transactions in flight.
+     */
+    size_t size() const noexcept { return size_; }
+
+    /**
+     * @return The maximum number of transactions in flight.
+     */
+    size_t max_size() const noexcept { return max_size_; }
+
+    bool empty() const noexcept { return size_ == 0; }
+
+    bool full() const noexcept { return size_ == max_size_; }
+
+  private:
+    struct slot {
+        uint16_t transaction_id = 0;
+        T* value = nullptr;
+    };
+
+    std::vector<slot> slots_;
+    size_t mask_;
+    size_t size_;
+    size_t max_size_;
+};
+
+} // namespace modbus
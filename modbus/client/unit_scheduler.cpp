@@ -0,0 +1,131 @@
+#include "modbus/client/unit_scheduler.hpp"
+
+#include <algorithm>
+
+#include <absl/cleanup/cleanup.h>
+#include <boost/asio/experimental/as_tuple.hpp>
+
+namespace modbus {
+
+using boost::asio::use_awaitable;
+using boost::asio::experimental::as_tuple;
+
+unit_scheduler::unit_scheduler(tcp_client& client, size_t max_per_unit,
+                               size_t max_in_flight)
+    : client_(client)
+    , max_per_unit_(std::max<size_t>(max_per_unit, 1))
+    , max_in_flight_(max_in_flight)
+    , in_flight_(0)
+    , units_()
+    , ready_() {
+    if (max_in_flight_ == 0) {
+        auto config = client_.config();
+        max_in_flight_ = std::max<size_t>(config.max_connections, 1) *
+                         std::max<size_t>(config.pipeline_depth, 1);
+    }
+}
+
+awaitable<read_response_t>
+unit_scheduler::send_request(const tcp_data_unit& request,
+                             std::chrono::milliseconds timeout) {
+    auto deadline = to_deadline(timeout);
+    auto error = co_await acquire(request.unit_id(), deadline);
+    if (error) {
+        co_return read_response_t(tcp_data_unit(), error);
+    }
+    auto defer_release =
+        absl::Cleanup([&]() { release(request.unit_id()); });
+
+    co_return co_await client_.send_request(request, remaining(deadline));
+}
+
+awaitable<read_response_view_t>
+unit_scheduler::send_request(tcp_data_unit_view request,
+                             std::span<uint8_t> response_buffer,
+                             std::chrono::milliseconds timeout) {
+    auto deadline = to_deadline(timeout);
+    auto error = co_await acquire(request.unit_id(), deadline);
+    if (error) {
+        co_return read_response_view_t(tcp_data_unit_view(), error);
+    }
+    auto defer_release =
+        absl::Cleanup([&]() { release(request.unit_id()); });
+
+    co_return co_await client_.send_request(request, response_buffer,
+                                            remaining(deadline));
+}
+
+awaitable<cpool::error>
+unit_scheduler::acquire(uint8_t unitId, clock_type::time_point deadline) {
+    ticket turn{asio::steady_timer(co_await asio::this_coro::executor,
+                                   deadline),
+                false};
+    auto& unit = units_[unitId];
+    unit.waiting.push_back(&turn);
+    // a turn that was granted has already left the queue; one that was not
+    // must not be left behind however the wait ends
+    auto defer_remove = absl::Cleanup([&unit, &turn]() {
+        auto it = std::find(unit.waiting.begin(), unit.waiting.end(), &turn);
+        if (it != unit.waiting.end()) {
+            unit.waiting.erase(it);
+        }
+    });
+    schedule(unitId);
+    dispatch();
+
+    while (!turn.granted) {
+        co_await turn.signal.async_wait(as_tuple(use_awaitable));
+        if (turn.granted) {
+            break;
+        }
+        if (is_cancelled(co_await asio::this_coro::cancellation_state)) {
+            co_return modbus_client_error_code::cancelled;
+        }
+        if (clock_type::now() >= deadline) {
+            co_return modbus_client_error_code::write_timeout;
+        }
+    }
+
+    co_return cpool::error();
+}
+
+void unit_scheduler::release(uint8_t unitId) {
+    units_[unitId].in_flight--;
+    in_flight_--;
+    schedule(unitId);
+    dispatch();
+}
+
+void unit_scheduler::schedule(uint8_t unitId) {
+    auto& unit = units_[unitId];
+    if (!unit.scheduled && !unit.waiting.empty() &&
+        unit.in_flight < max_per_unit_) {
+        unit.scheduled = true;
+        ready_.push_back(unitId);
+    }
+}
+
+void unit_scheduler::dispatch() {
+    // each unit gets one turn before it goes to the back of the ring
+    while (in_flight_ < max_in_flight_ && !ready_.empty()) {
+        uint8_t unitId = ready_.front();
+        ready_.pop_front();
+
+        auto& unit = units_[unitId];
+        unit.scheduled = false;
+        if (unit.waiting.empty() || unit.in_flight >= max_per_unit_) {
+            continue;
+        }
+
+        ticket* turn = unit.waiting.front();
+        unit.waiting.pop_front();
+        unit.in_flight++;
+        in_flight_++;
+        turn->granted = true;
+        turn->signal.cancel();
+
+        schedule(unitId);
+    }
+}
+
+} // namespace modbus
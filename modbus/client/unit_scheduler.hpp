@@ -0,0 +1,156 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <span>
+
+#include <boost/asio.hpp>
+
+#include "modbus/client/tcp_client.hpp"
+#include "modbus/core/tcp_data_unit.hpp"
+#include "modbus/core/tcp_data_unit_view.hpp"
+#include "modbus/core/types.hpp"
+
+namespace modbus {
+
+constexpr size_t DEFAULT_MAX_REQUESTS_PER_UNIT = 1;
+
+/**
+ * @brief Schedules the requests sent through a tcp_client to the units behind
+ * a gateway.
+ *
+ * @section A MODBUS TCP to serial gateway fronts many units that are
+ * addressed by unit ID. Each unit can usually answer one request at a time,
+ * while the gateway can hold several requests in flight. The scheduler keeps a
+ * queue per unit ID and limits both the requests in flight to each unit and
+ * the requests in flight to the gateway. When the gateway has room, units
+ * with queued requests take turns in round-robin order, so a slow unit only
+ * delays its own requests.
+ *
+ * @section A request that waits for its turn honours the cancellation slot of
+ * the coroutine that awaits it: it leaves the queue and fails with
+ * modbus_client_error_code::cancelled.
+ *
+ * @section All members must be called from the executor of the client.
+ */
+class unit_scheduler {
+  public:
+    /**
+     * @brief Creates a scheduler for the requests sent through client.
+     * @param client The client connected to the gateway. It must outlive the
+     * scheduler.
+     * @param max_per_unit The maximum number of requests in flight to each
+     * unit.
+     * @param max_in_flight The maximum number of requests in flight to the
+     * gateway. 0 uses the capacity of the client: max_connections times
+     * pipeline_depth.
+     */
+    explicit unit_scheduler(tcp_client& client,
+                            size_t max_per_unit = DEFAULT_MAX_REQUESTS_PER_UNIT,
+                            size_t max_in_flight = 0);
+
+    unit_scheduler(const unit_scheduler&) = delete;
+    unit_scheduler& operator=(const unit_scheduler&) = delete;
+
+    /**
+     * @brief Queues a request behind the other requests to the same unit and
+     * sends it when its turn comes.
+     * @param request The request to send to the remote endpoint.
+     * @param timeout The time to wait for a turn and a response before
+     * declaring a request a failure.
+     * @return awaitable<read_response_t> An awaitable tuple
+     * with the response and an error if any
+     */
+    [[nodiscard]] awaitable<read_response_t> send_request(
+        const tcp_data_unit& request,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Queues a request behind the other requests to the same unit and
+     * sends it when its turn comes. The response is read into a buffer owned by
+     * the caller.
+     * @param request A view of the encoded request.
+     * @param response_buffer The buffer the response is read into. It should
+     * hold at least MAX_APU_SIZE bytes and must outlive the returned view.
+     * @param timeout The time to wait for a turn and a response before
+     * declaring a request a failure.
+     * @return awaitable<read_response_view_t> An awaitable tuple
+     * with a view of the response and an error if any
+     */
+    [[nodiscard]] awaitable<read_response_view_t> send_request(
+        tcp_data_unit_view request, std::span<uint8_t> response_buffer,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @return The number of requests to unitId that are waiting for a turn.
+     */
+    size_t queued(uint8_t unitId) const noexcept {
+        return units_[unitId].waiting.size();
+    }
+
+    /**
+     * @return The number of requests in flight to unitId.
+     */
+    size_t in_flight(uint8_t unitId) const noexcept {
+        return units_[unitId].in_flight;
+    }
+
+    /**
+     * @return The number of requests in flight to the gateway.
+     */
+    size_t in_flight() const noexcept { return in_flight_; }
+
+  private:
+    using clock_type = std::chrono::steady_clock;
+
+    /// A request waiting for its turn.
+    struct ticket {
+        /// Cancelled when the turn comes, or expires at the deadline.
+        asio::steady_timer signal;
+        /// Whether the turn came.
+        bool granted;
+    };
+
+    struct unit_queue {
+        /// The requests waiting for a turn, oldest first.
+        std::deque<ticket*> waiting;
+        /// The number of requests in flight.
+        size_t in_flight = 0;
+        /// Whether the unit is in the round-robin ring.
+        bool scheduled = false;
+    };
+
+    /**
+     * @brief Waits for a turn to send a request to unitId.
+     * @return write_timeout if the deadline passed first.
+     */
+    [[nodiscard]] awaitable<cpool::error>
+    acquire(uint8_t unitId, clock_type::time_point deadline);
+
+    /**
+     * @brief Ends a turn and hands the freed capacity to the next unit.
+     */
+    void release(uint8_t unitId);
+
+    void schedule(uint8_t unitId);
+
+    void dispatch();
+
+  private:
+    /// The client connected to the gateway.
+    tcp_client& client_;
+    /// The maximum number of requests in flight to each unit.
+    size_t max_per_unit_;
+    /// The maximum number of requests in flight to the gateway.
+    size_t max_in_flight_;
+    /// The number of requests in flight to the gateway.
+    size_t in_flight_;
+    /// The queues by unit ID.
+    std::array<unit_queue, 256> units_;
+    /// Units with waiting requests and room for another, in turn order.
+    std::deque<uint8_t> ready_;
+};
+
+} // namespace modbus
@@ -0,0 +1,197 @@
+#include "modbus/client/write_queue.hpp"
+
+#include <algorithm>
+#include <array>
+
+#include <absl/cleanup/cleanup.h>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/experimental/as_tuple.hpp>
+
+namespace modbus {
+
+using boost::asio::use_awaitable;
+using boost::asio::experimental::as_tuple;
+
+write_queue::write_queue(tcp_client& client, std::chrono::milliseconds window)
+    : client_(client)
+    , window_(window)
+    , pending_(std::make_shared<batch_t>())
+    , window_open_(false)
+    , requests_sent_(0) {}
+
+awaitable<cpool::error>
+write_queue::write_register(uint8_t unitId, uint16_t address, uint16_t value,
+                            std::chrono::milliseconds timeout) {
+    co_return co_await enqueue(make_key(unitId, false, address), value,
+                               timeout);
+}
+
+awaitable<cpool::error>
+write_queue::write_coil(uint8_t unitId, uint16_t address, bool value,
+                        std::chrono::milliseconds timeout) {
+    co_return co_await enqueue(make_key(unitId, true, address), value,
+                               timeout);
+}
+
+awaitable<cpool::error>
+write_queue::write(const write_single_register_request& request,
+                   std::chrono::milliseconds timeout) {
+    co_return co_await write_register(request.unit_id, request.start_address,
+                                      request.value, timeout);
+}
+
+awaitable<cpool::error>
+write_queue::write(const write_single_coil_request& request,
+                   std::chrono::milliseconds timeout) {
+    co_return co_await write_coil(request.unit_id, request.start_address,
+                                  request.value, timeout);
+}
+
+awaitable<cpool::error>
+write_queue::enqueue(uint32_t key, uint16_t value,
+                     std::chrono::milliseconds timeout) {
+    auto exec = co_await asio::this_coro::executor;
+    ticket done{asio::steady_timer(exec, asio::steady_timer::time_point::max()),
+                value, timeout, false, cpool::error()};
+
+    // the last writer of an address wins, but every writer waits for the
+    // request that carries the value
+    auto [it, inserted] = pending_->try_emplace(
+        key, pending_write{value, timeout, std::vector<ticket*>()});
+    if (!inserted) {
+        it->second.value = value;
+        it->second.timeout = std::min(it->second.timeout, timeout);
+    }
+    it->second.waiters.push_back(&done);
+    // a writer that was answered has already been removed; one that stops
+    // waiting early is taken out of its batch
+    auto batch = pending_;
+    auto defer_remove = absl::Cleanup([this, &batch, key, &done]() {
+        if (!done.done) {
+            remove(batch, key, done);
+        }
+    });
+
+    if (!window_open_) {
+        window_open_ = true;
+        co_spawn(exec, flush(), asio::detached);
+    }
+
+    while (!done.done) {
+        co_await done.signal.async_wait(as_tuple(use_awaitable));
+        if (!done.done &&
+            is_cancelled(co_await asio::this_coro::cancellation_state)) {
+            co_return modbus_client_error_code::cancelled;
+        }
+    }
+    co_return done.error;
+}
+
+void write_queue::remove(const std::shared_ptr<batch_t>& batch, uint32_t key,
+                         ticket& writer) {
+    auto it = batch->find(key);
+    if (it == batch->end()) {
+        return;
+    }
+
+    auto& write = it->second;
+    write.waiters.erase(
+        std::remove(write.waiters.begin(), write.waiters.end(), &writer),
+        write.waiters.end());
+
+    // the writes of a closed window are already being sent
+    if (batch != pending_) {
+        return;
+    }
+
+    if (write.waiters.empty()) {
+        batch->erase(it);
+        return;
+    }
+
+    // the latest of the remaining writers wins
+    write.value = write.waiters.back()->value;
+    write.timeout = std::chrono::milliseconds::max();
+    for (auto waiter : write.waiters) {
+        write.timeout = std::min(write.timeout, waiter->timeout);
+    }
+}
+
+awaitable<void> write_queue::flush() {
+    asio::steady_timer timer(co_await asio::this_coro::executor, window_);
+    co_await timer.async_wait(as_tuple(use_awaitable));
+
+    // writes that arrive from now on open the next window
+    auto batch = std::exchange(pending_, std::make_shared<batch_t>());
+    window_open_ = false;
+
+    auto first = batch->begin();
+    while (first != batch->end()) {
+        size_t limit = (first->first & 0x10000) ? MAX_WRITE_BITS
+                                                : MAX_WRITE_REGISTERS;
+        auto last = std::next(first);
+        size_t count = 1;
+        while (last != batch->end() && count < limit &&
+               last->first == std::prev(last)->first + 1 &&
+               (std::prev(last)->first & 0xFFFF) != 0xFFFF) {
+            ++last;
+            ++count;
+        }
+
+        requests_sent_++;
+        co_spawn(timer.get_executor(), send_run(batch, first, last),
+                 asio::detached);
+        first = last;
+    }
+}
+
+awaitable<void> write_queue::send_run(std::shared_ptr<batch_t> batch,
+                                      batch_t::iterator first,
+                                      batch_t::iterator last) {
+    auto unitId = (uint8_t)(first->first >> 17);
+    bool coil = first->first & 0x10000;
+    auto address = (uint16_t)(first->first & 0xFFFF);
+    auto count = (size_t)std::distance(first, last);
+    auto timeout = std::chrono::milliseconds::max();
+    for (auto it = first; it != last; ++it) {
+        timeout = std::min(timeout, it->second.timeout);
+    }
+
+    // the writers are answered however the request ends; if it throws they
+    // are told it was cancelled
+    cpool::error error(modbus_client_error_code::cancelled);
+    auto defer_answer = absl::Cleanup([&]() {
+        for (auto it = first; it != last; ++it) {
+            for (auto waiter : it->second.waiters) {
+                waiter->done = true;
+                waiter->error = error;
+                waiter->signal.cancel();
+            }
+            it->second.waiters.clear();
+        }
+    });
+
+    if (count == 1 && coil) {
+        error = co_await client_.write_single_coil(unitId, address,
+                                                   first->second.value != 0,
+                                                   timeout);
+    } else if (count == 1) {
+        error = co_await client_.write_single_register(
+            unitId, address, first->second.value, timeout);
+    } else if (coil) {
+        std::array<bool, MAX_WRITE_BITS> values;
+        std::transform(first, last, values.begin(),
+                       [](const auto& write) { return write.second.value; });
+        error = co_await client_.write_coils(
+            unitId, address, std::span(values).first(count), timeout);
+    } else {
+        std::array<uint16_t, MAX_WRITE_REGISTERS> values;
+        std::transform(first, last, values.begin(),
+                       [](const auto& write) { return write.second.value; });
+        error = co_await client_.write_registers(
+            unitId, address, std::span(values).first(count), timeout);
+    }
+}
+
+} // namespace modbus
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include "modbus/client/tcp_client.hpp"
+#include "modbus/core/requests.hpp"
+#include "modbus/core/types.hpp"
+
+namespace modbus {
+
+constexpr std::chrono::milliseconds DEFAULT_WRITE_WINDOW(1);
+
+/**
+ * @brief Buffers single writes sent through a tcp_client and sends them as
+ * few requests as possible.
+ *
+ * @section The first write after the queue is empty opens a window. Writes
+ * that arrive before the window closes are collected: a second write to the
+ * same address replaces the first, and writes to contiguous addresses of the
+ * same unit are merged into Write Multiple Registers or Write Multiple Coils
+ * requests of up to MAX_WRITE_REGISTERS or MAX_WRITE_BITS values. A write that
+ * has no neighbour is sent as a single write. Every caller completes with the
+ * outcome of the request its write was sent in.
+ *
+ * @section A write honours the cancellation slot of the coroutine that awaits
+ * it and fails with modbus_client_error_code::cancelled. A write that is
+ * cancelled before its window closes is not sent; if others wrote the same
+ * address, the latest of their values is sent instead. Once the window has
+ * closed the write is already on its way to the device, and cancelling it
+ * only stops the wait.
+ *
+ * @section All members must be called from the executor of the client.
+ */
+class write_queue {
+  public:
+    /**
+     * @brief Creates a queue for the writes sent through client.
+     * @param client The client to send the writes through. It must outlive the
+     * queue.
+     * @param window The time writes are collected for before they are sent.
+     */
+    explicit write_queue(tcp_client& client,
+                         std::chrono::milliseconds window = DEFAULT_WRITE_WINDOW);
+
+    write_queue(const write_queue&) = delete;
+    write_queue& operator=(const write_queue&) = delete;
+
+    /**
+     * @brief Queues a register write and waits for the request it is merged
+     * into.
+     * @param unitId The unit ID of the device.
+     * @param address The address of the register.
+     * @param value The value to write.
+     * @param timeout The time to wait for the response after the window closes
+     * before declaring the write a failure. A merged request uses the
+     * shortest timeout of its writes.
+     * @return awaitable<cpool::error> An error if the request failed.
+     */
+    [[nodiscard]] awaitable<cpool::error> write_register(
+        uint8_t unitId, uint16_t address, uint16_t value,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Queues a coil write and waits for the request it is merged into.
+     * @see write_register
+     */
+    [[nodiscard]] awaitable<cpool::error> write_coil(
+        uint8_t unitId, uint16_t address, bool value,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Queues the write described by request.
+     * @see write_register
+     */
+    [[nodiscard]] awaitable<cpool::error> write(
+        const write_single_register_request& request,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Queues the write described by request.
+     * @see write_coil
+     */
+    [[nodiscard]] awaitable<cpool::error> write(
+        const write_single_coil_request& request,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @return The number of addresses waiting for the window to close.
+     */
+    size_t queued() const noexcept { return pending_->size(); }
+
+    /**
+     * @return The number of requests sent since the queue was created.
+     */
+    size_t requests_sent() const noexcept { return requests_sent_; }
+
+  private:
+    /// A caller waiting for its write to be sent.
+    struct ticket {
+        /// Cancelled when the write has been answered.
+        asio::steady_timer signal;
+        /// The value the caller wrote.
+        uint16_t value;
+        /// The timeout the caller gave.
+        std::chrono::milliseconds timeout;
+        /// Whether the write has been answered.
+        bool done;
+        cpool::error error;
+    };
+
+    /// The latest value written to an address and everyone who wrote it, in
+    /// the order they wrote it.
+    struct pending_write {
+        uint16_t value;
+        std::chrono::milliseconds timeout;
+        std::vector<ticket*> waiters;
+    };
+
+    /// The writes of a window ordered by unit ID, then registers before coils,
+    /// then address. @see make_key
+    using batch_t = std::map<uint32_t, pending_write>;
+
+    static constexpr uint32_t make_key(uint8_t unitId, bool coil,
+                                       uint16_t address) noexcept {
+        return ((uint32_t)unitId << 17) | ((uint32_t)coil << 16) | address;
+    }
+
+    [[nodiscard]] awaitable<cpool::error>
+    enqueue(uint32_t key, uint16_t value, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Takes a writer that stopped waiting out of its batch. If the
+     * window of the batch is still open and nobody else wrote the address,
+     * the write is dropped.
+     */
+    void remove(const std::shared_ptr<batch_t>& batch, uint32_t key,
+                ticket& writer);
+
+    /**
+     * @brief Waits for the window to close and sends the writes collected in
+     * it.
+     */
+    [[nodiscard]] awaitable<void> flush();
+
+    /**
+     * @brief Sends the contiguous writes [first, last) as one request and
+     * completes their callers.
+     */
+    [[nodiscard]] awaitable<void> send_run(std::shared_ptr<batch_t> batch,
+                                           batch_t::iterator first,
+                                           batch_t::iterator last);
+
+  private:
+    /// The client to send the writes through.
+    tcp_client& client_;
+    /// The time writes are collected for.
+    std::chrono::milliseconds window_;
+    /// The writes of the open window.
+    std::shared_ptr<batch_t> pending_;
+    /// Whether a window is open.
+    bool window_open_;
+    /// The number of requests sent.
+    size_t requests_sent_;
+};
+
+} // namespace modbus
@@ -0,0 +1,212 @@
+#include "modbus/core/bit_pack.hpp"
+
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define MODBUS_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace modbus {
+
+namespace {
+
+constexpr uint64_t LOW_BITS = 0x0101010101010101;
+constexpr uint64_t LOW_SEVEN_BITS = 0x7F7F7F7F7F7F7F7F;
+constexpr uint64_t HIGH_BITS = 0x8080808080808080;
+/// Byte k holds bit k.
+constexpr uint64_t BIT_SELECT = 0x8040201008040201;
+/// Moves the low bit of byte k to bit 56 + k.
+constexpr uint64_t BIT_GATHER = 0x0102040810204080;
+
+/// Loads 8 bytes so that the byte at from[k] is byte k of the result.
+uint64_t load_le(const uint8_t* from) noexcept {
+    uint64_t word;
+    std::memcpy(&word, from, sizeof(word));
+    if constexpr (std::endian::native == std::endian::big) {
+        word = __builtin_bswap64(word);
+    }
+    return word;
+}
+
+void store_le(uint64_t word, uint8_t* to) noexcept {
+    if constexpr (std::endian::native == std::endian::big) {
+        word = __builtin_bswap64(word);
+    }
+    std::memcpy(to, &word, sizeof(word));
+}
+
+/// Packs 8 bytes into one, setting bit k if byte k is not 0.
+uint8_t pack8(uint64_t bytes) noexcept {
+    uint64_t set = ((((bytes & LOW_SEVEN_BITS) + LOW_SEVEN_BITS) | bytes) &
+                    HIGH_BITS) >>
+                   7;
+    return (uint8_t)((set * BIT_GATHER) >> 56);
+}
+
+/// Spreads the bits of a byte over 8 bytes holding 0 or 1.
+uint64_t unpack8(uint8_t bits) noexcept {
+    uint64_t selected = (bits * LOW_BITS) & BIT_SELECT;
+    return ((selected + LOW_SEVEN_BITS) >> 7) & LOW_BITS;
+}
+
+/// Packs count bytes, 8 at a time, then the remaining bits one at a time.
+uint8_t* pack_swar(const uint8_t* from, size_t count, uint8_t* to) noexcept {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        *to++ = pack8(load_le(from + i));
+    }
+    if (i < count) {
+        uint8_t byte = 0;
+        for (size_t bit = 0; i < count; i++, bit++) {
+            byte |= (uint8_t)((from[i] != 0) << bit);
+        }
+        *to++ = byte;
+    }
+    return to;
+}
+
+void unpack_swar(const uint8_t* from, uint8_t* to, size_t count) noexcept {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        store_le(unpack8(*from++), to + i);
+    }
+    for (size_t bit = 0; i < count; i++, bit++) {
+        to[i] = (*from >> bit) & 0x01;
+    }
+}
+
+#if defined(MODBUS_SIMD_X86)
+
+uint8_t* pack_sse2(const uint8_t* from, size_t count, uint8_t* to) noexcept {
+    const __m128i zero = _mm_setzero_si128();
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(from + i));
+        uint16_t bits = (uint16_t)~_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero));
+        *to++ = (uint8_t)bits;
+        *to++ = (uint8_t)(bits >> 8);
+    }
+    return pack_swar(from + i, count - i, to);
+}
+
+__attribute__((target("avx2"))) uint8_t*
+pack_avx2(const uint8_t* from, size_t count, uint8_t* to) noexcept {
+    const __m256i zero = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(from + i));
+        uint32_t bits =
+            ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, zero));
+        std::memcpy(to, &bits, sizeof(bits));
+        to += sizeof(bits);
+    }
+    return pack_swar(from + i, count - i, to);
+}
+
+__attribute__((target("avx2"))) void
+unpack_avx2(const uint8_t* from, uint8_t* to, size_t count) noexcept {
+    // byte k of each lane is taken from packed byte k / 8 and tested against
+    // bit k % 8
+    const __m256i spread =
+        _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2,
+                         2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+    const __m256i select = _mm256_set1_epi64x((int64_t)BIT_SELECT);
+    const __m256i one = _mm256_set1_epi8(1);
+
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        uint32_t bits;
+        std::memcpy(&bits, from, sizeof(bits));
+        from += sizeof(bits);
+
+        // the shuffle works within 128-bit lanes so both lanes hold all 4
+        // bytes
+        __m256i v = _mm256_set1_epi32((int32_t)bits);
+        v = _mm256_shuffle_epi8(v, spread);
+        v = _mm256_cmpeq_epi8(_mm256_and_si256(v, select), select);
+        _mm256_storeu_si256((__m256i*)(to + i), _mm256_and_si256(v, one));
+    }
+    unpack_swar(from, to + i, count - i);
+}
+
+#endif
+
+struct bit_kernel {
+    uint8_t* (*pack)(const uint8_t* from, size_t count, uint8_t* to) noexcept;
+    void (*unpack)(const uint8_t* from, uint8_t* to, size_t count) noexcept;
+};
+
+bit_kernel select_kernel() noexcept {
+#if defined(MODBUS_SIMD_X86)
+    if (__builtin_cpu_supports("avx2")) {
+        return {pack_avx2, unpack_avx2};
+    }
+    return {pack_sse2, unpack_swar};
+#else
+    return {pack_swar, unpack_swar};
+#endif
+}
+
+const bit_kernel& kernel() noexcept {
+    static const bit_kernel selected = select_kernel();
+    return selected;
+}
+
+} // namespace
+
+uint8_t* pack_bits(std::span<const bool> from, uint8_t* to) noexcept {
+    static_assert(sizeof(bool) == 1);
+    return kernel().pack((const uint8_t*)from.data(), from.size(), to);
+}
+
+uint8_t* pack_bits(std::span<const uint8_t> from, uint8_t* to) noexcept {
+    return kernel().pack(from.data(), from.size(), to);
+}
+
+void unpack_bits(const uint8_t* from, std::span<bool> to) noexcept {
+    kernel().unpack(from, (uint8_t*)to.data(), to.size());
+}
+
+void unpack_bits(const uint8_t* from, std::span<uint8_t> to) noexcept {
+    kernel().unpack(from, to.data(), to.size());
+}
+
+void unpack_bits(const uint8_t* from, size_t firstBit,
+                 std::span<bool> to) noexcept {
+    from += firstBit / 8;
+    size_t offset = firstBit % 8;
+
+    // unpack the bits up to the next byte boundary one at a time
+    size_t lead = std::min(offset ? 8 - offset : 0, to.size());
+    for (size_t i = 0; i < lead; i++) {
+        to[i] = (*from >> (offset + i)) & 0x01;
+    }
+    if (offset != 0) {
+        from++;
+    }
+
+    unpack_bits(from, to.subspan(lead));
+}
+
+size_t unpack_words(std::span<const uint8_t> from,
+                    std::span<uint64_t> to) noexcept {
+    size_t numWords = std::min((from.size() + 7) / 8, to.size());
+    size_t numBytes = std::min(from.size(), numWords * 8);
+
+    std::fill(to.begin(), to.end(), 0);
+    size_t i = 0;
+    for (; i + 8 <= numBytes; i += 8) {
+        to[i / 8] = load_le(from.data() + i);
+    }
+    for (; i < numBytes; i++) {
+        to[i / 8] |= (uint64_t)from[i] << (8 * (i % 8));
+    }
+
+    return numWords;
+}
+
+} // namespace modbus
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <span>
+
+namespace modbus {
+
+/**
+ * @brief Packs coil statuses eight to a byte, least significant bit first, as
+ * they are sent in a MODBUS PDU. Unused bits of the last byte are cleared.
+ * @param from The coil statuses.
+ * @param to The destination. Must hold at least (from.size() + 7) / 8 bytes.
+ * @return A pointer one past the last byte written.
+ */
+uint8_t* pack_bits(std::span<const bool> from, uint8_t* to) noexcept;
+
+/**
+ * @brief Packs coil statuses eight to a byte, least significant bit first.
+ * @param from The coil statuses. Any value other than 0 is on.
+ * @param to The destination. Must hold at least (from.size() + 7) / 8 bytes.
+ * @return A pointer one past the last byte written.
+ */
+uint8_t* pack_bits(std::span<const uint8_t> from, uint8_t* to) noexcept;
+
+/**
+ * @brief Unpacks coil statuses packed eight to a byte, least significant bit
+ * first.
+ * @param from The packed bits. Must hold at least (to.size() + 7) / 8 bytes.
+ * @param to The coil statuses.
+ */
+void unpack_bits(const uint8_t* from, std::span<bool> to) noexcept;
+
+/**
+ * @brief Unpacks coil statuses packed eight to a byte, least significant bit
+ * first.
+ * @param from The packed bits. Must hold at least (to.size() + 7) / 8 bytes.
+ * @param to The coil statuses as 0 or 1.
+ */
+void unpack_bits(const uint8_t* from, std::span<uint8_t> to) noexcept;
+
+/**
+ * @brief Unpacks coil statuses starting at an arbitrary bit.
+ * @param from The packed bits. Must hold at least
+ * (firstBit + to.size() + 7) / 8 bytes.
+ * @param firstBit The index of the first bit to unpack.
+ * @param to The coil statuses.
+ */
+void unpack_bits(const uint8_t* from, size_t firstBit,
+                 std::span<bool> to) noexcept;
+
+/**
+ * @brief Copies packed bits into 64-bit words. Bit i of the packed bytes
+ * becomes bit i % 64 of word i / 64.
+ * @param from The packed bits.
+ * @param to The destination words. Words past the end of from are cleared.
+ * @return The number of words that hold bits from from.
+ */
+size_t unpack_words(std::span<const uint8_t> from,
+                    std::span<uint64_t> to) noexcept;
+
+/**
+ * @brief Copies packed bits into a bitset. Bit i of the packed bytes becomes
+ * bit i of the bitset. Bits past the end of from are cleared.
+ * @param from The packed bits.
+ */
+template <size_t N>
+std::bitset<N> unpack_bitset(std::span<const uint8_t> from) noexcept {
+    constexpr size_t numWords = (N + 63) / 64;
+    uint64_t words[numWords];
+    unpack_words(from.first(std::min(from.size(), (N + 7) / 8)), words);
+
+    std::bitset<N> bits;
+    for (size_t i = numWords; i-- > 0;) {
+        bits <<= 64;
+        bits |= std::bitset<N>(words[i]);
+    }
+    return bits;
+}
+
+} // namespace modbus
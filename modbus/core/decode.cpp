@@ -0,0 +1,169 @@
+#include "modbus/core/decode.hpp"
+#include "modbus/core/requests.hpp"
+#include "modbus/core/responses.hpp"
+
+namespace modbus {
+
+namespace {
+
+/// The length of a PDU that reads or writes a single address.
+constexpr size_t ADDRESS_PDU_SIZE = write_single_register_request::size();
+/// The length of the header of a response that carries a byte count.
+constexpr size_t BYTE_COUNT_HEADER_SIZE =
+    read_coils_response::codec::layout::header_size;
+/// The length of the header of a write multiple coils/registers request.
+constexpr size_t WRITE_MULTIPLE_HEADER_SIZE =
+    write_multiple_registers_request::codec::layout::header_size;
+/// The length of the header of a read/write multiple registers request.
+constexpr size_t READ_WRITE_HEADER_SIZE =
+    read_write_registers_request::codec::layout::header_size;
+/// The length of a mask write register request or response.
+constexpr size_t MASK_WRITE_PDU_SIZE = mask_write_register_request::size();
+
+/// The largest quantity the message_descriptor of T allows.
+template <typename T>
+constexpr uint16_t max_quantity = message_descriptor<T>::max_quantity;
+
+uint16_t word_at(std::span<const uint8_t> pdu, size_t index) noexcept {
+    return (uint16_t)((pdu[index] << 8) | pdu[index + 1]);
+}
+
+modbus_error_code validate_size(std::span<const uint8_t> pdu,
+                                size_t size) noexcept {
+    return (pdu.size() == size) ? modbus_error_code::success
+                                : modbus_error_code::invalid_length;
+}
+
+modbus_error_code validate_read_request(std::span<const uint8_t> pdu,
+                                        uint16_t maxQuantity) noexcept {
+    if (pdu.size() != ADDRESS_PDU_SIZE) {
+        return modbus_error_code::invalid_length;
+    }
+
+    uint16_t quantity = word_at(pdu, 4);
+    if (quantity == 0 || quantity > maxQuantity) {
+        return modbus_error_code::invalid_quantity;
+    }
+
+    return modbus_error_code::success;
+}
+
+modbus_error_code validate_read_response(std::span<const uint8_t> pdu,
+                                         size_t elementSize) noexcept {
+    if (pdu.size() < BYTE_COUNT_HEADER_SIZE) {
+        return modbus_error_code::invalid_length;
+    }
+
+    size_t byteCount = pdu[2];
+    if (byteCount == 0 || byteCount % elementSize != 0) {
+        return modbus_error_code::invalid_byte_count;
+    }
+
+    return validate_size(pdu, BYTE_COUNT_HEADER_SIZE + byteCount);
+}
+
+modbus_error_code validate_write_multiple(std::span<const uint8_t> pdu,
+                                          bool registers) noexcept {
+    if (pdu.size() < WRITE_MULTIPLE_HEADER_SIZE) {
+        return modbus_error_code::invalid_length;
+    }
+
+    uint16_t quantity = word_at(pdu, 4);
+    uint16_t maxQuantity =
+        registers ? max_quantity<write_multiple_registers_request>
+                  : max_quantity<write_multiple_coils_request>;
+    if (quantity == 0 || quantity > maxQuantity) {
+        return modbus_error_code::invalid_quantity;
+    }
+
+    size_t byteCount = pdu[6];
+    size_t expectedCount = registers ? quantity * 2 : (quantity + 7) / 8;
+    if (byteCount != expectedCount) {
+        return modbus_error_code::invalid_byte_count;
+    }
+
+    return validate_size(pdu, WRITE_MULTIPLE_HEADER_SIZE + byteCount);
+}
+
+modbus_error_code
+validate_read_write_request(std::span<const uint8_t> pdu) noexcept {
+    if (pdu.size() < READ_WRITE_HEADER_SIZE) {
+        return modbus_error_code::invalid_length;
+    }
+
+    uint16_t readQuantity = word_at(pdu, 4);
+    uint16_t writeQuantity = word_at(pdu, 8);
+    if (readQuantity == 0 ||
+        readQuantity > max_quantity<read_write_registers_response> ||
+        writeQuantity == 0 ||
+        writeQuantity > max_quantity<read_write_registers_request>) {
+        return modbus_error_code::invalid_quantity;
+    }
+
+    size_t byteCount = pdu[10];
+    if (byteCount != (size_t)writeQuantity * 2) {
+        return modbus_error_code::invalid_byte_count;
+    }
+
+    return validate_size(pdu, READ_WRITE_HEADER_SIZE + byteCount);
+}
+
+} // namespace
+
+modbus_error_code validate_pdu(std::span<const uint8_t> pdu,
+                               message_type type) noexcept {
+    // the PDU must at least hold the unit id and the function code
+    if (pdu.size() < 2 || pdu.size() > max_pdu_size + 1) {
+        return modbus_error_code::invalid_length;
+    }
+
+    bool request = (type == message_type::request);
+    if (!request && type != message_type::response) {
+        return modbus_error_code::internal_error;
+    }
+
+    uint8_t functionCode = pdu[1];
+    if (functionCode & 0x80) {
+        if (request) {
+            return modbus_error_code::invalid_function_code;
+        }
+        return validate_size(pdu, EXCEPTION_PDU_SIZE);
+    }
+
+    switch ((function_code_t)functionCode) {
+    case function_code_t::read_coils:
+        return request ? validate_read_request(
+                             pdu, max_quantity<read_coils_request>)
+                       : validate_read_response(pdu, 1);
+    case function_code_t::read_discrete_inputs:
+        return request ? validate_read_request(
+                             pdu, max_quantity<read_discrete_inputs_request>)
+                       : validate_read_response(pdu, 1);
+    case function_code_t::read_holding_registers:
+        return request ? validate_read_request(
+                             pdu, max_quantity<read_holding_registers_request>)
+                       : validate_read_response(pdu, 2);
+    case function_code_t::read_input_registers:
+        return request ? validate_read_request(
+                             pdu, max_quantity<read_input_registers_request>)
+                       : validate_read_response(pdu, 2);
+    case function_code_t::write_single_coil:
+    case function_code_t::write_single_register:
+        return validate_size(pdu, ADDRESS_PDU_SIZE);
+    case function_code_t::write_multiple_coils:
+        return request ? validate_write_multiple(pdu, false)
+                       : validate_size(pdu, ADDRESS_PDU_SIZE);
+    case function_code_t::write_multiple_registers:
+        return request ? validate_write_multiple(pdu, true)
+                       : validate_size(pdu, ADDRESS_PDU_SIZE);
+    case function_code_t::mask_write_register:
+        return validate_size(pdu, MASK_WRITE_PDU_SIZE);
+    case function_code_t::read_write_multiple_registers:
+        return request ? validate_read_write_request(pdu)
+                       : validate_read_response(pdu, 2);
+    default:
+        return modbus_error_code::invalid_function_code;
+    }
+}
+
+} // namespace modbus
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+#include "modbus/core/error.hpp"
+#include "modbus/core/expected.hpp"
+#include "modbus/core/messages/exception_response.hpp"
+#include "modbus/core/messages/is_message.hpp"
+#include "modbus/core/types.hpp"
+
+namespace modbus {
+
+/**
+ * @brief Checks that a PDU is well formed without throwing. The length of the
+ * PDU, the byte count and the quantity fields are checked against each other
+ * and against the limits of the function code.
+ * @param pdu The bytes of the PDU, from the unit ID to the last byte of data.
+ * Trailing bytes are not allowed.
+ * @param type Whether the PDU is a request or a response.
+ * @return modbus_error_code::success if the PDU is well formed.
+ */
+modbus_error_code validate_pdu(std::span<const uint8_t> pdu,
+                               message_type type) noexcept;
+
+/**
+ * @brief Decodes a PDU without throwing.
+ * @param pdu The bytes of the PDU, from the unit ID to the last byte of data.
+ * Trailing bytes are not allowed.
+ * @return The message, or the reason the PDU could not be decoded. If T is a
+ * message view the result references pdu.
+ */
+template <typename T>
+expected<T, modbus_error_code> decode(std::span<const uint8_t> pdu) noexcept {
+    if (pdu.size() < 2) {
+        return unexpected(modbus_error_code::invalid_length);
+    }
+
+    if constexpr (std::is_same_v<T, exception_response>) {
+        if ((pdu[1] & 0x80) == 0) {
+            return unexpected(modbus_error_code::invalid_function_code);
+        }
+    } else {
+        if (pdu[1] != (uint8_t)T::function_code()) {
+            return unexpected(modbus_error_code::invalid_function_code);
+        }
+    }
+
+    modbus_error_code error = validate_pdu(pdu, T::type());
+    if (error != modbus_error_code::success) {
+        return unexpected(error);
+    }
+
+    // the constructors cannot fail once the PDU has been validated
+    if constexpr (detail::is_message_view<T>::value) {
+        return T(pdu);
+    } else {
+        return T(pdu.data());
+    }
+}
+
+} // namespace modbus
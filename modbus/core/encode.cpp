@@ -0,0 +1,85 @@
+#include "modbus/core/encode.hpp"
+
+#include "modbus/core/bit_pack.hpp"
+#include "modbus/core/endian.hpp"
+
+namespace modbus {
+
+namespace {
+
+/// The size of a write multiple request before its values, including the
+/// unit id.
+constexpr size_t WRITE_MULTIPLE_HEADER_SIZE = 7;
+
+/**
+ * @brief Writes the MBAP header and the fixed fields of a write multiple
+ * request.
+ * @return A pointer to where the values go, or nullptr if the frame does not
+ * fit in out.
+ */
+uint8_t* encode_write_header(uint16_t transactionId, uint8_t unitId,
+                             function_code_t functionCode, uint16_t address,
+                             uint16_t quantity, size_t byteCount,
+                             std::span<uint8_t> out) noexcept {
+    size_t length = WRITE_MULTIPLE_HEADER_SIZE + byteCount;
+    if (out.size() < TCP_HEADER_SIZE + length) {
+        return nullptr;
+    }
+
+    uint8_t* it = out.data();
+    *it++ = (uint8_t)(transactionId >> 8);
+    *it++ = (uint8_t)(transactionId);
+    *it++ = (uint8_t)(PROTOCOL_ID >> 8);
+    *it++ = (uint8_t)(PROTOCOL_ID);
+    *it++ = (uint8_t)(length >> 8);
+    *it++ = (uint8_t)(length);
+
+    *it++ = unitId;
+    *it++ = (uint8_t)functionCode;
+    *it++ = (uint8_t)(address >> 8);
+    *it++ = (uint8_t)(address);
+    *it++ = (uint8_t)(quantity >> 8);
+    *it++ = (uint8_t)(quantity);
+    *it++ = (uint8_t)byteCount;
+    return it;
+}
+
+} // namespace
+
+size_t encode_write_coils(uint16_t transactionId, uint8_t unitId,
+                          uint16_t address, std::span<const bool> values,
+                          std::span<uint8_t> out) noexcept {
+    if (values.empty() || values.size() > MAX_WRITE_BITS) {
+        return 0;
+    }
+
+    size_t byteCount = (values.size() + 7) / 8;
+    uint8_t* it = encode_write_header(
+        transactionId, unitId, function_code_t::write_multiple_coils, address,
+        (uint16_t)values.size(), byteCount, out);
+    if (it == nullptr) {
+        return 0;
+    }
+
+    return pack_bits(values, it) - out.data();
+}
+
+size_t encode_write_registers(uint16_t transactionId, uint8_t unitId,
+                              uint16_t address,
+                              std::span<const uint16_t> values,
+                              std::span<uint8_t> out) noexcept {
+    if (values.empty() || values.size() > MAX_WRITE_REGISTERS) {
+        return 0;
+    }
+
+    uint8_t* it = encode_write_header(
+        transactionId, unitId, function_code_t::write_multiple_registers,
+        address, (uint16_t)values.size(), values.size() * 2, out);
+    if (it == nullptr) {
+        return 0;
+    }
+
+    return store_registers(values, it) - out.data();
+}
+
+} // namespace modbus
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+
+#include "modbus/core/messages/is_message.hpp"
+#include "modbus/core/types.hpp"
+
+namespace modbus {
+
+/**
+ * @brief Writes the MBAP header and the PDU of a message into a buffer owned by
+ * the caller.
+ * @param transactionId The transaction ID as defined by the MODBUS standard.
+ * @param pdu The message to write. It must meet the requirements of
+ * is_message.
+ * @param out The buffer to write the frame into.
+ * @return The number of bytes written, or 0 if out is too small to hold the
+ * frame. Nothing is written if the frame does not fit.
+ */
+template <typename M>
+size_t encode(uint16_t transactionId, const M& pdu,
+              std::span<uint8_t> out) noexcept {
+    // Stop compilation if requirements for Message
+    static_assert(detail::is_message<M>::value,
+                  "Message Requirements not met.");
+
+    size_t length = pdu.size();
+    size_t frameLength = TCP_HEADER_SIZE + length;
+    if (out.size() < frameLength) {
+        return 0;
+    }
+
+    uint8_t* it = out.data();
+
+    // transaction ID
+    *it++ = (uint8_t)(transactionId >> 8);
+    *it++ = (uint8_t)(transactionId);
+
+    // protocol ID
+    *it++ = (uint8_t)(PROTOCOL_ID >> 8);
+    *it++ = (uint8_t)(PROTOCOL_ID);
+
+    // message length
+    *it++ = (uint8_t)(length >> 8);
+    *it++ = (uint8_t)(length);
+
+    pdu.serialize(it);
+
+    return frameLength;
+}
+
+/**
+ * @brief Writes a Write Multiple Coils request straight from the caller's
+ * coil statuses, without building a write_multiple_coils_request.
+ * @param transactionId The transaction ID as defined by the MODBUS standard.
+ * @param unitId The unit ID of the device.
+ * @param address The address of the first coil.
+ * @param values The coil statuses. Between 1 and MAX_WRITE_BITS may be
+ * written.
+ * @param out The buffer to write the frame into.
+ * @return The number of bytes written, or 0 if the quantity is out of range
+ * or out is too small to hold the frame.
+ */
+size_t encode_write_coils(uint16_t transactionId, uint8_t unitId,
+                          uint16_t address, std::span<const bool> values,
+                          std::span<uint8_t> out) noexcept;
+
+/**
+ * @brief Writes a Write Multiple Registers request straight from the caller's
+ * values, without building a write_multiple_registers_request.
+ * @param transactionId The transaction ID as defined by the MODBUS standard.
+ * @param unitId The unit ID of the device.
+ * @param address The address of the first register.
+ * @param values The register values. Between 1 and MAX_WRITE_REGISTERS may be
+ * written.
+ * @param out The buffer to write the frame into.
+ * @return The number of bytes written, or 0 if the quantity is out of range
+ * or out is too small to hold the frame.
+ */
+size_t encode_write_registers(uint16_t transactionId, uint8_t unitId,
+                              uint16_t address,
+                              std::span<const uint16_t> values,
+                              std::span<uint8_t> out) noexcept;
+
+/**
+ * @brief An append-only writer that encodes frames back-to-back into a single
+ * buffer owned by the caller.
+ *
+ * @section This allows several requests or responses to be sent with a single
+ * write without allocating.
+ */
+class tcp_frame_writer {
+  public:
+    /**
+     * @brief Creates a writer over buffer.
+     * @param buffer The buffer that frames are written into.
+     */
+    explicit tcp_frame_writer(std::span<uint8_t> buffer) noexcept
+        : buffer_(buffer)
+        , size_(0) {}
+
+    /**
+     * @brief Appends a frame to the end of the buffer.
+     * @param transactionId The transaction ID of the frame.
+     * @param pdu The message to write.
+     * @return The number of bytes appended, or 0 if the frame does not fit in
+     * the remaining space.
+     */
+    template <typename M>
+    size_t append(uint16_t transactionId, const M& pdu) noexcept {
+        size_t written = encode(transactionId, pdu, buffer_.subspan(size_));
+        size_ += written;
+        return written;
+    }
+
+    /**
+     * @brief Appends a frame that has already been encoded.
+     * @param frame The bytes of the frame.
+     * @return The number of bytes appended, or 0 if the frame does not fit in
+     * the remaining space.
+     */
+    size_t append(std::span<const uint8_t> frame) noexcept {
+        if (frame.size() > remaining()) {
+            return 0;
+        }
+
+        std::copy(frame.begin(), frame.end(), buffer_.begin() + size_);
+        size_ += frame.size();
+        return frame.size();
+    }
+
+    /**
+     * @return The frames that have been written so far.
+     */
+    std::span<const uint8_t> data() const noexcept {
+        return buffer_.first(size_);
+    }
+
+    /**
+     * @return The number of bytes written so far.
+     */
+    size_t size() const noexcept { return size_; }
+
+    /**
+     * @return The number of bytes that can still be written.
+     */
+    size_t remaining() const noexcept { return buffer_.size() - size_; }
+
+    /**
+     * @return Whether or not any frames have been written.
+     */
+    bool empty() const noexcept { return size_ == 0; }
+
+    /**
+     * @brief Discards all frames so the buffer can be reused.
+     */
+    void clear() noexcept { size_ = 0; }
+
+  private:
+    std::span<uint8_t> buffer_;
+    size_t size_;
+};
+
+} // namespace modbus
@@ -0,0 +1,138 @@
+#include "modbus/core/endian.hpp"
+
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define MODBUS_SIMD_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(__ARM_NEON)
+#define MODBUS_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace modbus {
+
+namespace {
+
+/// Swaps the bytes of count 16-bit words. from and to may not overlap.
+using swap_function = void (*)(const uint8_t* from, uint8_t* to,
+                               size_t count) noexcept;
+
+void swap_scalar(const uint8_t* from, uint8_t* to, size_t count) noexcept {
+    for (size_t i = 0; i < count; i++) {
+        uint16_t word;
+        std::memcpy(&word, from + 2 * i, sizeof(word));
+        word = (uint16_t)((word << 8) | (word >> 8));
+        std::memcpy(to + 2 * i, &word, sizeof(word));
+    }
+}
+
+#if defined(MODBUS_SIMD_X86)
+
+void swap_sse2(const uint8_t* from, uint8_t* to, size_t count) noexcept {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(from + 2 * i));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        _mm_storeu_si128((__m128i*)(to + 2 * i), v);
+    }
+    swap_scalar(from + 2 * i, to + 2 * i, count - i);
+}
+
+__attribute__((target("avx2"))) void
+swap_avx2(const uint8_t* from, uint8_t* to, size_t count) noexcept {
+    const __m256i mask = _mm256_setr_epi8(
+        1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14, 1, 0, 3, 2, 5, 4,
+        7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(from + 2 * i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(from + 2 * i + 32));
+        _mm256_storeu_si256((__m256i*)(to + 2 * i),
+                            _mm256_shuffle_epi8(a, mask));
+        _mm256_storeu_si256((__m256i*)(to + 2 * i + 32),
+                            _mm256_shuffle_epi8(b, mask));
+    }
+    for (; i + 16 <= count; i += 16) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(from + 2 * i));
+        _mm256_storeu_si256((__m256i*)(to + 2 * i),
+                            _mm256_shuffle_epi8(v, mask));
+    }
+    if (i + 8 <= count) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(from + 2 * i));
+        _mm_storeu_si128((__m128i*)(to + 2 * i),
+                         _mm_shuffle_epi8(v, _mm256_castsi256_si128(mask)));
+        i += 8;
+    }
+
+    // the tail is handled here rather than by swap_sse2 so that no legacy SSE
+    // instructions run while the upper halves of the registers are dirty
+    for (; i < count; i++) {
+        uint16_t word;
+        std::memcpy(&word, from + 2 * i, sizeof(word));
+        word = __builtin_bswap16(word);
+        std::memcpy(to + 2 * i, &word, sizeof(word));
+    }
+}
+
+#elif defined(MODBUS_SIMD_NEON)
+
+void swap_neon(const uint8_t* from, uint8_t* to, size_t count) noexcept {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        vst1q_u8(to + 2 * i, vrev16q_u8(vld1q_u8(from + 2 * i)));
+    }
+    swap_scalar(from + 2 * i, to + 2 * i, count - i);
+}
+
+#endif
+
+struct swap_kernel {
+    simd_level level;
+    swap_function swap;
+};
+
+swap_kernel select_kernel() noexcept {
+#if defined(MODBUS_SIMD_X86)
+    if (__builtin_cpu_supports("avx2")) {
+        return {simd_level::avx2, swap_avx2};
+    }
+    return {simd_level::sse2, swap_sse2};
+#elif defined(MODBUS_SIMD_NEON)
+    return {simd_level::neon, swap_neon};
+#else
+    return {simd_level::scalar, swap_scalar};
+#endif
+}
+
+const swap_kernel& kernel() noexcept {
+    static const swap_kernel selected = select_kernel();
+    return selected;
+}
+
+void to_big_endian(const uint8_t* from, uint8_t* to, size_t count) noexcept {
+    if constexpr (std::endian::native == std::endian::big) {
+        std::memcpy(to, from, 2 * count);
+    } else {
+        kernel().swap(from, to, count);
+    }
+}
+
+} // namespace
+
+simd_level active_simd_level() noexcept { return kernel().level; }
+
+uint8_t* store_registers(std::span<const uint16_t> from, uint8_t* to) noexcept {
+    to_big_endian((const uint8_t*)from.data(), to, from.size());
+    return to + from.size_bytes();
+}
+
+const uint8_t* load_registers(const uint8_t* from,
+                              std::span<uint16_t> to) noexcept {
+    to_big_endian(from, (uint8_t*)to.data(), to.size());
+    return from + to.size_bytes();
+}
+
+} // namespace modbus
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+namespace modbus {
+
+/**
+ * @brief The instruction set used by the bulk register conversion routines.
+ */
+enum class simd_level : uint8_t { scalar, sse2, avx2, neon };
+
+/**
+ * @return The instruction set selected at startup for the bulk register
+ * conversion routines.
+ */
+simd_level active_simd_level() noexcept;
+
+/**
+ * @brief Converts registers from host byte order to big-endian bytes, as they
+ * are sent in a MODBUS PDU.
+ * @param from The registers in host byte order.
+ * @param to The destination. Must hold at least 2 * from.size() bytes and may
+ * not overlap from.
+ * @return A pointer one past the last byte written.
+ */
+uint8_t* store_registers(std::span<const uint16_t> from, uint8_t* to) noexcept;
+
+/**
+ * @brief Converts big-endian register bytes, as they are sent in a MODBUS PDU,
+ * to host byte order.
+ * @param from The big-endian bytes. Must hold at least 2 * to.size() bytes and
+ * may not overlap to.
+ * @param to The registers in host byte order.
+ * @return A pointer one past the last byte read.
+ */
+const uint8_t* load_registers(const uint8_t* from,
+                              std::span<uint16_t> to) noexcept;
+
+} // namespace modbus
@@ -1,4 +1,5 @@
 #include "modbus/core/error.hpp"
+#include "modbus/core/types.hpp"
 
 namespace modbus {
 
@@ -22,6 +23,16 @@ struct modbus_error_code_category : std::error_category {
             return "The CRC check of the PDU failed";
         case modbus_error_code::lrc_check_failed:
             return "The LRC check of the PDU failed";
+        case modbus_error_code::invalid_protocol_id:
+            return "The protocol ID of the MBAP header is invalid";
+        case modbus_error_code::invalid_length:
+            return "The length of the frame is invalid";
+        case modbus_error_code::invalid_function_code:
+            return "The function code does not match the message";
+        case modbus_error_code::invalid_byte_count:
+            return "The byte count does not match the payload";
+        case modbus_error_code::invalid_quantity:
+            return "The quantity is outside of the limits of the function code";
         default:
             return "(unrecognized error)";
         }
@@ -48,6 +59,8 @@ struct modbus_client_error_code_category : std::error_category {
             return "The client was disconnected";
         case modbus_client_error_code::stopped:
             return "The client was stopped";
+        case modbus_client_error_code::cancelled:
+            return "The request was cancelled";
         default:
             return "(unrecognized error)";
         }
@@ -71,9 +84,22 @@ struct modbus_server_error_code_category : std::error_category {
     }
 };
 
+struct modbus_exception_category : std::error_category {
+    const char* name() const noexcept override { return "ModbusException"; }
+
+    std::string message(int ev) const override {
+        auto code = static_cast<exception_code_t>(ev);
+        if (code == exception_code_t::no_exception) {
+            return "Success";
+        }
+        return "The server answered with an exception: " + to_string(code);
+    }
+};
+
 const modbus_error_code_category theModbusErrorCodeCategory{};
 const modbus_client_error_code_category theModbusClientErrorCodeCategory{};
 const modbus_server_error_code_category theModbusServerErrorCodeCategory{};
+const modbus_exception_category theModbusExceptionCategory{};
 
 } // namespace detail
 
@@ -89,4 +115,8 @@ std::error_code make_error_code(modbus_server_error_code e) {
     return {static_cast<int>(e), detail::theModbusServerErrorCodeCategory};
 }
 
+std::error_code make_error_code(exception_code_t e) {
+    return {static_cast<int>(e), detail::theModbusExceptionCategory};
+}
+
 } // namespace modbus
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <system_error>
 
 namespace modbus {
@@ -16,7 +17,20 @@ enum class modbus_error_code : uint8_t {
     /// crc_check_failed The CRC check of the PDU failed
     crc_check_failed,
     /// LrcCheckFailed The LRC check of the PDU failed
-    lrc_check_failed
+    lrc_check_failed,
+    /// invalid_protocol_id The protocol ID of the MBAP header is not 0
+    invalid_protocol_id,
+    /// invalid_length The length of the frame does not match the MBAP header or
+    /// the length required by the function code
+    invalid_length,
+    /// invalid_function_code The function code does not match the message
+    invalid_function_code,
+    /// invalid_byte_count The byte count field does not match the quantity or
+    /// the number of bytes in the PDU
+    invalid_byte_count,
+    /// invalid_quantity The quantity of coils or registers is outside of the
+    /// limits of the function code
+    invalid_quantity
 };
 
 enum class modbus_client_error_code : uint8_t {
@@ -34,7 +48,10 @@ enum class modbus_client_error_code : uint8_t {
     disconnected,
     /// stopped The client has been stopped. No more requests should be sent to
     /// the client.
-    stopped
+    stopped,
+    /// cancelled The request was cancelled through the cancellation slot of
+    /// the operation awaiting it.
+    cancelled
 };
 
 enum class modbus_server_error_code : uint8_t {
@@ -44,9 +61,14 @@ enum class modbus_server_error_code : uint8_t {
     exceeded_max_sessions
 };
 
+/// The exception codes a server answers with; defined in types.hpp. They are
+/// error codes so that an exception response can be returned as an error.
+enum class exception_code_t : uint8_t;
+
 std::error_code make_error_code(modbus_error_code);
 std::error_code make_error_code(modbus_client_error_code);
 std::error_code make_error_code(modbus_server_error_code);
+std::error_code make_error_code(exception_code_t);
 
 } // namespace modbus
 
@@ -58,4 +80,6 @@ template <>
 struct is_error_code_enum<modbus::modbus_client_error_code> : true_type {};
 template <>
 struct is_error_code_enum<modbus::modbus_server_error_code> : true_type {};
+template <>
+struct is_error_code_enum<modbus::exception_code_t> : true_type {};
 } // namespace std
\ No newline at end of file
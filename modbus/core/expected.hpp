@@ -0,0 +1,135 @@
+#pragma once
+
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#if __has_include(<expected>)
+#include <expected>
+#endif
+
+namespace modbus {
+
+#if defined(__cpp_lib_expected)
+
+template <typename T, typename E> using expected = std::expected<T, E>;
+
+template <typename E> using unexpected = std::unexpected<E>;
+
+#else
+
+/**
+ * @brief Holds the error of an expected. A stand-in for std::unexpected until
+ * the standard library provides it.
+ */
+template <typename E> class unexpected {
+  public:
+    constexpr explicit unexpected(E error) noexcept(
+        std::is_nothrow_move_constructible_v<E>)
+        : error_(std::move(error)) {}
+
+    constexpr const E& error() const& noexcept { return error_; }
+
+    constexpr E& error() & noexcept { return error_; }
+
+  private:
+    E error_;
+};
+
+template <typename E> unexpected(E) -> unexpected<E>;
+
+/**
+ * @brief Holds either a value or the error that prevented the value from being
+ * created. A minimal stand-in for std::expected until the standard library
+ * provides it. Only the members used by this library are provided.
+ */
+template <typename T, typename E> class expected {
+  public:
+    using value_type = T;
+    using error_type = E;
+
+    constexpr expected(const T& value) noexcept(
+        std::is_nothrow_copy_constructible_v<T>)
+        : storage_(std::in_place_index<0>, value) {}
+
+    constexpr expected(T&& value) noexcept(
+        std::is_nothrow_move_constructible_v<T>)
+        : storage_(std::in_place_index<0>, std::move(value)) {}
+
+    constexpr expected(unexpected<E> error) noexcept(
+        std::is_nothrow_move_constructible_v<E>)
+        : storage_(std::in_place_index<1>, std::move(error.error())) {}
+
+    /**
+     * @return Whether or not the expected holds a value.
+     */
+    constexpr bool has_value() const noexcept {
+        return storage_.index() == 0;
+    }
+
+    constexpr explicit operator bool() const noexcept { return has_value(); }
+
+    /**
+     * @return The value.
+     * @throws std::logic_error if the expected holds an error.
+     */
+    constexpr const T& value() const& {
+        if (!has_value()) {
+            throw std::logic_error("expected does not hold a value");
+        }
+        return *std::get_if<0>(&storage_);
+    }
+
+    constexpr T& value() & {
+        if (!has_value()) {
+            throw std::logic_error("expected does not hold a value");
+        }
+        return *std::get_if<0>(&storage_);
+    }
+
+    constexpr T&& value() && { return std::move(value()); }
+
+    /**
+     * @return The error. The behavior is undefined if the expected holds a
+     * value.
+     */
+    constexpr const E& error() const& noexcept {
+        return *std::get_if<1>(&storage_);
+    }
+
+    /**
+     * @return The value, or default_value if the expected holds an error.
+     */
+    template <typename U> constexpr T value_or(U&& default_value) const& {
+        return has_value() ? **this
+                           : static_cast<T>(std::forward<U>(default_value));
+    }
+
+    /**
+     * @return The value. The behavior is undefined if the expected holds an
+     * error.
+     */
+    constexpr const T& operator*() const& noexcept {
+        return *std::get_if<0>(&storage_);
+    }
+
+    constexpr T& operator*() & noexcept { return *std::get_if<0>(&storage_); }
+
+    constexpr T&& operator*() && noexcept {
+        return std::move(*std::get_if<0>(&storage_));
+    }
+
+    constexpr const T* operator->() const noexcept {
+        return std::get_if<0>(&storage_);
+    }
+
+    constexpr T* operator->() noexcept { return std::get_if<0>(&storage_); }
+
+  private:
+    std::variant<T, E> storage_;
+};
+
+#endif
+
+} // namespace modbus
@@ -0,0 +1,207 @@
+#include "modbus/core/frame_pool.hpp"
+
+#include <stdexcept>
+
+namespace modbus {
+
+namespace detail {
+
+/**
+ * @brief The storage behind a frame_pool.
+ *
+ * @section The head of the free list, the number of free frames, whether the
+ * pool has been destroyed and an ABA tag are packed into a single word so that
+ * acquiring or releasing a frame costs one compare-and-swap. The slab deletes
+ * itself once the pool has been destroyed and every frame has been returned.
+ */
+class frame_slab {
+  public:
+    static constexpr uint64_t index_bits = 20;
+    static constexpr uint64_t count_bits = 21;
+    static constexpr uint32_t npos = (1u << index_bits) - 1;
+    static constexpr size_t max_capacity = npos - 1;
+
+    explicit frame_slab(size_t capacity)
+        : frames_(std::make_unique<frame[]>(capacity))
+        , capacity_(capacity)
+        , head_(pack(0, false, capacity, 0)) {
+        for (size_t i = 0; i < capacity; i++) {
+            frames_[i].slab = this;
+            frames_[i].next.store(
+                (i + 1 < capacity) ? (uint32_t)(i + 1) : npos,
+                std::memory_order_relaxed);
+        }
+    }
+
+    frame* pop() noexcept {
+        uint64_t head = head_.load(std::memory_order_acquire);
+        while (true) {
+            uint32_t index = index_of(head);
+            if (index == npos) {
+                return nullptr;
+            }
+
+            uint32_t next = frames_[index].next.load(std::memory_order_relaxed);
+            // the tag is bumped on every update so a stale head cannot succeed
+            uint64_t desired = pack(tag_of(head) + 1, closed(head),
+                                    count_of(head) - 1, next);
+            if (head_.compare_exchange_weak(head, desired,
+                                            std::memory_order_acquire,
+                                            std::memory_order_acquire)) {
+                return &frames_[index];
+            }
+        }
+    }
+
+    void push(frame* f) noexcept {
+        uint32_t index = (uint32_t)(f - frames_.get());
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        uint64_t desired;
+        do {
+            f->next.store(index_of(head), std::memory_order_relaxed);
+            desired = pack(tag_of(head) + 1, closed(head), count_of(head) + 1,
+                           index);
+        } while (!head_.compare_exchange_weak(head, desired,
+                                              std::memory_order_acq_rel,
+                                              std::memory_order_relaxed));
+
+        if (closed(desired) && count_of(desired) == capacity_) {
+            delete this;
+        }
+    }
+
+    void close() noexcept {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        uint64_t desired;
+        do {
+            desired = pack(tag_of(head) + 1, true, count_of(head),
+                           index_of(head));
+        } while (!head_.compare_exchange_weak(head, desired,
+                                              std::memory_order_acq_rel,
+                                              std::memory_order_relaxed));
+
+        if (count_of(desired) == capacity_) {
+            delete this;
+        }
+    }
+
+    size_t capacity() const noexcept { return capacity_; }
+
+    size_t available() const noexcept {
+        return count_of(head_.load(std::memory_order_relaxed));
+    }
+
+  private:
+    static constexpr uint64_t count_shift = index_bits;
+    static constexpr uint64_t closed_shift = count_shift + count_bits;
+    static constexpr uint64_t tag_shift = closed_shift + 1;
+
+    static constexpr uint64_t pack(uint64_t tag, bool closed, uint64_t count,
+                                   uint32_t index) noexcept {
+        return (tag << tag_shift) | ((uint64_t)closed << closed_shift) |
+               (count << count_shift) | index;
+    }
+
+    static constexpr uint64_t tag_of(uint64_t head) noexcept {
+        return head >> tag_shift;
+    }
+
+    static constexpr bool closed(uint64_t head) noexcept {
+        return (head >> closed_shift) & 0x01;
+    }
+
+    static constexpr size_t count_of(uint64_t head) noexcept {
+        return (head >> count_shift) & ((1ull << count_bits) - 1);
+    }
+
+    static constexpr uint32_t index_of(uint64_t head) noexcept {
+        return (uint32_t)(head & npos);
+    }
+
+    std::unique_ptr<frame[]> frames_;
+    size_t capacity_;
+    std::atomic<uint64_t> head_;
+};
+
+} // namespace detail
+
+frame_ptr::frame_ptr(const frame_ptr& other) noexcept
+    : frame_(other.frame_) {
+    if (frame_ != nullptr) {
+        frame_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+frame_ptr& frame_ptr::operator=(const frame_ptr& other) noexcept {
+    if (frame_ != other.frame_) {
+        frame_ptr copy(other);
+        std::swap(frame_, copy.frame_);
+    }
+    return *this;
+}
+
+frame_ptr& frame_ptr::operator=(frame_ptr&& other) noexcept {
+    if (this != &other) {
+        reset();
+        frame_ = other.frame_;
+        other.frame_ = nullptr;
+    }
+    return *this;
+}
+
+frame_ptr::~frame_ptr() { reset(); }
+
+void frame_ptr::reset() noexcept {
+    if (frame_ == nullptr) {
+        return;
+    }
+
+    // a sole owner cannot race with anyone so the decrement can be skipped
+    if (frame_->refs.load(std::memory_order_acquire) == 1 ||
+        frame_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        if (frame_->slab != nullptr) {
+            frame_->slab->push(frame_);
+        } else {
+            delete frame_;
+        }
+    }
+    frame_ = nullptr;
+}
+
+frame_pool::frame_pool(size_t capacity)
+    : slab_(nullptr) {
+    if (capacity == 0 || capacity > detail::frame_slab::max_capacity) {
+        throw std::invalid_argument("Frame pool capacity is invalid.");
+    }
+
+    slab_ = new detail::frame_slab(capacity);
+}
+
+frame_pool::~frame_pool() { slab_->close(); }
+
+frame_ptr frame_pool::acquire(size_t size) {
+    if (size > MAX_APU_SIZE) {
+        throw std::out_of_range("Frame size exceeds MAX_APU_SIZE.");
+    }
+
+    frame* f = slab_->pop();
+    if (f == nullptr) {
+        f = new frame();
+    }
+
+    f->size = (uint16_t)size;
+    f->refs.store(1, std::memory_order_relaxed);
+    return frame_ptr(f);
+}
+
+size_t frame_pool::capacity() const noexcept { return slab_->capacity(); }
+
+size_t frame_pool::available() const noexcept { return slab_->available(); }
+
+const std::shared_ptr<frame_pool>& frame_pool::default_pool() {
+    static const std::shared_ptr<frame_pool> pool =
+        std::make_shared<frame_pool>();
+    return pool;
+}
+
+} // namespace modbus
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+#include "modbus/core/types.hpp"
+
+namespace modbus {
+
+/// The number of frames held by the default frame pool.
+constexpr size_t DEFAULT_FRAME_POOL_CAPACITY = 1024;
+
+namespace detail {
+class frame_slab;
+} // namespace detail
+
+/**
+ * @brief A fixed-size block of storage large enough to hold any MODBUS TCP
+ * frame.
+ *
+ * @section Frames are reference counted intrusively so that handing a frame
+ * from one owner to another does not need a separate control block.
+ */
+struct frame {
+    /// The bytes of the frame.
+    std::array<uint8_t, MAX_APU_SIZE> data;
+    /// The number of bytes of data that are in use.
+    uint16_t size = 0;
+    /// The number of frame_ptr objects that reference this frame.
+    std::atomic<uint32_t> refs = 0;
+    /// The index of the next free frame while the frame is on a free list.
+    std::atomic<uint32_t> next = 0;
+    /// The slab the frame was drawn from, or nullptr if it was allocated on the
+    /// heap because the pool was exhausted.
+    detail::frame_slab* slab = nullptr;
+};
+
+/**
+ * @brief An owning, intrusively reference counted pointer to a frame. The frame
+ * is returned to its pool when the last frame_ptr that references it is
+ * destroyed.
+ */
+class frame_ptr {
+  public:
+    constexpr frame_ptr() noexcept
+        : frame_(nullptr) {}
+
+    frame_ptr(const frame_ptr& other) noexcept;
+
+    frame_ptr(frame_ptr&& other) noexcept
+        : frame_(other.frame_) {
+        other.frame_ = nullptr;
+    }
+
+    frame_ptr& operator=(const frame_ptr& other) noexcept;
+
+    frame_ptr& operator=(frame_ptr&& other) noexcept;
+
+    ~frame_ptr();
+
+    /**
+     * @return Whether or not the pointer references a frame.
+     */
+    explicit operator bool() const noexcept { return frame_ != nullptr; }
+
+    frame* get() const noexcept { return frame_; }
+
+    frame* operator->() const noexcept { return frame_; }
+
+    frame& operator*() const noexcept { return *frame_; }
+
+    /**
+     * @return The bytes of the frame that are in use. The span is empty if the
+     * pointer does not reference a frame.
+     */
+    std::span<uint8_t> bytes() const noexcept {
+        if (frame_ == nullptr) {
+            return std::span<uint8_t>();
+        }
+        return std::span<uint8_t>(frame_->data.data(), frame_->size);
+    }
+
+  private:
+    friend class frame_pool;
+
+    explicit frame_ptr(frame* f) noexcept
+        : frame_(f) {}
+
+    void reset() noexcept;
+
+    frame* frame_;
+};
+
+/**
+ * @brief A pool of fixed-size frames that are recycled through a lock-free
+ * free list.
+ *
+ * @section Every frame is allocated up front in a single slab. Acquiring and
+ * releasing a frame never takes a lock and, as long as the pool is not
+ * exhausted, never touches the heap. When the pool is exhausted frames are
+ * allocated from the heap instead so that acquire never fails. Frames may
+ * outlive the pool they were drawn from; the slab is freed once the pool and
+ * every frame drawn from it have been destroyed.
+ */
+class frame_pool {
+  public:
+    /**
+     * @brief Creates a frame_pool.
+     * @param capacity The number of frames to allocate up front.
+     * @throws std::invalid_argument if capacity is 0 or too large to index.
+     */
+    explicit frame_pool(size_t capacity = DEFAULT_FRAME_POOL_CAPACITY);
+
+    frame_pool(const frame_pool&) = delete;
+    frame_pool& operator=(const frame_pool&) = delete;
+
+    ~frame_pool();
+
+    /**
+     * @brief Takes a frame from the pool.
+     * @param size The number of bytes of the frame that will be used.
+     * @return A frame with size set to size. The contents are unspecified.
+     * @throws std::out_of_range if size is larger than MAX_APU_SIZE.
+     */
+    frame_ptr acquire(size_t size = 0);
+
+    /**
+     * @return The number of frames allocated by the pool.
+     */
+    size_t capacity() const noexcept;
+
+    /**
+     * @return The number of frames that are waiting on the free list.
+     */
+    size_t available() const noexcept;
+
+    /**
+     * @return The pool used when no pool is specified.
+     */
+    static const std::shared_ptr<frame_pool>& default_pool();
+
+  private:
+    detail::frame_slab* slab_;
+};
+
+} // namespace modbus
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <vector>
 
+#include "modbus/core/messages/message_descriptor.hpp"
 #include "modbus/core/types.hpp"
 
 namespace modbus {
@@ -20,20 +21,48 @@ struct exception_response {
     exception_response(uint8_t unit_id, function_code_t function_code,
                        exception_code_t exception_code);
 
-    exception_response(const_buffer_iterator it);
+    exception_response(const_buffer_iterator it)
+        : exception_response(std::to_address(it)) {}
+
+    exception_response(const uint8_t* it);
 
     constexpr function_code_t function_code() { return func_code; }
 
     static constexpr message_type type() { return message_type::response; }
 
-    size_t size() {
-        return sizeof(unit_id) + sizeof(uint8_t) + // Function Code
-               sizeof(exception_code_t);
+    using codec = message_codec<exception_response>;
+
+    static constexpr size_t size();
+
+    buffer_iterator serialize(buffer_iterator it) const {
+        return it + (serialize(std::to_address(it)) - std::to_address(it));
     }
 
-    buffer_iterator serialize(buffer_iterator it) const;
+    uint8_t* serialize(uint8_t* it) const;
 };
 
+template <> struct message_descriptor<exception_response> {
+    using self = exception_response;
+
+    static constexpr message_type type = message_type::response;
+    static constexpr uint16_t max_quantity = 0;
+    using payload_type = void;
+    using layout =
+        message_layout<fields::u8<&self::unit_id>,
+                       fields::exception_function_code<&self::func_code>,
+                       fields::u8<&self::exception_code>>;
+};
+
+inline exception_response::exception_response(const uint8_t* it) {
+    codec::parse(*this, it);
+}
+
+constexpr size_t exception_response::size() { return codec::size(); }
+
+inline uint8_t* exception_response::serialize(uint8_t* it) const {
+    return codec::serialize(*this, it);
+}
+
 bool operator==(const exception_response& lhs, const exception_response& rhs);
 
 bool operator!=(const exception_response& lhs, const exception_response& rhs);
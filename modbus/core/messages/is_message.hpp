@@ -1,5 +1,6 @@
 #pragma once
 
+#include <span>
 #include <type_traits>
 
 #include "modbus/core/types.hpp"
@@ -33,5 +34,10 @@ template <typename T>
 using is_message =
     std::integral_constant<bool, has_size<T>::value && has_serialize<T>::value>;
 
+/// A message view references the PDU in place and is created from the bytes of
+/// the PDU rather than an iterator.
+template <typename T>
+using is_message_view = std::is_constructible<T, std::span<const uint8_t>>;
+
 } // namespace detail
 } // namespace modbus
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <vector>
 
+#include "modbus/core/messages/message_descriptor.hpp"
 #include "modbus/core/types.hpp"
 
 namespace modbus {
@@ -23,7 +24,10 @@ struct mask_write_register_response {
     mask_write_register_response(uint8_t unit_id, uint16_t start_address,
                                  uint16_t and_mask, uint16_t or_mask);
 
-    mask_write_register_response(const_buffer_iterator it);
+    mask_write_register_response(const_buffer_iterator it)
+        : mask_write_register_response(std::to_address(it)) {}
+
+    mask_write_register_response(const uint8_t* it);
 
     static constexpr function_code_t function_code() {
         return function_code_t::mask_write_register;
@@ -31,14 +35,43 @@ struct mask_write_register_response {
 
     static constexpr message_type type() { return message_type::response; }
 
-    static constexpr size_t size() {
-        return sizeof(unit_id) + sizeof(uint8_t) + sizeof(start_address) +
-               sizeof(and_mask) + sizeof(or_mask);
+    using codec = message_codec<mask_write_register_response>;
+
+    static constexpr size_t size();
+
+    buffer_iterator serialize(buffer_iterator it) const {
+        return it + (serialize(std::to_address(it)) - std::to_address(it));
     }
 
-    buffer_iterator serialize(buffer_iterator it) const;
+    uint8_t* serialize(uint8_t* it) const;
 };
 
+template <> struct message_descriptor<mask_write_register_response> {
+    using self = mask_write_register_response;
+
+    static constexpr function_code_t function_code =
+        function_code_t::mask_write_register;
+    static constexpr message_type type = message_type::response;
+    static constexpr uint16_t max_quantity = 0;
+    using payload_type = void;
+    using layout = message_layout<fields::u8<&self::unit_id>,
+                                  fields::function_code,
+                                  fields::u16<&self::start_address>,
+                                  fields::u16<&self::and_mask>,
+                                  fields::u16<&self::or_mask>>;
+};
+
+inline mask_write_register_response::mask_write_register_response(
+    const uint8_t* it) {
+    codec::parse(*this, it);
+}
+
+constexpr size_t mask_write_register_response::size() { return codec::size(); }
+
+inline uint8_t* mask_write_register_response::serialize(uint8_t* it) const {
+    return codec::serialize(*this, it);
+}
+
 bool operator==(const mask_write_register_response& lhs,
                 const mask_write_register_response& rhs);
 
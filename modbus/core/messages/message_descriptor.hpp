@@ -0,0 +1,292 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "modbus/core/endian.hpp"
+#include "modbus/core/types.hpp"
+
+namespace modbus {
+
+/**
+ * @brief Describes the layout of a message on the wire.
+ *
+ * @section Every message specializes message_descriptor with:
+ * - function_code: The function code of the message.
+ * - type: Whether the message is a request or a response.
+ * - max_quantity: The largest number of payload elements allowed, or of
+ *   values a read may request, or 0 if the message has neither a payload nor
+ *   a quantity field.
+ * - payload_type: uint8_t for packed bits or raw register bytes, uint16_t for
+ *   registers, or void if the message has no payload.
+ * - layout: A message_layout listing the fields in the order they are sent.
+ *
+ * size(), serialize() and the parsing constructor of each message are generated
+ * from the descriptor by message_codec.
+ */
+template <typename T> struct message_descriptor;
+
+namespace fields {
+
+/// A single byte. Enums with an underlying type of uint8_t are cast.
+template <auto Member> struct u8 {
+    static constexpr bool is_fixed = true;
+    static constexpr size_t fixed_size = 1;
+
+    template <typename T> static constexpr size_t size(const T&) noexcept {
+        return fixed_size;
+    }
+
+    template <typename T>
+    static constexpr uint8_t* write(const T& m, uint8_t* it) noexcept {
+        *it++ = (uint8_t)(m.*Member);
+        return it;
+    }
+
+    template <typename T>
+    static constexpr const uint8_t* read(T& m, const uint8_t* it) noexcept {
+        using value_t = std::remove_cvref_t<decltype(m.*Member)>;
+        m.*Member = (value_t)*it++;
+        return it;
+    }
+};
+
+/// The function code of the message, taken from T::function_code().
+struct function_code {
+    static constexpr bool is_fixed = true;
+    static constexpr size_t fixed_size = 1;
+
+    template <typename T> static constexpr size_t size(const T&) noexcept {
+        return fixed_size;
+    }
+
+    template <typename T>
+    static constexpr uint8_t* write(const T&, uint8_t* it) noexcept {
+        *it++ = (uint8_t)T::function_code();
+        return it;
+    }
+
+    template <typename T>
+    static constexpr const uint8_t* read(T&, const uint8_t* it) noexcept {
+        return it + 1;
+    }
+};
+
+/// The function code of an exception response, which has its high bit set.
+template <auto Member> struct exception_function_code {
+    static constexpr bool is_fixed = true;
+    static constexpr size_t fixed_size = 1;
+
+    template <typename T> static constexpr size_t size(const T&) noexcept {
+        return fixed_size;
+    }
+
+    template <typename T>
+    static constexpr uint8_t* write(const T& m, uint8_t* it) noexcept {
+        *it++ = ((uint8_t)(m.*Member)) | 0x80;
+        return it;
+    }
+
+    template <typename T>
+    static constexpr const uint8_t* read(T& m, const uint8_t* it) noexcept {
+        m.*Member = (function_code_t)(*it++ & 0x7F);
+        return it;
+    }
+};
+
+/// A 16-bit value in big-endian byte order.
+template <auto Member> struct u16 {
+    static constexpr bool is_fixed = true;
+    static constexpr size_t fixed_size = 2;
+
+    template <typename T> static constexpr size_t size(const T&) noexcept {
+        return fixed_size;
+    }
+
+    template <typename T>
+    static constexpr uint8_t* write(const T& m, uint8_t* it) noexcept {
+        *it++ = (uint8_t)((m.*Member) >> 8);
+        *it++ = (uint8_t)((m.*Member) & 0x00FF);
+        return it;
+    }
+
+    template <typename T>
+    static constexpr const uint8_t* read(T& m, const uint8_t* it) noexcept {
+        m.*Member = (uint16_t)((it[0] << 8) | it[1]);
+        return it + 2;
+    }
+};
+
+/// A coil status, sent as 0xFF00 for on and 0x0000 for off.
+template <auto Member> struct coil {
+    static constexpr bool is_fixed = true;
+    static constexpr size_t fixed_size = 2;
+
+    template <typename T> static constexpr size_t size(const T&) noexcept {
+        return fixed_size;
+    }
+
+    template <typename T>
+    static constexpr uint8_t* write(const T& m, uint8_t* it) noexcept {
+        *it++ = (m.*Member) ? 0xFF : 0x00;
+        *it++ = 0x00;
+        return it;
+    }
+
+    template <typename T>
+    static constexpr const uint8_t* read(T& m, const uint8_t* it) noexcept {
+        uint16_t value = (uint16_t)((it[0] << 8) | it[1]);
+        m.*Member = ((coil_status_t)value == coil_status_t::on);
+        return it + 2;
+    }
+};
+
+/// A byte count followed by that many bytes.
+template <auto Member> struct byte_payload {
+    static constexpr bool is_fixed = false;
+    static constexpr size_t fixed_size = 1;
+
+    template <typename T> static constexpr size_t size(const T& m) noexcept {
+        return fixed_size + (m.*Member).size();
+    }
+
+    template <typename T>
+    static constexpr uint8_t* write(const T& m, uint8_t* it) noexcept {
+        const auto& values = m.*Member;
+        *it++ = (uint8_t)values.size();
+        return std::copy(values.begin(), values.end(), it);
+    }
+
+    template <typename T>
+    static const uint8_t* read(T& m, const uint8_t* it) {
+        uint8_t byteCount = *it++;
+        (m.*Member).assign(it, it + byteCount);
+        return it + byteCount;
+    }
+};
+
+/// A byte count followed by 16-bit registers in big-endian byte order.
+template <auto Member> struct register_payload {
+    static constexpr bool is_fixed = false;
+    static constexpr size_t fixed_size = 1;
+
+    template <typename T> static constexpr size_t size(const T& m) noexcept {
+        return fixed_size + (m.*Member).size() * sizeof(uint16_t);
+    }
+
+    template <typename T>
+    static uint8_t* write(const T& m, uint8_t* it) noexcept {
+        const auto& values = m.*Member;
+        *it++ = (uint8_t)(values.size() * sizeof(uint16_t));
+        return store_registers(values, it);
+    }
+
+    template <typename T>
+    static const uint8_t* read(T& m, const uint8_t* it) {
+        uint8_t byteCount = *it++;
+        auto& values = m.*Member;
+        values.resize(byteCount / 2);
+        return load_registers(it, values) + (byteCount % 2);
+    }
+};
+
+} // namespace fields
+
+/**
+ * @brief The ordered list of fields of a message, starting with the unit ID.
+ */
+template <typename... Fields> struct message_layout {
+    /// Whether or not every message of this type has the same size.
+    static constexpr bool is_fixed = (Fields::is_fixed && ...);
+
+    /// The size of the fields that precede the payload, including the byte
+    /// count if the message has a payload.
+    static constexpr size_t header_size = (Fields::fixed_size + ...);
+
+    template <typename T> static constexpr size_t size(const T& m) noexcept {
+        return (Fields::size(m) + ...);
+    }
+
+    template <typename T>
+    static constexpr uint8_t* serialize(const T& m, uint8_t* it) noexcept {
+        ((it = Fields::write(m, it)), ...);
+        return it;
+    }
+
+    template <typename T>
+    static constexpr const uint8_t* parse(T& m, const uint8_t* it) {
+        ((it = Fields::read(m, it)), ...);
+        return it;
+    }
+};
+
+/**
+ * @return Whether the function code and type in the message_descriptor of T
+ * are the ones T reports. Exception responses carry their function code in
+ * each message and describe only their type.
+ */
+template <typename T> consteval bool descriptor_matches() {
+    using descriptor = message_descriptor<T>;
+    if constexpr (requires { descriptor::function_code; }) {
+        if (descriptor::function_code != T::function_code()) {
+            return false;
+        }
+    }
+    return descriptor::type == T::type();
+}
+
+/**
+ * @brief Encodes, decodes and sizes a message from its message_descriptor.
+ */
+template <typename T> struct message_codec {
+    using descriptor = message_descriptor<T>;
+    using layout = typename descriptor::layout;
+
+    static_assert(descriptor_matches<T>(),
+                  "message_descriptor<T> does not match T::function_code() "
+                  "and T::type()");
+
+    /**
+     * @return The size of every message of type T. Only available for messages
+     * without a payload.
+     */
+    static constexpr size_t size() noexcept
+        requires layout::is_fixed
+    {
+        return layout::header_size;
+    }
+
+    /**
+     * @return The size of message on the wire.
+     */
+    static constexpr size_t size(const T& message) noexcept {
+        if constexpr (layout::is_fixed) {
+            return layout::header_size;
+        } else {
+            return layout::size(message);
+        }
+    }
+
+    /**
+     * @brief Writes message to it. The caller must ensure there are at least
+     * size(message) bytes available.
+     * @return An iterator one past the last byte written.
+     */
+    static constexpr uint8_t* serialize(const T& message,
+                                        uint8_t* it) noexcept {
+        return layout::serialize(message, it);
+    }
+
+    /**
+     * @brief Reads message from it. The bytes must have been validated, for
+     * example with validate_pdu.
+     * @return An iterator one past the last byte read.
+     */
+    static constexpr const uint8_t* parse(T& message, const uint8_t* it) {
+        return layout::parse(message, it);
+    }
+};
+
+} // namespace modbus
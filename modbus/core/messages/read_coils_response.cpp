@@ -1,5 +1,7 @@
 #include "modbus/core/messages/read_coils_response.hpp"
 
+#include "modbus/core/bit_pack.hpp"
+
 namespace modbus {
 
 read_coils_response::read_coils_response(uint8_t unit_id,
@@ -8,27 +10,12 @@ read_coils_response::read_coils_response(uint8_t unit_id,
     this->values = values;
 }
 
-read_coils_response::read_coils_response(const_buffer_iterator it) {
-    unit_id = *it++;
-    it++; // skip function code
-
-    uint8_t byteCount = *it++;
-    values.resize(byteCount);
-    for (int i = 0; i < byteCount; i++) {
-        values[i] = *it++;
-    }
-}
-
-buffer_iterator read_coils_response::serialize(buffer_iterator it) const {
-    *it++ = unit_id;
-    *it++ = (uint8_t)this->function_code();
-    *it++ = (uint8_t)values.size();
-
-    for (auto byte : values) {
-        *it++ = byte;
-    }
+read_coils_response::read_coils_response(uint8_t unit_id,
+                                         std::span<const bool> values) {
+    this->unit_id = unit_id;
 
-    return it;
+    this->values.resize((values.size() + 7) / 8);
+    pack_bits(values, this->values.data());
 }
 
 bool operator==(const read_coils_response& lhs,
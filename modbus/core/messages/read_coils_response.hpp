@@ -1,8 +1,10 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
 #include <vector>
 
+#include "modbus/core/messages/message_descriptor.hpp"
 #include "modbus/core/types.hpp"
 
 namespace modbus {
@@ -19,7 +21,12 @@ struct read_coils_response {
 
     read_coils_response(uint8_t unit_id, std::vector<uint8_t> values);
 
-    read_coils_response(const_buffer_iterator it);
+    read_coils_response(uint8_t unit_id, std::span<const bool> values);
+
+    read_coils_response(const_buffer_iterator it)
+        : read_coils_response(std::to_address(it)) {}
+
+    read_coils_response(const uint8_t* it);
 
     static constexpr function_code_t function_code() {
         return function_code_t::read_coils;
@@ -29,15 +36,40 @@ struct read_coils_response {
         return message_type::response;
     }
 
-    size_t size() {
-        return sizeof(unit_id) + sizeof(uint8_t) + // Function Code
-               sizeof(uint8_t) +                   // Byte Count
-               sizeof(uint8_t) * values.size();
+    using codec = message_codec<read_coils_response>;
+
+    size_t size() const;
+
+    buffer_iterator serialize(buffer_iterator it) const {
+        return it + (serialize(std::to_address(it)) - std::to_address(it));
     }
 
-    buffer_iterator serialize(buffer_iterator it) const;
+    uint8_t* serialize(uint8_t* it) const;
+};
+
+template <> struct message_descriptor<read_coils_response> {
+    using self = read_coils_response;
+
+    static constexpr function_code_t function_code =
+        function_code_t::read_coils;
+    static constexpr message_type type = message_type::response;
+    static constexpr uint16_t max_quantity = MAX_READ_BITS;
+    using payload_type = uint8_t;
+    using layout = message_layout<fields::u8<&self::unit_id>,
+                                  fields::function_code,
+                                  fields::byte_payload<&self::values>>;
 };
 
+inline read_coils_response::read_coils_response(const uint8_t* it) {
+    codec::parse(*this, it);
+}
+
+inline size_t read_coils_response::size() const { return codec::size(*this); }
+
+inline uint8_t* read_coils_response::serialize(uint8_t* it) const {
+    return codec::serialize(*this, it);
+}
+
 bool operator==(const read_coils_response& lhs, const read_coils_response& rhs);
 
 bool operator!=(const read_coils_response& lhs, const read_coils_response& rhs);
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <vector>
 
+#include "modbus/core/messages/message_descriptor.hpp"
 #include "modbus/core/types.hpp"
 
 namespace modbus {
@@ -21,7 +22,10 @@ struct read_discrete_inputs_request {
     read_discrete_inputs_request(uint8_t unit_id, uint16_t start_address,
                                  uint16_t length);
 
-    read_discrete_inputs_request(const_buffer_iterator it);
+    read_discrete_inputs_request(const_buffer_iterator it)
+        : read_discrete_inputs_request(std::to_address(it)) {}
+
+    read_discrete_inputs_request(const uint8_t* it);
 
     static constexpr function_code_t function_code() {
         return function_code_t::read_discrete_inputs;
@@ -29,14 +33,43 @@ struct read_discrete_inputs_request {
 
     static constexpr message_type type() { return message_type::request; }
 
-    static constexpr size_t size() {
-        return sizeof(unit_id) + sizeof(uint8_t) + // function code
-               sizeof(start_address) + sizeof(length);
+    using codec = message_codec<read_discrete_inputs_request>;
+
+    static constexpr size_t size();
+
+    buffer_iterator serialize(buffer_iterator it) const {
+        return it + (serialize(std::to_address(it)) - std::to_address(it));
     }
 
-    buffer_iterator serialize(buffer_iterator it) const;
+    uint8_t* serialize(uint8_t* it) const;
+};
+
+template <> struct message_descriptor<read_discrete_inputs_request> {
+    using self = read_discrete_inputs_request;
+
+    static constexpr function_code_t function_code =
+        function_code_t::read_discrete_inputs;
+    static constexpr message_type type = message_type::request;
+    static constexpr uint16_t max_quantity = MAX_READ_BITS;
+    using payload_type = void;
+    using layout = message_layout<fields::u8<&self::unit_id>,
+                                  fields::function_code,
+                                  fields::u16<&self::start_address>,
+                                  fields::u16<&self::length>>;
 };
 
+inline read_discrete_inputs_request::read_discrete_inputs_request(
+    const uint8_t* it) {
+    codec::parse(*this, it);
+}
+
+constexpr size_t read_discrete_inputs_request::size() { return codec::size(); }
+
+inline uint8_t* read_discrete_inputs_request::serialize(uint8_t* it) const {
+    return codec::serialize(*this, it);
+}
+
+
 inline bool operator==(const read_discrete_inputs_request& lhs,
                        const read_discrete_inputs_request& rhs) {
     return (lhs.unit_id == rhs.unit_id &&
@@ -1,5 +1,7 @@
 #include "modbus/core/messages/read_discrete_inputs_response.hpp"
 
+#include "modbus/core/bit_pack.hpp"
+
 namespace modbus {
 
 read_discrete_inputs_response::read_discrete_inputs_response(uint8_t unit_id,
@@ -9,28 +11,11 @@ read_discrete_inputs_response::read_discrete_inputs_response(uint8_t unit_id,
 }
 
 read_discrete_inputs_response::read_discrete_inputs_response(
-    const_buffer_iterator it) {
-    unit_id = *it++;
-    it++; // skip function code
-
-    uint8_t byteCount = *it++;
-    inputs.resize(byteCount);
-    for (int i = 0; i < byteCount; i++) {
-        inputs[i] = *it++;
-    }
-}
-
-buffer_iterator
-read_discrete_inputs_response::serialize(buffer_iterator it) const {
-    *it++ = unit_id;
-    *it++ = (uint8_t)this->function_code();
-    *it++ = (uint8_t)inputs.size();
-
-    for (auto byte : inputs) {
-        *it++ = byte;
-    }
+    uint8_t unit_id, std::span<const bool> inputs) {
+    this->unit_id = unit_id;
 
-    return it;
+    this->inputs.resize((inputs.size() + 7) / 8);
+    pack_bits(inputs, this->inputs.data());
 }
 
 bool operator==(const read_discrete_inputs_response& lhs,
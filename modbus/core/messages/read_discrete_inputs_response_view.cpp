@@ -0,0 +1,29 @@
+#include "modbus/core/messages/read_discrete_inputs_response_view.hpp"
+
+#include <stdexcept>
+
+namespace modbus {
+
+read_discrete_inputs_response_view::read_discrete_inputs_response_view(
+    std::span<const uint8_t> pdu) {
+    // unit id, function code and byte count
+    constexpr size_t headerSize = 3;
+    if (pdu.size() < headerSize) {
+        throw std::out_of_range("PDU is smaller than the header.");
+    }
+
+    if (pdu[1] != (uint8_t)function_code()) {
+        throw std::invalid_argument("Function code does not match.");
+    }
+
+    unit_id = pdu[0];
+
+    uint8_t numBytes = pdu[2];
+    if (pdu.size() - headerSize != numBytes) {
+        throw std::out_of_range("Byte count does not match the length of the PDU.");
+    }
+
+    inputs = coil_span(pdu.subspan(headerSize, numBytes));
+}
+
+} // namespace modbus
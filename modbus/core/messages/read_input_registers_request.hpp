@@ -1,5 +1,6 @@
 #pragma once
 
+#include "modbus/core/messages/message_descriptor.hpp"
 #include "modbus/core/types.hpp"
 
 namespace modbus {
@@ -18,7 +19,10 @@ struct read_input_registers_request {
     read_input_registers_request(uint8_t unit_id, uint16_t start_address,
                                  uint16_t length);
 
-    read_input_registers_request(const_buffer_iterator it);
+    read_input_registers_request(const_buffer_iterator it)
+        : read_input_registers_request(std::to_address(it)) {}
+
+    read_input_registers_request(const uint8_t* it);
 
     static constexpr function_code_t function_code() {
         return function_code_t::read_input_registers;
@@ -26,14 +30,42 @@ struct read_input_registers_request {
 
     static constexpr message_type type() { return message_type::request; }
 
-    static constexpr size_t size() {
-        return sizeof(unit_id) + sizeof(uint8_t) + sizeof(start_address) +
-               sizeof(length);
+    using codec = message_codec<read_input_registers_request>;
+
+    static constexpr size_t size();
+
+    buffer_iterator serialize(buffer_iterator it) const {
+        return it + (serialize(std::to_address(it)) - std::to_address(it));
     }
 
-    buffer_iterator serialize(buffer_iterator it) const;
+    uint8_t* serialize(uint8_t* it) const;
 };
 
+template <> struct message_descriptor<read_input_registers_request> {
+    using self = read_input_registers_request;
+
+    static constexpr function_code_t function_code =
+        function_code_t::read_input_registers;
+    static constexpr message_type type = message_type::request;
+    static constexpr uint16_t max_quantity = MAX_READ_REGISTERS;
+    using payload_type = void;
+    using layout = message_layout<fields::u8<&self::unit_id>,
+                                  fields::function_code,
+                                  fields::u16<&self::start_address>,
+                                  fields::u16<&self::length>>;
+};
+
+inline read_input_registers_request::read_input_registers_request(
+    const uint8_t* it) {
+    codec::parse(*this, it);
+}
+
+constexpr size_t read_input_registers_request::size() { return codec::size(); }
+
+inline uint8_t* read_input_registers_request::serialize(uint8_t* it) const {
+    return codec::serialize(*this, it);
+}
+
 bool operator==(const read_input_registers_request& lhs,
                 const read_input_registers_request& rhs);
 
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "modbus/core/register_span.hpp"
+#include "modbus/core/types.hpp"
+
+namespace modbus {
+
+/**
+ * @brief A non-owning view of a Read Input Registers response as defined by the
+ * MODBUS standard.
+ *
+ * @section The view validates the PDU once on construction and references the
+ * payload in place. It is only valid for as long as the underlying buffer.
+ */
+struct read_input_registers_response_view {
+    uint8_t unit_id;
+    register_span values;
+
+    read_input_registers_response_view() = default;
+
+    /**
+     * @brief Creates a view over the PDU.
+     * @param pdu The bytes of the PDU starting at the unit id.
+     * @throws std::out_of_range if the PDU is shorter or longer than the byte
+     * count states.
+     * @throws std::invalid_argument if the function code or the byte count
+     * is invalid.
+     */
+    explicit read_input_registers_response_view(std::span<const uint8_t> pdu);
+
+    static constexpr function_code_t function_code() {
+        return function_code_t::read_input_registers;
+    }
+
+    static constexpr message_type type() { return message_type::response; }
+
+    size_t size() const {
+        return sizeof(unit_id) + sizeof(uint8_t) + // Function Code
+               sizeof(uint8_t) +                   // Byte Count
+               values.bytes().size();
+    }
+};
+
+} // namespace modbus
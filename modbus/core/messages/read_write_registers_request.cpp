@@ -13,55 +13,6 @@ read_write_registers_request::read_write_registers_request(
     this->values = values;
 }
 
-read_write_registers_request::read_write_registers_request(
-    const_buffer_iterator it) {
-    unit_id = *it++;
-    it++; // skip function code
-    read_start_address = *it++ << 8;
-    read_start_address += *it++;
-    read_num_registers = *it++ << 8;
-    read_num_registers += *it++;
-    write_start_address = *it++ << 8;
-    write_start_address += *it++;
-    write_num_registers = *it++ << 8;
-    write_num_registers += *it++;
-
-    // Get number of bytes remaining
-    uint8_t numBytes = *it++;
-    int rvElements = numBytes / 2; // Each value is two bytes
-    values.resize(rvElements);
-
-    for (int i = 0; i < rvElements; i++) {
-        values[i] = *it++ << 8;
-        values[i] += *it++;
-    }
-
-    write_num_registers = values.size();
-}
-
-buffer_iterator
-read_write_registers_request::serialize(buffer_iterator it) const {
-    *it++ = unit_id;
-    *it++ = (uint8_t)this->function_code();
-    *it++ = read_start_address >> 8;
-    *it++ = read_start_address & 0x00FF;
-    *it++ = read_num_registers >> 8;
-    *it++ = read_num_registers & 0x00FF;
-    *it++ = write_start_address >> 8;
-    *it++ = write_start_address & 0x00FF;
-    *it++ = write_num_registers >> 8;
-    *it++ = write_num_registers & 0x00FF;
-
-    // serialize the data
-    *it++ = (uint8_t)(values.size() * sizeof(uint16_t)); // byte count
-    for (auto word : values) {
-        *it++ = word >> 8;
-        *it++ = word & 0x00FF;
-    }
-
-    return it;
-}
-
 bool operator==(const read_write_registers_request& lhs,
                 const read_write_registers_request& rhs) {
     return (lhs.unit_id == rhs.unit_id &&
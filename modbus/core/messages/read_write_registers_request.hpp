@@ -1,5 +1,6 @@
 #pragma once
 
+#include "modbus/core/messages/message_descriptor.hpp"
 #include "modbus/core/types.hpp"
 
 namespace modbus {
@@ -23,7 +24,10 @@ struct read_write_registers_request {
                                  uint16_t write_start_address,
                                  std::vector<uint16_t> values);
 
-    read_write_registers_request(const_buffer_iterator it);
+    read_write_registers_request(const_buffer_iterator it)
+        : read_write_registers_request(std::to_address(it)) {}
+
+    read_write_registers_request(const uint8_t* it);
 
     static constexpr function_code_t function_code() {
         return function_code_t::read_write_multiple_registers;
@@ -31,17 +35,48 @@ struct read_write_registers_request {
 
     static constexpr message_type type() { return message_type::request; }
 
-    size_t size() {
-        return sizeof(unit_id) + sizeof(uint8_t) + // function code
-               sizeof(read_start_address) + sizeof(read_num_registers) +
-               sizeof(write_start_address) + sizeof(write_num_registers) +
-               sizeof(uint8_t) + // byte count of values
-               sizeof(uint16_t) * values.size();
+    using codec = message_codec<read_write_registers_request>;
+
+    size_t size() const;
+
+    buffer_iterator serialize(buffer_iterator it) const {
+        return it + (serialize(std::to_address(it)) - std::to_address(it));
     }
 
-    buffer_iterator serialize(buffer_iterator it) const;
+    uint8_t* serialize(uint8_t* it) const;
 };
 
+template <> struct message_descriptor<read_write_registers_request> {
+    using self = read_write_registers_request;
+
+    static constexpr function_code_t function_code =
+        function_code_t::read_write_multiple_registers;
+    static constexpr message_type type = message_type::request;
+    static constexpr uint16_t max_quantity = MAX_READ_WRITE_REGISTERS;
+    using payload_type = uint16_t;
+    using layout = message_layout<fields::u8<&self::unit_id>,
+                                  fields::function_code,
+                                  fields::u16<&self::read_start_address>,
+                                  fields::u16<&self::read_num_registers>,
+                                  fields::u16<&self::write_start_address>,
+                                  fields::u16<&self::write_num_registers>,
+                                  fields::register_payload<&self::values>>;
+};
+
+inline read_write_registers_request::read_write_registers_request(
+    const uint8_t* it) {
+    codec::parse(*this, it);
+    write_num_registers = values.size();
+}
+
+inline size_t read_write_registers_request::size() const {
+    return codec::size(*this);
+}
+
+inline uint8_t* read_write_registers_request::serialize(uint8_t* it) const {
+    return codec::serialize(*this, it);
+}
+
 bool operator==(const read_write_registers_request& lhs,
                 const read_write_registers_request& rhs);
 
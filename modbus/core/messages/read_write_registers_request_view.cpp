@@ -0,0 +1,43 @@
+#include "modbus/core/messages/read_write_registers_request_view.hpp"
+
+#include <stdexcept>
+
+namespace modbus {
+
+read_write_registers_request_view::read_write_registers_request_view(
+    std::span<const uint8_t> pdu) {
+    // unit id, function code, read and write addresses and quantities and
+    // byte count
+    constexpr size_t headerSize = 11;
+    if (pdu.size() < headerSize) {
+        throw std::out_of_range("PDU is smaller than the header.");
+    }
+
+    if (pdu[1] != (uint8_t)function_code()) {
+        throw std::invalid_argument("Function code does not match.");
+    }
+
+    unit_id = pdu[0];
+    read_start_address = pdu[2] << 8;
+    read_start_address += pdu[3];
+    read_num_registers = pdu[4] << 8;
+    read_num_registers += pdu[5];
+    write_start_address = pdu[6] << 8;
+    write_start_address += pdu[7];
+    write_num_registers = pdu[8] << 8;
+    write_num_registers += pdu[9];
+
+    uint8_t numBytes = pdu[headerSize - 1];
+    if (numBytes != write_num_registers * sizeof(uint16_t)) {
+        throw std::invalid_argument(
+            "Byte count does not match the number of registers.");
+    }
+
+    if (pdu.size() - headerSize != numBytes) {
+        throw std::out_of_range("Byte count does not match the length of the PDU.");
+    }
+
+    values = register_span(pdu.subspan(headerSize, numBytes));
+}
+
+} // namespace modbus
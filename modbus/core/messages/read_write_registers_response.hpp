@@ -1,5 +1,6 @@
 #pragma once
 
+#include "modbus/core/messages/message_descriptor.hpp"
 #include "modbus/core/types.hpp"
 
 namespace modbus {
@@ -17,7 +18,10 @@ struct read_write_registers_response {
     read_write_registers_response(uint8_t unit_id,
                                   std::vector<uint16_t> values);
 
-    read_write_registers_response(const_buffer_iterator it);
+    read_write_registers_response(const_buffer_iterator it)
+        : read_write_registers_response(std::to_address(it)) {}
+
+    read_write_registers_response(const uint8_t* it);
 
     static constexpr function_code_t function_code() {
         return function_code_t::read_write_multiple_registers;
@@ -25,15 +29,43 @@ struct read_write_registers_response {
 
     static constexpr message_type type() { return message_type::response; }
 
-    size_t size() {
-        return sizeof(unit_id) + sizeof(uint8_t) + // Function Code
-               sizeof(uint8_t) +                   // Byte Count
-               sizeof(uint16_t) * values.size();
+    using codec = message_codec<read_write_registers_response>;
+
+    size_t size() const;
+
+    buffer_iterator serialize(buffer_iterator it) const {
+        return it + (serialize(std::to_address(it)) - std::to_address(it));
     }
 
-    buffer_iterator serialize(buffer_iterator it) const;
+    uint8_t* serialize(uint8_t* it) const;
 };
 
+template <> struct message_descriptor<read_write_registers_response> {
+    using self = read_write_registers_response;
+
+    static constexpr function_code_t function_code =
+        function_code_t::read_write_multiple_registers;
+    static constexpr message_type type = message_type::response;
+    static constexpr uint16_t max_quantity = MAX_READ_REGISTERS;
+    using payload_type = uint16_t;
+    using layout = message_layout<fields::u8<&self::unit_id>,
+                                  fields::function_code,
+                                  fields::register_payload<&self::values>>;
+};
+
+inline read_write_registers_response::read_write_registers_response(
+    const uint8_t* it) {
+    codec::parse(*this, it);
+}
+
+inline size_t read_write_registers_response::size() const {
+    return codec::size(*this);
+}
+
+inline uint8_t* read_write_registers_response::serialize(uint8_t* it) const {
+    return codec::serialize(*this, it);
+}
+
 bool operator==(const read_write_registers_response& lhs,
                 const read_write_registers_response& rhs);
 
@@ -1,5 +1,10 @@
 #include "modbus/core/messages/write_multiple_coils_request.hpp"
 
+#include <algorithm>
+#include <array>
+
+#include "modbus/core/bit_pack.hpp"
+
 namespace modbus {
 
 write_multiple_coils_request::write_multiple_coils_request(
@@ -17,56 +22,28 @@ write_multiple_coils_request::write_multiple_coils_request(
     this->start_address = start_address;
     this->length = (uint16_t)values.size();
 
-    uint16_t numBytes = (uint16_t)length / 8;
-
-    // if there's overflow, add one byte
-    if (length % 8) {
-        numBytes++;
-    }
-
-    this->values.resize(numBytes);
-    int boolNumber = 0;
-
-    for (auto value : values) {
-        if (value) {
-            this->values[boolNumber / 8] |= 1 << (boolNumber % 8);
-        }
-        boolNumber++;
+    this->values.resize((values.size() + 7) / 8);
+
+    // std::vector<bool> does not expose its storage so the bits are copied
+    // into a contiguous block and packed from there
+    std::array<bool, MAX_WRITE_BITS> bits;
+    uint8_t* to = this->values.data();
+    for (auto from = values.begin(); from != values.end();) {
+        size_t count = std::min<size_t>(values.end() - from, bits.size());
+        std::copy_n(from, count, bits.begin());
+        to = pack_bits(std::span<const bool>(bits.data(), count), to);
+        from += count;
     }
 }
 
 write_multiple_coils_request::write_multiple_coils_request(
-    const_buffer_iterator it) {
-    unit_id = *it++;
-    it++; // skip function code
-    start_address = *it++ << 8;
-    start_address += *it++;
-    length = *it++ << 8;
-    length += *it++;
-
-    uint8_t numBytes = *it++;
-    values.resize(numBytes);
-    for (int i = 0; i < numBytes; i++) {
-        values[i] = *it++;
-    }
-}
-
-buffer_iterator
-write_multiple_coils_request::serialize(buffer_iterator it) const {
-    *it++ = unit_id;
-    *it++ = (uint8_t)this->function_code();
-    *it++ = start_address >> 8;
-    *it++ = start_address & 0x00FF;
-    *it++ = length >> 8;
-    *it++ = length & 0x00FF;
-
-    // serialize the data
-    *it++ = (uint8_t)values.size();
-    for (auto byte : values) {
-        *it++ = byte;
-    }
+    uint8_t unit_id, uint16_t start_address, std::span<const bool> values) {
+    this->unit_id = unit_id;
+    this->start_address = start_address;
+    this->length = (uint16_t)values.size();
 
-    return it;
+    this->values.resize((values.size() + 7) / 8);
+    pack_bits(values, this->values.data());
 }
 
 bool operator==(const write_multiple_coils_request& lhs,
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <span>
+
+#include "modbus/core/messages/message_descriptor.hpp"
 #include "modbus/core/types.hpp"
 
 namespace modbus {
@@ -22,7 +25,13 @@ struct write_multiple_coils_request {
     write_multiple_coils_request(uint8_t unit_id, uint16_t start_address,
                                  std::vector<bool> values);
 
-    write_multiple_coils_request(const_buffer_iterator it);
+    write_multiple_coils_request(uint8_t unit_id, uint16_t start_address,
+                                 std::span<const bool> values);
+
+    write_multiple_coils_request(const_buffer_iterator it)
+        : write_multiple_coils_request(std::to_address(it)) {}
+
+    write_multiple_coils_request(const uint8_t* it);
 
     static constexpr function_code_t function_code() {
         return function_code_t::write_multiple_coils;
@@ -30,17 +39,45 @@ struct write_multiple_coils_request {
 
     static constexpr message_type type() { return message_type::request; }
 
-    size_t size() {
-        return sizeof(unit_id) + sizeof(uint8_t) + // Function code
-               sizeof(start_address) + sizeof(length) +
-               sizeof(uint8_t) + // The number of data bytes in the
-                                 // values array
-               sizeof(uint8_t) * values.size();
+    using codec = message_codec<write_multiple_coils_request>;
+
+    size_t size() const;
+
+    buffer_iterator serialize(buffer_iterator it) const {
+        return it + (serialize(std::to_address(it)) - std::to_address(it));
     }
 
-    buffer_iterator serialize(buffer_iterator it) const;
+    uint8_t* serialize(uint8_t* it) const;
 };
 
+template <> struct message_descriptor<write_multiple_coils_request> {
+    using self = write_multiple_coils_request;
+
+    static constexpr function_code_t function_code =
+        function_code_t::write_multiple_coils;
+    static constexpr message_type type = message_type::request;
+    static constexpr uint16_t max_quantity = MAX_WRITE_BITS;
+    using payload_type = uint8_t;
+    using layout = message_layout<fields::u8<&self::unit_id>,
+                                  fields::function_code,
+                                  fields::u16<&self::start_address>,
+                                  fields::u16<&self::length>,
+                                  fields::byte_payload<&self::values>>;
+};
+
+inline write_multiple_coils_request::write_multiple_coils_request(
+    const uint8_t* it) {
+    codec::parse(*this, it);
+}
+
+inline size_t write_multiple_coils_request::size() const {
+    return codec::size(*this);
+}
+
+inline uint8_t* write_multiple_coils_request::serialize(uint8_t* it) const {
+    return codec::serialize(*this, it);
+}
+
 bool operator==(const write_multiple_coils_request& lhs,
                 const write_multiple_coils_request& rhs);
 
@@ -9,28 +9,6 @@ write_multiple_coils_response::write_multiple_coils_response(
     this->length = length;
 }
 
-write_multiple_coils_response::write_multiple_coils_response(
-    const_buffer_iterator it) {
-    unit_id = *it++;
-    it++; // skip function code
-    start_address = *it++ << 8;
-    start_address += *it++;
-    length = *it++ << 8;
-    length += *it++;
-}
-
-buffer_iterator
-write_multiple_coils_response::serialize(buffer_iterator it) const {
-    *it++ = unit_id;
-    *it++ = (uint8_t)this->function_code();
-    *it++ = start_address >> 8;
-    *it++ = start_address & 0x00FF;
-    *it++ = length >> 8;
-    *it++ = length & 0x00FF;
-
-    return it;
-}
-
 bool operator==(const write_multiple_coils_response& lhs,
                 const write_multiple_coils_response& rhs) {
     return (lhs.unit_id == rhs.unit_id &&
@@ -0,0 +1,38 @@
+#include "modbus/core/messages/write_multiple_registers_request_view.hpp"
+
+#include <stdexcept>
+
+namespace modbus {
+
+write_multiple_registers_request_view::write_multiple_registers_request_view(
+    std::span<const uint8_t> pdu) {
+    // unit id, function code, address, quantity and byte count
+    constexpr size_t headerSize = 7;
+    if (pdu.size() < headerSize) {
+        throw std::out_of_range("PDU is smaller than the header.");
+    }
+
+    if (pdu[1] != (uint8_t)function_code()) {
+        throw std::invalid_argument("Function code does not match.");
+    }
+
+    unit_id = pdu[0];
+    start_address = pdu[2] << 8;
+    start_address += pdu[3];
+    length = pdu[4] << 8;
+    length += pdu[5];
+
+    uint8_t numBytes = pdu[headerSize - 1];
+    if (numBytes != length * sizeof(uint16_t)) {
+        throw std::invalid_argument(
+            "Byte count does not match the number of registers.");
+    }
+
+    if (pdu.size() - headerSize != numBytes) {
+        throw std::out_of_range("Byte count does not match the length of the PDU.");
+    }
+
+    values = register_span(pdu.subspan(headerSize, numBytes));
+}
+
+} // namespace modbus
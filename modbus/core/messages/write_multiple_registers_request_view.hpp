@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "modbus/core/register_span.hpp"
+#include "modbus/core/types.hpp"
+
+namespace modbus {
+
+/**
+ * @brief A non-owning view of a Write Multiple Registers request as defined by
+ * the MODBUS standard.
+ *
+ * @section The view validates the PDU once on construction and references the
+ * payload in place. It is only valid for as long as the underlying buffer.
+ */
+struct write_multiple_registers_request_view {
+    uint8_t unit_id;
+    uint16_t start_address;
+    uint16_t length;
+    register_span values;
+
+    write_multiple_registers_request_view() = default;
+
+    /**
+     * @brief Creates a view over the PDU.
+     * @param pdu The bytes of the PDU starting at the unit id.
+     * @throws std::out_of_range if the PDU is shorter or longer than the byte
+     * count states.
+     * @throws std::invalid_argument if the function code or the byte count
+     * is invalid.
+     */
+    explicit write_multiple_registers_request_view(
+        std::span<const uint8_t> pdu);
+
+    static constexpr function_code_t function_code() {
+        return function_code_t::write_multiple_registers;
+    }
+
+    static constexpr message_type type() { return message_type::request; }
+
+    size_t size() const {
+        return sizeof(unit_id) + sizeof(uint8_t) + // Function code
+               sizeof(start_address) + sizeof(length) +
+               sizeof(uint8_t) + // Byte count
+               values.bytes().size();
+    }
+};
+
+} // namespace modbus
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "modbus/core/messages/message_descriptor.hpp"
 #include "modbus/core/types.hpp"
 
 namespace modbus {
@@ -18,7 +19,10 @@ struct write_single_register_response {
     write_single_register_response(uint8_t unit_id, uint16_t start_address,
                                    uint16_t value);
 
-    write_single_register_response(const_buffer_iterator it);
+    write_single_register_response(const_buffer_iterator it)
+        : write_single_register_response(std::to_address(it)) {}
+
+    write_single_register_response(const uint8_t* it);
 
     static constexpr function_code_t function_code() {
         return function_code_t::write_single_register;
@@ -26,14 +30,44 @@ struct write_single_register_response {
 
     static constexpr message_type type() { return message_type::response; }
 
-    static constexpr size_t size() {
-        return sizeof(unit_id) + sizeof(uint8_t) + sizeof(start_address) +
-               sizeof(value);
+    using codec = message_codec<write_single_register_response>;
+
+    static constexpr size_t size();
+
+    buffer_iterator serialize(buffer_iterator it) const {
+        return it + (serialize(std::to_address(it)) - std::to_address(it));
     }
 
-    buffer_iterator serialize(buffer_iterator it) const;
+    uint8_t* serialize(uint8_t* it) const;
 };
 
+template <> struct message_descriptor<write_single_register_response> {
+    using self = write_single_register_response;
+
+    static constexpr function_code_t function_code =
+        function_code_t::write_single_register;
+    static constexpr message_type type = message_type::response;
+    static constexpr uint16_t max_quantity = 0;
+    using payload_type = void;
+    using layout = message_layout<fields::u8<&self::unit_id>,
+                                  fields::function_code,
+                                  fields::u16<&self::start_address>,
+                                  fields::u16<&self::value>>;
+};
+
+inline write_single_register_response::write_single_register_response(
+    const uint8_t* it) {
+    codec::parse(*this, it);
+}
+
+constexpr size_t write_single_register_response::size() {
+    return codec::size();
+}
+
+inline uint8_t* write_single_register_response::serialize(uint8_t* it) const {
+    return codec::serialize(*this, it);
+}
+
 bool operator==(const write_single_register_response& lhs,
                 const write_single_register_response& rhs);
 
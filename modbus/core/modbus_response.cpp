@@ -1,5 +1,7 @@
 #include "modbus/core/modbus_response.hpp"
 
+#include "modbus/core/bit_pack.hpp"
+
 namespace modbus {
 
 modbus_response_t::modbus_response_t()
@@ -50,6 +52,22 @@ bool modbus_response_t::getBool(unsigned int index) {
     return (bool)(data_->at(registerOffset) & mask);
 }
 
+size_t modbus_response_t::getBools(unsigned int index,
+                                   std::span<bool> out) const {
+    if (!isValid()) {
+        return 0;
+    }
+
+    size_t numBits = data_->size() * 8;
+    if (index >= numBits) {
+        return 0;
+    }
+
+    size_t count = std::min(out.size(), numBits - index);
+    unpack_bits(data_->data(), index, out.first(count));
+    return count;
+}
+
 uint8_t modbus_response_t::getUINT8(unsigned int index) const {
     if (!isValid()) {
         return 0;
@@ -5,6 +5,7 @@
 #include <iostream>
 #include <memory>
 #include <optional>
+#include <span>
 
 #include "modbus/core/types.hpp"
 
@@ -77,6 +78,15 @@ class modbus_response_t {
      */
     bool getBool(unsigned int index);
 
+    /**
+     * Unpacks consecutive coils or input statuses into out.
+     * @param index The index of the first coil or input status.
+     * @param out The destination of the statuses.
+     * @return The number of statuses copied. This is less than out.size() if
+     * the data block ends first.
+     */
+    size_t getBools(unsigned int index, std::span<bool> out) const;
+
     /**
      * Puts an unsigned byte into data.
      * @param index The starting byte index in the data block to write into
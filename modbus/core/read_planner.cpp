@@ -0,0 +1,342 @@
+#include "modbus/core/read_planner.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+
+#include "modbus/core/bit_pack.hpp"
+#include "modbus/core/encode.hpp"
+#include "modbus/core/requests.hpp"
+#include "modbus/core/views.hpp"
+
+namespace modbus {
+
+namespace {
+
+bool is_bit_model(data_model_t model) {
+    return model == data_model_t::coil || model == data_model_t::input_status;
+}
+
+/// The number of bytes a response uses for length values of model.
+size_t data_size(data_model_t model, size_t length) {
+    return is_bit_model(model) ? (length + 7) / 8 : length * 2;
+}
+
+/// The largest number of values of model one request reads, never more than
+/// its function code allows.
+uint16_t quantity_limit(data_model_t model, const read_plan_options& options) {
+    return is_bit_model(model)
+               ? std::min<uint16_t>(options.max_bits, MAX_READ_BITS)
+               : std::min<uint16_t>(options.max_registers, MAX_READ_REGISTERS);
+}
+
+/// Calls f with the request that reads the values of read.
+template <typename F> decltype(auto) with_request(const planned_read& read,
+                                                  F&& f) {
+    switch (read.data_model) {
+    case data_model_t::coil:
+        return f(read_coils_request{read.unit_id, read.start_address,
+                                    read.length});
+    case data_model_t::input_status:
+        return f(read_discrete_inputs_request{read.unit_id, read.start_address,
+                                              read.length});
+    case data_model_t::input_register:
+        return f(read_input_registers_request{read.unit_id, read.start_address,
+                                              read.length});
+    default:
+        return f(read_holding_registers_request{
+            read.unit_id, read.start_address, read.length});
+    }
+}
+
+/// Finds the values in a response that is decoded as View.
+template <typename View, auto Values>
+modbus_error_code response_values(tcp_data_unit_view response,
+                                  std::span<const uint8_t>& values) {
+    auto pdu = response.pdu<View>();
+    if (!pdu) {
+        return modbus_error_code::malformed_message;
+    }
+    values = ((*pdu).*Values).bytes();
+    return modbus_error_code::success;
+}
+
+} // namespace
+
+function_code_t planned_read::function_code() const noexcept {
+    switch (data_model) {
+    case data_model_t::coil:
+        return function_code_t::read_coils;
+    case data_model_t::input_status:
+        return function_code_t::read_discrete_inputs;
+    case data_model_t::input_register:
+        return function_code_t::read_input_registers;
+    default:
+        return function_code_t::read_holding_registers;
+    }
+}
+
+tcp_data_unit planned_read::create_request(uint16_t transactionId) const {
+    return with_request(*this, [&](const auto& request) {
+        return tcp_data_unit(transactionId, request);
+    });
+}
+
+size_t planned_read::encode(uint16_t transactionId,
+                            std::span<uint8_t> out) const noexcept {
+    return with_request(*this, [&](const auto& request) {
+        return modbus::encode(transactionId, request, out);
+    });
+}
+
+tag_data::tag_data() noexcept
+    : type_(data_model_t::invalid_data_type)
+    , start_address_(0)
+    , num_values_(0)
+    , bytes_()
+    , first_bit_(0) {}
+
+tag_data::tag_data(data_model_t type, uint16_t start_address,
+                   uint16_t numValues, std::span<const uint8_t> bytes,
+                   size_t firstBit) noexcept
+    : type_(type)
+    , start_address_(start_address)
+    , num_values_(numValues)
+    , bytes_(bytes)
+    , first_bit_(firstBit) {}
+
+bool tag_data::getBool(unsigned int index) const {
+    if (index >= num_values_ || !isValid()) {
+        throw std::out_of_range("the index is outside of the tag");
+    }
+
+    size_t bit = first_bit_ + index;
+    return (bytes_[bit / 8] >> (bit % 8)) & 0x01;
+}
+
+size_t tag_data::getBools(unsigned int index, std::span<bool> out) const {
+    if (index >= num_values_ || !isValid()) {
+        return 0;
+    }
+
+    size_t count = std::min<size_t>(out.size(), num_values_ - index);
+    unpack_bits(bytes_.data(), first_bit_ + index, out.first(count));
+    return count;
+}
+
+std::span<const uint8_t> tag_data::word(size_t offset, size_t size) const {
+    if (!isValid() || offset + size > bytes_.size()) {
+        throw std::out_of_range("the index is outside of the tag");
+    }
+    return bytes_.subspan(offset, size);
+}
+
+uint16_t tag_data::getUINT16(unsigned int index, byte_order order) const {
+    auto bytes = word(sizeof(uint16_t) * index, sizeof(uint16_t));
+    if (order == byte_order::byte_swapped) {
+        return (bytes[1] << 8) | bytes[0];
+    }
+    return (bytes[0] << 8) | bytes[1];
+}
+
+int16_t tag_data::getINT16(unsigned int index, byte_order order) const {
+    return (int16_t)getUINT16(index, order);
+}
+
+uint32_t tag_data::getUINT32(unsigned int index, byte_order order) const {
+    auto bytes = word(sizeof(uint32_t) * index, sizeof(uint32_t));
+    if (order == byte_order::byte_swapped) {
+        return ((uint32_t)bytes[3] << 24) | (bytes[2] << 16) |
+               (bytes[1] << 8) | bytes[0];
+    }
+    return ((uint32_t)bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) |
+           bytes[3];
+}
+
+int32_t tag_data::getINT32(unsigned int index, byte_order order) const {
+    return (int32_t)getUINT32(index, order);
+}
+
+modbus_response_t tag_data::to_response() const {
+    if (!isValid()) {
+        return modbus_response_t();
+    }
+
+    auto data = std::make_shared<buffer_t>(data_size(type_, num_values_));
+    if (is_bit_model(type_)) {
+        // realign the bits so that the first value is bit 0
+        for (size_t i = 0; i < num_values_; i++) {
+            if (getBool(i)) {
+                (*data)[i / 8] |= 1 << (i % 8);
+            }
+        }
+    } else {
+        std::copy(bytes_.begin(), bytes_.end(), data->begin());
+    }
+
+    return modbus_response_t(type_, data, start_address_, num_values_);
+}
+
+modbus_error_code read_plan::store(size_t request,
+                                   std::span<const uint8_t> values) {
+    const auto& read = requests_.at(request);
+    size_t size = data_size(read.data_model, read.length);
+    if (values.size() < size) {
+        stored_[request] = false;
+        return modbus_error_code::invalid_byte_count;
+    }
+
+    std::copy(values.begin(), values.begin() + size,
+              data_.begin() + offsets_[request]);
+    stored_[request] = true;
+    return modbus_error_code::success;
+}
+
+modbus_error_code read_plan::store(size_t request,
+                                   tcp_data_unit_view response) {
+    const auto& read = requests_.at(request);
+    if (response.buffer().empty() || response.is_exception() ||
+        response.function_code() != read.function_code()) {
+        stored_[request] = false;
+        return modbus_error_code::invalid_function_code;
+    }
+
+    std::span<const uint8_t> values;
+    modbus_error_code error;
+    switch (read.data_model) {
+    case data_model_t::coil:
+        error = response_values<read_coils_response_view,
+                                &read_coils_response_view::values>(response,
+                                                                   values);
+        break;
+    case data_model_t::input_status:
+        error = response_values<read_discrete_inputs_response_view,
+                                &read_discrete_inputs_response_view::inputs>(
+            response, values);
+        break;
+    case data_model_t::input_register:
+        error = response_values<read_input_registers_response_view,
+                                &read_input_registers_response_view::values>(
+            response, values);
+        break;
+    default:
+        error = response_values<read_holding_registers_response_view,
+                                &read_holding_registers_response_view::values>(
+            response, values);
+        break;
+    }
+
+    if (error != modbus_error_code::success) {
+        stored_[request] = false;
+        return error;
+    }
+    return store(request, values);
+}
+
+void read_plan::invalidate() noexcept {
+    std::fill(stored_.begin(), stored_.end(), false);
+}
+
+tag_data read_plan::tag(size_t index) const {
+    const auto& tag = tags_.at(index);
+    if (!stored_[tag.request]) {
+        return tag_data();
+    }
+
+    const auto& read = requests_[tag.request];
+    size_t offset = tag.read.address - read.start_address;
+    auto data = std::span<const uint8_t>(data_).subspan(
+        offsets_[tag.request], data_size(read.data_model, read.length));
+
+    if (is_bit_model(read.data_model)) {
+        return tag_data(read.data_model, tag.read.address, tag.read.width, data,
+                        offset);
+    }
+    return tag_data(read.data_model, tag.read.address, tag.read.width,
+                    data.subspan(offset * 2, tag.read.width * 2));
+}
+
+read_plan plan_reads(std::span<const tag_read> tags,
+                     const read_plan_options& options) {
+    read_plan plan;
+    plan.tags_.reserve(tags.size());
+
+    for (const auto& tag : tags) {
+        uint16_t limit = quantity_limit(tag.data_model, options);
+        if (tag.data_model == data_model_t::invalid_data_type) {
+            throw std::invalid_argument("the tag has no data model");
+        }
+        if (tag.width == 0 || tag.width > limit ||
+            tag.address + tag.width > 0x10000) {
+            throw std::invalid_argument(
+                "the tag cannot be read by a single request");
+        }
+        plan.tags_.push_back(read_plan::planned_tag{tag, 0});
+    }
+
+    // visit the tags in the order the requests are built
+    std::vector<size_t> order(tags.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+        const auto& a = tags[lhs];
+        const auto& b = tags[rhs];
+        return std::tie(a.unit_id, a.data_model, a.address) <
+               std::tie(b.unit_id, b.data_model, b.address);
+    });
+
+    // the end of the values of the current request that belong to a tag
+    size_t end = 0;
+    for (size_t index : order) {
+        const auto& tag = tags[index];
+        bool bits = is_bit_model(tag.data_model);
+        size_t limit = quantity_limit(tag.data_model, options);
+        size_t gap = bits ? options.max_bit_gap : options.max_register_gap;
+        size_t tagEnd = tag.address + tag.width;
+
+        bool merge = false;
+        if (!plan.requests_.empty()) {
+            auto& read = plan.requests_.back();
+            size_t mergedEnd = std::max(end, tagEnd);
+            merge = read.unit_id == tag.unit_id &&
+                    read.data_model == tag.data_model &&
+                    tag.address <= end + gap &&
+                    mergedEnd - read.start_address <= limit;
+        }
+
+        if (merge) {
+            // the values between the last tag and this one are wasted
+            if (tag.address > end) {
+                (bits ? plan.stats_.wasted_bits
+                      : plan.stats_.wasted_registers) += tag.address - end;
+            }
+            if (tagEnd > end) {
+                end = tagEnd;
+                auto& read = plan.requests_.back();
+                read.length = end - read.start_address;
+            }
+        } else {
+            plan.requests_.push_back(planned_read{tag.unit_id, tag.data_model,
+                                                  tag.address, tag.width});
+            end = tagEnd;
+        }
+        plan.tags_[index].request = plan.requests_.size() - 1;
+    }
+
+    size_t offset = 0;
+    plan.offsets_.reserve(plan.requests_.size());
+    for (const auto& read : plan.requests_) {
+        plan.offsets_.push_back(offset);
+        offset += data_size(read.data_model, read.length);
+        (is_bit_model(read.data_model) ? plan.stats_.bits
+                                       : plan.stats_.registers) += read.length;
+    }
+    plan.data_.resize(offset);
+    plan.stored_.assign(plan.requests_.size(), false);
+
+    plan.stats_.tags = tags.size();
+    plan.stats_.requests = plan.requests_.size();
+    return plan;
+}
+
+} // namespace modbus
@@ -0,0 +1,348 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "modbus/core/error.hpp"
+#include "modbus/core/modbus_response.hpp"
+#include "modbus/core/tcp_data_unit.hpp"
+#include "modbus/core/tcp_data_unit_view.hpp"
+#include "modbus/core/types.hpp"
+
+namespace modbus {
+
+/// The default number of unused registers a merged read may span.
+constexpr uint16_t DEFAULT_MAX_REGISTER_GAP = 8;
+/// The default number of unused coils or inputs a merged read may span.
+constexpr uint16_t DEFAULT_MAX_BIT_GAP = 64;
+
+/**
+ * @brief A block of values that the application needs from a device.
+ */
+struct tag_read {
+    /// The unit that holds the values.
+    uint8_t unit_id;
+    /// The data model of the values. It selects the function code.
+    data_model_t data_model;
+    /// The address of the first value.
+    uint16_t address;
+    /// The number of coils, inputs or registers.
+    uint16_t width;
+};
+
+/**
+ * @brief The limits that plan_reads merges tag reads under.
+ */
+struct read_plan_options {
+    /// The largest number of unused registers between two tags that are read
+    /// with one request.
+    uint16_t max_register_gap;
+    /// The largest number of unused coils or inputs between two tags that are
+    /// read with one request.
+    uint16_t max_bit_gap;
+    /// The largest number of registers read by one request. Values above
+    /// MAX_READ_REGISTERS are treated as MAX_READ_REGISTERS.
+    uint16_t max_registers;
+    /// The largest number of coils or inputs read by one request. Values above
+    /// MAX_READ_BITS are treated as MAX_READ_BITS.
+    uint16_t max_bits;
+
+    read_plan_options()
+        : max_register_gap(DEFAULT_MAX_REGISTER_GAP)
+        , max_bit_gap(DEFAULT_MAX_BIT_GAP)
+        , max_registers(MAX_READ_REGISTERS)
+        , max_bits(MAX_READ_BITS) {}
+
+    read_plan_options set_max_register_gap(uint16_t gap) {
+        this->max_register_gap = gap;
+        return *this;
+    }
+
+    read_plan_options set_max_bit_gap(uint16_t gap) {
+        this->max_bit_gap = gap;
+        return *this;
+    }
+
+    read_plan_options set_max_registers(uint16_t max_registers) {
+        this->max_registers = max_registers;
+        return *this;
+    }
+
+    read_plan_options set_max_bits(uint16_t max_bits) {
+        this->max_bits = max_bits;
+        return *this;
+    }
+};
+
+/**
+ * @brief One request of a read_plan.
+ */
+struct planned_read {
+    uint8_t unit_id;
+    data_model_t data_model;
+    uint16_t start_address;
+    uint16_t length;
+
+    /**
+     * @return The function code that reads data_model: read_coils,
+     * read_discrete_inputs, read_holding_registers or read_input_registers.
+     */
+    function_code_t function_code() const noexcept;
+
+    /**
+     * @return The request as a tcp_data_unit.
+     * @param transactionId The transaction ID as defined by the MODBUS
+     * standard.
+     */
+    tcp_data_unit create_request(uint16_t transactionId) const;
+
+    /**
+     * @brief Writes the request into a buffer owned by the caller.
+     * @param transactionId The transaction ID as defined by the MODBUS
+     * standard.
+     * @param out The buffer to write the frame into.
+     * @return The number of bytes written, or 0 if out is too small.
+     */
+    size_t encode(uint16_t transactionId,
+                  std::span<uint8_t> out) const noexcept;
+
+    bool operator==(const planned_read&) const = default;
+};
+
+/**
+ * @brief The cost of a read_plan.
+ */
+struct read_plan_stats {
+    /// The number of tags in the plan.
+    size_t tags;
+    /// The number of requests needed to read every tag once.
+    size_t requests;
+    /// The number of registers read by the requests.
+    size_t registers;
+    /// The number of coils and inputs read by the requests.
+    size_t bits;
+    /// The number of registers that are read but belong to no tag.
+    size_t wasted_registers;
+    /// The number of coils and inputs that are read but belong to no tag.
+    size_t wasted_bits;
+
+    /**
+     * @return The number of response bytes spent on values that belong to no
+     * tag.
+     */
+    size_t wasted_bytes() const noexcept {
+        return wasted_registers * 2 + (wasted_bits + 7) / 8;
+    }
+};
+
+/**
+ * @brief The values of one tag. The accessors work like those of
+ * modbus_response_t but reference the data stored in a read_plan.
+ */
+class tag_data {
+  public:
+    /**
+     * Initializes a default, invalid object
+     */
+    tag_data() noexcept;
+
+    /**
+     * @param type The data model of the values.
+     * @param start_address The address of the first value.
+     * @param numValues The number of values.
+     * @param bytes The registers in big-endian order, or the packed bits.
+     * @param firstBit The bit of bytes that holds the first coil or input.
+     */
+    tag_data(data_model_t type, uint16_t start_address, uint16_t numValues,
+             std::span<const uint8_t> bytes, size_t firstBit = 0) noexcept;
+
+    /**
+     * @return The type of data.
+     */
+    data_model_t data_model() const noexcept { return type_; }
+
+    /**
+     * @returns The starting address of the data.
+     */
+    uint16_t start_address() const noexcept { return start_address_; }
+
+    /**
+     * @returns The number of values stored in data.
+     */
+    uint16_t size() const noexcept { return num_values_; }
+
+    /**
+     * @return true if the response to the request that reads the tag was
+     * stored.
+     */
+    bool isValid() const noexcept {
+        return type_ != data_model_t::invalid_data_type && !bytes_.empty();
+    }
+
+    /**
+     * @return The coil or input status at index.
+     * @throws std::out_of_range if index is not less than size().
+     */
+    bool getBool(unsigned int index) const;
+
+    /**
+     * Unpacks consecutive coils or input statuses into out.
+     * @param index The index of the first coil or input status.
+     * @param out The destination of the statuses.
+     * @return The number of statuses copied.
+     */
+    size_t getBools(unsigned int index, std::span<bool> out) const;
+
+    /**
+     * @param index The index of the word in the data block.
+     * @param order The byte order of the data point.
+     * @throws std::out_of_range if the word is outside of the tag.
+     */
+    uint16_t getUINT16(unsigned int index,
+                       byte_order order = byte_order::normal) const;
+
+    /**
+     * @param index The index of the word in the data block.
+     * @param order The byte order of the data point.
+     * @throws std::out_of_range if the word is outside of the tag.
+     */
+    int16_t getINT16(unsigned int index,
+                     byte_order order = byte_order::normal) const;
+
+    /**
+     * @param index The index of the double word in the data block.
+     * @param order The byte order of the data point.
+     * @throws std::out_of_range if the double word is outside of the tag.
+     */
+    uint32_t getUINT32(unsigned int index,
+                       byte_order order = byte_order::normal) const;
+
+    /**
+     * @param index The index of the double word in the data block.
+     * @param order The byte order of the data point.
+     * @throws std::out_of_range if the double word is outside of the tag.
+     */
+    int32_t getINT32(unsigned int index,
+                     byte_order order = byte_order::normal) const;
+
+    /**
+     * @return A copy of the values as a modbus_response_t.
+     */
+    modbus_response_t to_response() const;
+
+  private:
+    std::span<const uint8_t> word(size_t offset, size_t size) const;
+
+  private:
+    data_model_t type_;
+    uint16_t start_address_;
+    uint16_t num_values_;
+    std::span<const uint8_t> bytes_;
+    size_t first_bit_;
+};
+
+/**
+ * @brief The smallest set of read requests that covers a list of tags, and
+ * the storage their responses are scattered from.
+ *
+ * @section Send each request in requests(), store() each response, then read
+ * the values of each tag with tag(). A plan can be reused for every scan: the
+ * stored data is overwritten by the next store().
+ */
+class read_plan {
+  public:
+    read_plan() = default;
+
+    /**
+     * @return The requests that read every tag, ordered by unit ID, data model
+     * and address.
+     */
+    std::span<const planned_read> requests() const noexcept {
+        return requests_;
+    }
+
+    /**
+     * @return The number of tags, in the order they were planned.
+     */
+    size_t tag_count() const noexcept { return tags_.size(); }
+
+    /**
+     * @return The index of the request that reads the tag at index.
+     */
+    size_t request_of(size_t tag) const { return tags_.at(tag).request; }
+
+    /**
+     * @brief Stores the values returned for a request.
+     * @param request The index of the request in requests().
+     * @param values The registers in big-endian order, or the packed bits, as
+     * they appear in the response.
+     * @return invalid_byte_count if values is too short for the request.
+     */
+    modbus_error_code store(size_t request, std::span<const uint8_t> values);
+
+    /**
+     * @brief Stores the response to a request.
+     * @param request The index of the request in requests().
+     * @param response The response frame.
+     * @return invalid_function_code if the response is an exception or does not
+     * answer the request, or why the PDU could not be decoded.
+     */
+    modbus_error_code store(size_t request, tcp_data_unit_view response);
+
+    /**
+     * @brief Forgets the stored data of every request.
+     */
+    void invalidate() noexcept;
+
+    /**
+     * @return The values of the tag at index. The result is invalid if the
+     * response to its request has not been stored, and references the plan
+     * otherwise.
+     */
+    tag_data tag(size_t index) const;
+
+    /**
+     * @return The number of requests and the number of values read that
+     * belong to no tag.
+     */
+    const read_plan_stats& stats() const noexcept { return stats_; }
+
+  private:
+    friend read_plan plan_reads(std::span<const tag_read>,
+                                const read_plan_options&);
+
+    struct planned_tag {
+        tag_read read;
+        /// The index of the request that reads the tag.
+        size_t request;
+    };
+
+    std::vector<planned_read> requests_;
+    std::vector<planned_tag> tags_;
+    /// The offset of the data of each request in data_.
+    std::vector<size_t> offsets_;
+    /// Whether the data of each request was stored.
+    std::vector<bool> stored_;
+    buffer_t data_;
+    read_plan_stats stats_{};
+};
+
+/**
+ * @brief Merges tag reads into the fewest read requests.
+ *
+ * @section Tags of the same unit and data model are sorted by address. Each
+ * request grows to cover the next tag as long as the unused values between
+ * them are within the gap limit and the request stays within the quantity
+ * limit of its function code. Overlapping and duplicate tags share a request.
+ *
+ * @param tags The values the application needs.
+ * @param options The gap and quantity limits.
+ * @return The plan.
+ * @throws std::invalid_argument if a tag has no data model, a width of 0, is
+ * wider than a single request can read or extends past address 65535.
+ */
+read_plan plan_reads(std::span<const tag_read> tags,
+                     const read_plan_options& options = read_plan_options());
+
+} // namespace modbus
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "modbus/core/bit_pack.hpp"
+#include "modbus/core/endian.hpp"
+
+namespace modbus {
+
+/**
+ * @brief A non-owning sequence of 16-bit registers stored in big-endian byte
+ * order, exactly as they appear in a MODBUS PDU.
+ */
+class register_span {
+  public:
+    constexpr register_span() noexcept = default;
+
+    /**
+     * @brief Creates a register_span over the bytes of a register payload.
+     * @param bytes The payload. A trailing odd byte is ignored.
+     */
+    constexpr explicit register_span(std::span<const uint8_t> bytes) noexcept
+        : bytes_(bytes.first(bytes.size() - (bytes.size() % 2))) {}
+
+    /**
+     * @return The number of registers.
+     */
+    constexpr size_t size() const noexcept { return bytes_.size() / 2; }
+
+    /**
+     * @return Whether or not the span holds any registers.
+     */
+    constexpr bool empty() const noexcept { return bytes_.empty(); }
+
+    /**
+     * @return The register at index converted to host byte order. No bounds
+     * checking is performed.
+     */
+    constexpr uint16_t operator[](size_t index) const noexcept {
+        return (uint16_t)((bytes_[2 * index] << 8) | bytes_[2 * index + 1]);
+    }
+
+    /**
+     * @return The register at index converted to host byte order.
+     * @throws std::out_of_range if index is not less than size().
+     */
+    uint16_t at(size_t index) const {
+        if (index >= size()) {
+            throw std::out_of_range("Register index is out of range.");
+        }
+        return (*this)[index];
+    }
+
+    /**
+     * @return The raw big-endian bytes of the registers.
+     */
+    constexpr std::span<const uint8_t> bytes() const noexcept {
+        return bytes_;
+    }
+
+    /**
+     * @brief Converts the registers to host byte order and copies them into
+     * out.
+     * @return The number of registers copied. This is the smaller of size()
+     * and out.size().
+     */
+    size_t copy_to(std::span<uint16_t> out) const noexcept {
+        size_t count = std::min(size(), out.size());
+        load_registers(bytes_.data(), out.first(count));
+        return count;
+    }
+
+    /**
+     * @return The registers in host byte order.
+     */
+    std::vector<uint16_t> to_vector() const {
+        std::vector<uint16_t> values(size());
+        copy_to(values);
+        return values;
+    }
+
+  private:
+    std::span<const uint8_t> bytes_;
+};
+
+/**
+ * @brief A non-owning sequence of coils or discrete inputs packed eight to a
+ * byte, least significant bit first, as they appear in a MODBUS PDU.
+ */
+class coil_span {
+  public:
+    constexpr coil_span() noexcept = default;
+
+    /**
+     * @brief Creates a coil_span over the packed bytes of a payload.
+     * @param bytes The packed bits.
+     */
+    constexpr explicit coil_span(std::span<const uint8_t> bytes) noexcept
+        : bytes_(bytes) {}
+
+    /**
+     * @return The number of bits held by the span. The PDU does not carry the
+     * number of coils so this is always a multiple of 8.
+     */
+    constexpr size_t size() const noexcept { return bytes_.size() * 8; }
+
+    /**
+     * @return Whether or not the span holds any bits.
+     */
+    constexpr bool empty() const noexcept { return bytes_.empty(); }
+
+    /**
+     * @return The status of the coil at index. No bounds checking is
+     * performed.
+     */
+    constexpr bool operator[](size_t index) const noexcept {
+        return (bytes_[index / 8] >> (index % 8)) & 0x01;
+    }
+
+    /**
+     * @return The status of the coil at index.
+     * @throws std::out_of_range if index is not less than size().
+     */
+    bool at(size_t index) const {
+        if (index >= size()) {
+            throw std::out_of_range("Coil index is out of range.");
+        }
+        return (*this)[index];
+    }
+
+    /**
+     * @return The raw packed bytes.
+     */
+    constexpr std::span<const uint8_t> bytes() const noexcept {
+        return bytes_;
+    }
+
+    /**
+     * @brief Unpacks the coils into out.
+     * @return The number of coils copied. This is the smaller of size() and
+     * out.size().
+     */
+    size_t copy_to(std::span<bool> out) const noexcept {
+        size_t count = std::min(size(), out.size());
+        unpack_bits(bytes_.data(), out.first(count));
+        return count;
+    }
+
+  private:
+    std::span<const uint8_t> bytes_;
+};
+
+} // namespace modbus
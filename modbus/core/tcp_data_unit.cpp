@@ -1,4 +1,5 @@
 
+#include <algorithm>
 #include <iomanip>
 
 #include "modbus/core/tcp_data_unit.hpp"
@@ -6,7 +7,7 @@
 namespace modbus {
 
 tcp_data_unit::tcp_data_unit()
-    : buffer_(std::make_shared<buffer_t>())
+    : buffer_()
     , type_(message_type::invalid_pdu_type) {}
 
 tcp_data_unit::tcp_data_unit(modbus::buffer_t buffer, size_t bytesRead,
@@ -22,12 +23,24 @@ tcp_data_unit::tcp_data_unit(modbus::buffer_t buffer, size_t bytesRead,
             "Message length field and Data length do not match.");
     }
 
-    buffer_ = std::make_shared<modbus::buffer_t>(std::move(buffer));
+    // bytes after the end of the frame are dropped if the buffer is larger
+    // than a frame; the length field comes from the peer, so a frame it
+    // claims is larger than a MODBUS frame is rejected
+    size_t frameLength = std::min(bytesRead, buffer.size());
+    if (frameLength > MAX_APU_SIZE) {
+        if (TCP_HEADER_SIZE + messageLength > MAX_APU_SIZE) {
+            throw std::out_of_range(
+                "Message length field exceeds the maximum frame size.");
+        }
+        frameLength = TCP_HEADER_SIZE + messageLength;
+    }
+    buffer_ = frame_pool::default_pool()->acquire(frameLength);
+    std::copy_n(buffer.begin(), frameLength, buffer_->data.begin());
 }
 
 tcp_data_unit::tcp_data_unit(modbus::buffer_t header, modbus::buffer_t payload,
                              size_t bytesRead, message_type type)
-    : buffer_(std::make_shared<modbus::buffer_t>())
+    : buffer_()
     , type_(type) {
     if (header.at(2) != 0 || header.at(3) != 0) {
         throw std::invalid_argument("Protocol ID is invalid");
@@ -42,51 +55,76 @@ tcp_data_unit::tcp_data_unit(modbus::buffer_t header, modbus::buffer_t payload,
             "Message length field and Data length do not match.");
     }
 
-    buffer_->reserve(header.size() + payload.size());
-    buffer_->insert(buffer_->begin(), std::make_move_iterator(header.begin()),
-                    std::make_move_iterator(header.end()));
+    size_t payloadLength = std::min(bytesRead, payload.size());
+    buffer_ =
+        frame_pool::default_pool()->acquire(header.size() + payloadLength);
+    auto it = std::copy(header.begin(), header.end(), buffer_->data.begin());
+    std::copy_n(payload.begin(), payloadLength, it);
+}
 
-    buffer_->insert(buffer_->end(), std::make_move_iterator(payload.begin()),
-                    std::make_move_iterator(payload.end()));
+tcp_data_unit::tcp_data_unit(const tcp_data_unit_view& view, frame_pool& pool)
+    : buffer_(pool.acquire(view.buffer().size()))
+    , type_(view.type()) {
+    std::copy(view.buffer().begin(), view.buffer().end(),
+              buffer_->data.begin());
+}
+
+uint8_t tcp_data_unit::byte_at(size_t index) const {
+    if (index >= bytes().size()) {
+        throw std::out_of_range("Data unit is too short.");
+    }
+    return buffer_->data[index];
 }
 
 void tcp_data_unit::set_transaction_id(uint16_t transactionId) {
-    buffer_->at(0) = (uint8_t)(transactionId >> 8);
-    buffer_->at(1) = (uint8_t)(transactionId & 0x00FF);
+    if (bytes().size() < 2) {
+        throw std::out_of_range("Data unit is too short.");
+    }
+    buffer_->data[0] = (uint8_t)(transactionId >> 8);
+    buffer_->data[1] = (uint8_t)(transactionId & 0x00FF);
 }
 
 uint16_t tcp_data_unit::transaction_id() const {
-    uint16_t transactionId = buffer_->at(0) << 8;
-    transactionId += buffer_->at(1);
+    uint16_t transactionId = byte_at(0) << 8;
+    transactionId += byte_at(1);
     return transactionId;
 }
 
 uint16_t tcp_data_unit::message_length() const {
-    uint16_t messageLength = buffer_->at(4) << 8;
-    messageLength += buffer_->at(5);
+    uint16_t messageLength = byte_at(4) << 8;
+    messageLength += byte_at(5);
     return messageLength;
 }
 
-uint8_t tcp_data_unit::unit_id() const { return buffer_->at(6); }
+uint8_t tcp_data_unit::unit_id() const { return byte_at(6); }
 
 function_code_t tcp_data_unit::function_code() const {
-    return (modbus::function_code_t)(buffer_->at(7) & 0x7F);
+    return (modbus::function_code_t)(byte_at(7) & 0x7F);
 }
 
-bool tcp_data_unit::is_exception() const { return (buffer_->at(7) & 0x80); }
+bool tcp_data_unit::is_exception() const { return (byte_at(7) & 0x80); }
 
 exception_code_t tcp_data_unit::exception_code() const {
     if (!is_exception()) {
         return exception_code_t::no_exception;
     }
 
-    return (modbus::exception_code_t)buffer_->at(8);
+    return (modbus::exception_code_t)byte_at(8);
 }
 
 message_type tcp_data_unit::type() const { return type_; }
 
+tcp_data_unit_view tcp_data_unit::view() const {
+    if (bytes().empty()) {
+        return tcp_data_unit_view();
+    }
+
+    return tcp_data_unit_view(bytes(), type_);
+}
+
 std::shared_ptr<const modbus::buffer_t> tcp_data_unit::buffer() const {
-    return std::shared_ptr<const modbus::buffer_t>(buffer_);
+    auto data = bytes();
+    return std::make_shared<const modbus::buffer_t>(data.begin(), data.end());
 }
 
-} // namespace modbus
\ No newline at end of file
+} // namespace modbus
@@ -5,10 +5,14 @@
 #include <iostream>
 #include <memory>
 #include <optional>
+#include <span>
 #include <vector>
 
+#include "modbus/core/encode.hpp"
+#include "modbus/core/frame_pool.hpp"
 #include "modbus/core/messages/exception_response.hpp"
 #include "modbus/core/messages/is_message.hpp"
+#include "modbus/core/tcp_data_unit_view.hpp"
 #include "modbus/core/types.hpp"
 
 namespace modbus {
@@ -18,7 +22,9 @@ namespace modbus {
  * receiving device.
  *
  * @section The tcp_data_unit is defined by the MODBUS standard and contains a
- * PDU which can represent a request or a response.
+ * PDU which can represent a request or a response. The bytes of the data unit
+ * are stored in a frame drawn from a frame_pool. Copies of a tcp_data_unit
+ * share the same frame.
  */
 class tcp_data_unit {
 
@@ -34,32 +40,18 @@ class tcp_data_unit {
      * standard.
      * @param pdu The data payload that the TCP Data Unit will hold. It must
      * meet the requirements of is_message.
+     * @param pool The pool the frame is drawn from.
      */
     template <typename M>
-    tcp_data_unit(uint16_t transactionId, M pdu)
-        : buffer_(std::make_shared<buffer_t>())
+    tcp_data_unit(uint16_t transactionId, const M& pdu,
+                  frame_pool& pool = *frame_pool::default_pool())
+        : buffer_(pool.acquire(TCP_HEADER_SIZE + pdu.size()))
         , type_(pdu.type()) {
         // Stop compilation if requirements for Message
         static_assert(detail::is_message<M>::value,
                       "Message Requirements not met.");
 
-        auto length = pdu.size();
-        buffer_->resize(TCP_HEADER_SIZE + length);
-        auto it = buffer_->begin();
-
-        // transaction ID
-        *it++ = (uint8_t)(transactionId >> 8);
-        *it++ = (uint8_t)(transactionId);
-
-        // protocol ID
-        *it++ = (uint8_t)(PROTOCOL_ID >> 8);
-        *it++ = (uint8_t)(PROTOCOL_ID);
-
-        // message length
-        *it++ = (uint8_t)(length >> 8);
-        *it++ = (uint8_t)(length);
-
-        pdu.serialize(it);
+        encode(transactionId, pdu, buffer_.bytes());
     }
 
     /**
@@ -83,6 +75,15 @@ class tcp_data_unit {
     tcp_data_unit(buffer_t header, buffer_t payload, size_t bytesRead,
                   message_type type);
 
+    /**
+     * @brief Creates a tcp_data_unit that owns a copy of the frame referenced
+     * by view.
+     * @param view The data unit to copy.
+     * @param pool The pool the frame is drawn from.
+     */
+    explicit tcp_data_unit(const tcp_data_unit_view& view,
+                           frame_pool& pool = *frame_pool::default_pool());
+
     tcp_data_unit(const tcp_data_unit& dataUnit) = default;
 
     tcp_data_unit(tcp_data_unit&&) noexcept = default;
@@ -127,75 +128,38 @@ class tcp_data_unit {
     exception_code_t exception_code() const;
 
     /**
-     * @return The MODBUS Protocol Data Unit (PDU)
+     * @return The MODBUS Protocol Data Unit (PDU). If T is a message view, such
+     * as read_holding_registers_response_view, the result references the
+     * buffer of this data unit.
      */
-    template <typename T>
-    std::optional<typename std::enable_if_t<
-        !std::is_same<T, exception_response>::value, T>>
-    pdu() const {
-        try {
-            if (this->is_exception()) {
-                return std::nullopt;
-            }
-
-            if ((uint8_t)this->function_code() != (uint8_t)T::function_code()) {
-                return std::nullopt;
-            }
-
-            if (type_ != T::type()) {
-                return std::nullopt;
-            }
-
-            if (buffer_->empty()) {
-                return std::nullopt;
-            }
-
-            const_buffer_iterator it = buffer_->begin();
-            it += TCP_HEADER_SIZE;
-
-            T pdu(it);
-            return pdu;
-        } catch (...) {
+    template <typename T> std::optional<T> pdu() const noexcept {
+        auto frame = decode_frame(bytes(), type_);
+        if (!frame) {
             return std::nullopt;
         }
+
+        return frame->template pdu<T>();
     }
 
     /**
-     * @return The MODBUS Protocol Data Unit for exception_response types
+     * @brief Returns a copy of the buffer of the data unit.
+     * Prefer bytes(), which does not allocate.
+     * @returns shared_ptr<const buffer>
      */
-    template <typename T>
-    std::optional<typename std::enable_if_t<
-        std::is_same<T, exception_response>::value, T>>
-    pdu() const {
-        try {
-            if (!this->is_exception()) {
-                return std::nullopt;
-            }
-
-            if (type_ != T::type()) {
-                return std::nullopt;
-            }
-
-            if (buffer_->empty()) {
-                return std::nullopt;
-            }
-
-            const_buffer_iterator it = buffer_->begin();
-            it += TCP_HEADER_SIZE;
+    std::shared_ptr<const modbus::buffer_t> buffer() const;
 
-            T pdu(it);
-            return pdu;
-        } catch (...) {
-            return std::nullopt;
-        }
-    }
+    /**
+     * @brief Returns the bytes of the data unit. This allows the frame to be
+     * sent to asio::async_write without a copy. The span is valid for as long
+     * as this data unit or a copy of it is alive.
+     */
+    std::span<const uint8_t> bytes() const noexcept { return buffer_.bytes(); }
 
     /**
-     * @brief Returns a shared_ptr to the buffer of the data unit.
-     * This allows the buffer to be sent to asio::async_write without a copy.
-     * @returns shared_ptr<const buffer>
+     * @brief Returns a non-owning view of the data unit. The view is valid for
+     * as long as the buffer of this data unit.
      */
-    std::shared_ptr<const modbus::buffer_t> buffer() const;
+    tcp_data_unit_view view() const;
 
     /**
      * @returns Whether the data unit contains a request or a response.
@@ -203,7 +167,9 @@ class tcp_data_unit {
     message_type type() const;
 
   private:
-    std::shared_ptr<modbus::buffer_t> buffer_;
+    uint8_t byte_at(size_t index) const;
+
+    frame_ptr buffer_;
     message_type type_;
 };
 
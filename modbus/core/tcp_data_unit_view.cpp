@@ -0,0 +1,103 @@
+#include "modbus/core/tcp_data_unit_view.hpp"
+
+#include <stdexcept>
+
+namespace modbus {
+
+namespace {
+
+uint8_t byte_at(std::span<const uint8_t> buffer, size_t index) {
+    if (index >= buffer.size()) {
+        throw std::out_of_range("Index is outside of the data unit.");
+    }
+
+    return buffer[index];
+}
+
+} // namespace
+
+tcp_data_unit_view::tcp_data_unit_view(std::span<const uint8_t> buffer,
+                                       message_type type)
+    : buffer_()
+    , type_(type) {
+    if (buffer.size() < TCP_HEADER_SIZE) {
+        throw std::out_of_range("Buffer is smaller than the header.");
+    }
+
+    if (buffer[2] != 0 || buffer[3] != 0) {
+        throw std::invalid_argument("Protocol ID is invalid");
+    }
+
+    // build message length
+    size_t messageLength = buffer[4] << 8;
+    messageLength += buffer[5];
+
+    // the message must at least hold the unit id and the function code
+    if (messageLength < 2 || messageLength > MAX_APU_SIZE - TCP_HEADER_SIZE) {
+        throw std::out_of_range(
+            "Message length field exceeds the maximum frame size.");
+    }
+
+    if (buffer.size() - TCP_HEADER_SIZE < messageLength) {
+        throw std::out_of_range(
+            "Message length field and Data length do not match.");
+    }
+
+    buffer_ = buffer.first(TCP_HEADER_SIZE + messageLength);
+}
+
+uint16_t tcp_data_unit_view::transaction_id() const {
+    uint16_t transactionId = byte_at(buffer_, 0) << 8;
+    transactionId += byte_at(buffer_, 1);
+    return transactionId;
+}
+
+uint16_t tcp_data_unit_view::message_length() const {
+    uint16_t messageLength = byte_at(buffer_, 4) << 8;
+    messageLength += byte_at(buffer_, 5);
+    return messageLength;
+}
+
+uint8_t tcp_data_unit_view::unit_id() const { return byte_at(buffer_, 6); }
+
+function_code_t tcp_data_unit_view::function_code() const {
+    return (modbus::function_code_t)(byte_at(buffer_, 7) & 0x7F);
+}
+
+bool tcp_data_unit_view::is_exception() const {
+    return (byte_at(buffer_, 7) & 0x80);
+}
+
+exception_code_t tcp_data_unit_view::exception_code() const {
+    if (!is_exception()) {
+        return exception_code_t::no_exception;
+    }
+
+    return (modbus::exception_code_t)byte_at(buffer_, 8);
+}
+
+expected<tcp_data_unit_view, modbus_error_code>
+decode_frame(std::span<const uint8_t> buffer, message_type type) noexcept {
+    if (buffer.size() < TCP_HEADER_SIZE) {
+        return unexpected(modbus_error_code::invalid_length);
+    }
+
+    if (buffer[2] != 0 || buffer[3] != 0) {
+        return unexpected(modbus_error_code::invalid_protocol_id);
+    }
+
+    // build message length
+    size_t messageLength = buffer[4] << 8;
+    messageLength += buffer[5];
+
+    // the message must at least hold the unit id and the function code
+    if (messageLength < 2 || messageLength > max_pdu_size + 1 ||
+        buffer.size() - TCP_HEADER_SIZE < messageLength) {
+        return unexpected(modbus_error_code::invalid_length);
+    }
+
+    return tcp_data_unit_view(buffer.first(TCP_HEADER_SIZE + messageLength),
+                              type, tcp_data_unit_view::unchecked_t{});
+}
+
+} // namespace modbus
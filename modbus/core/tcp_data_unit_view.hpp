@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "modbus/core/decode.hpp"
+#include "modbus/core/error.hpp"
+#include "modbus/core/expected.hpp"
+#include "modbus/core/types.hpp"
+
+namespace modbus {
+
+/**
+ * @brief A non-owning view of a tcp_data_unit.
+ *
+ * @section The view parses the MBAP header and PDU in place over a buffer that
+ * is owned by the caller, typically the receive buffer of a socket. It is
+ * trivially copyable and never allocates. The view is only valid for as long
+ * as the underlying buffer is alive and unmodified.
+ */
+class tcp_data_unit_view {
+
+  public:
+    /**
+     * @brief Creates an empty, invalid tcp_data_unit_view
+     */
+    constexpr tcp_data_unit_view() noexcept
+        : buffer_()
+        , type_(message_type::invalid_pdu_type) {}
+
+    /**
+     * @brief Creates a tcp_data_unit_view over a received frame.
+     * @param buffer The bytes received from the remote endpoint. Any bytes
+     * after the end of the frame described by the header are ignored.
+     * @param type An enum that defines whether this is a request or a
+     * response.
+     */
+    tcp_data_unit_view(std::span<const uint8_t> buffer, message_type type);
+
+    /**
+     * @return The transaction ID of the data unit.
+     */
+    uint16_t transaction_id() const;
+
+    /**
+     * @return The length of the PDU + the transaction ID in bytes
+     */
+    uint16_t message_length() const;
+
+    /**
+     * @return The unit ID of the intended recipient of the request.
+     */
+    uint8_t unit_id() const;
+
+    /**
+     * @return The function code.
+     */
+    function_code_t function_code() const;
+
+    /**
+     * @return Whether or not the response is an exception
+     */
+    bool is_exception() const;
+
+    /**
+     * @return The exception code from the response
+     */
+    exception_code_t exception_code() const;
+
+    /**
+     * @return The MODBUS Protocol Data Unit (PDU). If T is a message view, such
+     * as read_holding_registers_response_view, the result references the same
+     * buffer as this view.
+     */
+    template <typename T> std::optional<T> pdu() const noexcept {
+        if (buffer_.empty() || type_ != T::type()) {
+            return std::nullopt;
+        }
+
+        auto result = decode<T>(buffer_.subspan(TCP_HEADER_SIZE));
+        if (!result) {
+            return std::nullopt;
+        }
+
+        return std::move(*result);
+    }
+
+    /**
+     * @return The bytes of the frame, from the start of the MBAP header to the
+     * end of the PDU.
+     */
+    std::span<const uint8_t> buffer() const noexcept { return buffer_; }
+
+    /**
+     * @returns Whether the data unit contains a request or a response.
+     */
+    message_type type() const noexcept { return type_; }
+
+  private:
+    friend expected<tcp_data_unit_view, modbus_error_code>
+    decode_frame(std::span<const uint8_t> buffer, message_type type) noexcept;
+
+    struct unchecked_t {};
+
+    constexpr tcp_data_unit_view(std::span<const uint8_t> frame,
+                                 message_type type, unchecked_t) noexcept
+        : buffer_(frame)
+        , type_(type) {}
+
+    std::span<const uint8_t> buffer_;
+    message_type type_;
+};
+
+/**
+ * @brief Parses the MBAP header of a received frame without throwing. The PDU
+ * is validated when it is decoded with pdu() or decode().
+ * @param buffer The bytes received from the remote endpoint. Any bytes after
+ * the end of the frame described by the header are ignored.
+ * @param type An enum that defines whether this is a request or a response.
+ * @return A view of the frame, or the reason the header is invalid.
+ */
+expected<tcp_data_unit_view, modbus_error_code>
+decode_frame(std::span<const uint8_t> buffer, message_type type) noexcept;
+
+static_assert(std::is_trivially_copyable_v<tcp_data_unit_view>,
+              "tcp_data_unit_view must be trivially copyable");
+
+} // namespace modbus
@@ -0,0 +1,87 @@
+#include "modbus/core/tcp_framer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace modbus {
+
+tcp_framer::tcp_framer(message_type type, size_t capacity)
+    : owned_(std::max<size_t>(capacity, MAX_APU_SIZE))
+    , storage_(owned_)
+    , type_(type)
+    , begin_(0)
+    , end_(0)
+    , error_(modbus_error_code::success) {}
+
+tcp_framer::tcp_framer(std::span<uint8_t> storage, message_type type) noexcept
+    : owned_()
+    , storage_(storage)
+    , type_(type)
+    , begin_(0)
+    , end_(0)
+    , error_(modbus_error_code::success) {}
+
+std::span<uint8_t> tcp_framer::prepare() noexcept {
+    if (begin_ != 0) {
+        std::memmove(storage_.data(), storage_.data() + begin_, buffered());
+        end_ -= begin_;
+        begin_ = 0;
+    }
+
+    return storage_.subspan(end_);
+}
+
+void tcp_framer::commit(size_t size) noexcept {
+    end_ = std::min(end_ + size, storage_.size());
+}
+
+size_t tcp_framer::feed(std::span<const uint8_t> bytes) noexcept {
+    auto space = prepare();
+    size_t size = std::min(space.size(), bytes.size());
+    std::memcpy(space.data(), bytes.data(), size);
+    commit(size);
+    return size;
+}
+
+std::optional<tcp_data_unit_view> tcp_framer::next() noexcept {
+    if (error_ != modbus_error_code::success ||
+        buffered() < TCP_HEADER_SIZE) {
+        return std::nullopt;
+    }
+
+    const uint8_t* header = storage_.data() + begin_;
+    if (header[2] != 0 || header[3] != 0) {
+        error_ = modbus_error_code::invalid_protocol_id;
+        return std::nullopt;
+    }
+
+    // the message must at least hold the unit id and the function code
+    size_t messageLength = (header[4] << 8) | header[5];
+    size_t frameLength = TCP_HEADER_SIZE + messageLength;
+    if (messageLength < 2 || messageLength > max_pdu_size + 1 ||
+        frameLength > storage_.size()) {
+        error_ = modbus_error_code::invalid_length;
+        return std::nullopt;
+    }
+
+    if (buffered() < frameLength) {
+        return std::nullopt;
+    }
+
+    auto frame = decode_frame(storage_.subspan(begin_, frameLength), type_);
+    if (!frame) {
+        error_ = frame.error();
+        return std::nullopt;
+    }
+
+    begin_ += frameLength;
+    return *frame;
+}
+
+void tcp_framer::reset() noexcept {
+    begin_ = 0;
+    end_ = 0;
+    error_ = modbus_error_code::success;
+}
+
+} // namespace modbus
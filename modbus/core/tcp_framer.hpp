@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include "modbus/core/error.hpp"
+#include "modbus/core/tcp_data_unit_view.hpp"
+#include "modbus/core/types.hpp"
+
+namespace modbus {
+
+/// The size of the receive buffer of a tcp_framer that owns its storage.
+constexpr size_t DEFAULT_FRAMER_CAPACITY = 16 * MAX_APU_SIZE;
+
+/**
+ * @brief Splits a MODBUS TCP byte stream into frames.
+ *
+ * @section Bytes are written into the framer either by reading directly into
+ * the span returned by prepare() and calling commit(), or by copying them in
+ * with feed(). Chunks may end anywhere: in the middle of a header, in the
+ * middle of a PDU, or after several complete frames. next() returns each
+ * complete frame in order as a view over the receive buffer.
+ *
+ * @section MBAP headers carry no marker that a reader could use to find the
+ * start of the next frame, so once a header is malformed the stream cannot be
+ * recovered. The framer then stops returning frames and error() reports the
+ * reason; the connection should be closed.
+ */
+class tcp_framer {
+  public:
+    /**
+     * @brief Creates a framer that owns a receive buffer.
+     * @param type Whether the stream carries requests or responses.
+     * @param capacity The size of the receive buffer. It is raised to
+     * MAX_APU_SIZE if smaller so that any frame fits.
+     */
+    explicit tcp_framer(message_type type,
+                        size_t capacity = DEFAULT_FRAMER_CAPACITY);
+
+    /**
+     * @brief Creates a framer over a receive buffer owned by the caller.
+     * @param storage The receive buffer. Frames that are larger than storage
+     * are reported as invalid_length.
+     * @param type Whether the stream carries requests or responses.
+     */
+    tcp_framer(std::span<uint8_t> storage, message_type type) noexcept;
+
+    tcp_framer(const tcp_framer&) = delete;
+    tcp_framer& operator=(const tcp_framer&) = delete;
+
+    /**
+     * @brief Makes room for more bytes by moving any partial frame to the
+     * start of the receive buffer. Views returned by next() are invalidated.
+     * @return The free space at the end of the receive buffer.
+     */
+    std::span<uint8_t> prepare() noexcept;
+
+    /**
+     * @brief Marks bytes that were written into the span returned by prepare()
+     * as received.
+     * @param size The number of bytes written.
+     */
+    void commit(size_t size) noexcept;
+
+    /**
+     * @brief Copies bytes into the receive buffer. Views returned by next() are
+     * invalidated.
+     * @param bytes The bytes received.
+     * @return The number of bytes copied. This is less than bytes.size() if the
+     * receive buffer is full; call next() to drain it and feed the rest.
+     */
+    size_t feed(std::span<const uint8_t> bytes) noexcept;
+
+    /**
+     * @brief Removes the next complete frame from the receive buffer.
+     * @return A view of the frame, or std::nullopt if more bytes are needed or
+     * the stream is malformed. The view is valid until the next call to
+     * prepare(), feed() or reset().
+     */
+    std::optional<tcp_data_unit_view> next() noexcept;
+
+    /**
+     * @return modbus_error_code::success, or the reason the stream is
+     * malformed.
+     */
+    modbus_error_code error() const noexcept { return error_; }
+
+    /**
+     * @return The number of received bytes that have not been returned as
+     * frames.
+     */
+    size_t buffered() const noexcept { return end_ - begin_; }
+
+    /**
+     * @return The size of the receive buffer.
+     */
+    size_t capacity() const noexcept { return storage_.size(); }
+
+    /**
+     * @brief Discards any buffered bytes and clears the error.
+     */
+    void reset() noexcept;
+
+  private:
+    /// The receive buffer when the framer owns it.
+    buffer_t owned_;
+    /// The receive buffer.
+    std::span<uint8_t> storage_;
+    /// Whether the stream carries requests or responses.
+    message_type type_;
+    /// The offset of the first byte that has not been returned as a frame.
+    size_t begin_;
+    /// The offset one past the last byte received.
+    size_t end_;
+    /// The reason the stream is malformed.
+    modbus_error_code error_;
+};
+
+} // namespace modbus
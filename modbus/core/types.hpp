@@ -15,6 +15,7 @@ namespace modbus {
 
 // pre-define
 class tcp_data_unit;
+class tcp_data_unit_view;
 
 /// log_level Defines the various log levels.
 enum class log_level : uint8_t {
@@ -41,8 +42,12 @@ using logging_handler_t =
 /// Defines the response type from read_response
 using read_response_t = std::tuple<tcp_data_unit, cpool::error>;
 
+/// Defines the response type from read_response when the response is read into
+/// a buffer owned by the caller
+using read_response_view_t = std::tuple<tcp_data_unit_view, cpool::error>;
+
 /// Defines the maximum size of an Application Data Unit (APU)
-constexpr int MAX_APU_SIZE = 256;
+constexpr int MAX_APU_SIZE = 260;
 /// Defines the minimum Pdu size including the unit id
 constexpr int MIN_PDU_SIZE = 4;
 /// Defines the maximum size of a pdu
@@ -55,6 +60,18 @@ constexpr uint16_t PROTOCOL_ID = 0x0000;
 // exclude the unit_id
 constexpr int TCP_HEADER_SIZE = 6;
 
+/// The maximum number of coils or discrete inputs that can be read at once.
+constexpr uint16_t MAX_READ_BITS = 2000;
+/// The maximum number of coils that can be written at once.
+constexpr uint16_t MAX_WRITE_BITS = 1968;
+/// The maximum number of registers that can be read at once.
+constexpr uint16_t MAX_READ_REGISTERS = 125;
+/// The maximum number of registers that can be written at once.
+constexpr uint16_t MAX_WRITE_REGISTERS = 123;
+/// The maximum number of registers that can be written by
+/// read_write_multiple_registers.
+constexpr uint16_t MAX_READ_WRITE_REGISTERS = 121;
+
 /**
  * This enum contains all supported MODBUS function codes.
  */
@@ -227,4 +244,17 @@ inline void print_logging_handler(log_level level, std::string_view message) {
     std::cout << "[" << to_string(level) << "] " << message << std::endl;
 }
 
+/**
+ * @return Whether messages passed to handler go anywhere. Hot paths only
+ * format their messages when they do.
+ */
+inline bool is_logging(const logging_handler_t& handler) {
+    using handler_ptr = void (*)(log_level, std::string_view);
+    if (!handler) {
+        return false;
+    }
+    auto target = handler.target<handler_ptr>();
+    return target == nullptr || *target != &null_logging_handler;
+}
+
 } // namespace modbus
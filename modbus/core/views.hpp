@@ -0,0 +1,11 @@
+#pragma once
+
+#include "modbus/core/messages/read_coils_response_view.hpp"
+#include "modbus/core/messages/read_discrete_inputs_response_view.hpp"
+#include "modbus/core/messages/read_holding_registers_response_view.hpp"
+#include "modbus/core/messages/read_input_registers_response_view.hpp"
+#include "modbus/core/messages/read_write_registers_request_view.hpp"
+#include "modbus/core/messages/read_write_registers_response_view.hpp"
+#include "modbus/core/messages/write_multiple_coils_request_view.hpp"
+#include "modbus/core/messages/write_multiple_registers_request_view.hpp"
+#include "modbus/core/register_span.hpp"
\ No newline at end of file
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "modbus/core/decode.hpp"
+#include "modbus/core/requests.hpp"
+#include "modbus/core/responses.hpp"
+#include "modbus/core/tcp_data_unit.hpp"
+#include "modbus/core/tcp_data_unit_view.hpp"
+#include "modbus/core/types.hpp"
+#include "modbus/core/views.hpp"
+
+namespace modbus {
+
+namespace detail {
+
+/// The messages handed to the visitor for request frames. Messages that carry
+/// a payload are handed over as views of the frame.
+template <typename... T> struct message_list {};
+
+using visit_requests =
+    message_list<read_coils_request, read_discrete_inputs_request,
+                 read_holding_registers_request, read_input_registers_request,
+                 write_single_coil_request, write_single_register_request,
+                 write_multiple_coils_request_view,
+                 write_multiple_registers_request_view,
+                 mask_write_register_request,
+                 read_write_registers_request_view>;
+
+/// The messages handed to the visitor for response frames.
+using visit_responses =
+    message_list<read_coils_response_view, read_discrete_inputs_response_view,
+                 read_holding_registers_response_view,
+                 read_input_registers_response_view,
+                 write_single_coil_response, write_single_register_response,
+                 write_multiple_coils_response,
+                 write_multiple_registers_response,
+                 mask_write_register_response,
+                 read_write_registers_response_view>;
+
+template <typename Visitor>
+using visit_result_t = std::invoke_result_t<Visitor&, exception_response>;
+
+template <typename Visitor>
+using visit_handler_t = visit_result_t<Visitor> (*)(tcp_data_unit_view,
+                                                     Visitor&);
+
+/// The PDU of frame, from the unit ID to the end.
+inline std::span<const uint8_t> frame_pdu(tcp_data_unit_view frame) noexcept {
+    return frame.buffer().subspan(TCP_HEADER_SIZE);
+}
+
+/// Handles function codes that have no message in the table.
+template <typename Visitor>
+visit_result_t<Visitor> visit_unsupported(tcp_data_unit_view frame,
+                                          Visitor& visitor) {
+    auto pdu = frame_pdu(frame);
+    return visitor(exception_response(
+        pdu[0], (function_code_t)(pdu[1] & 0x7F),
+        exception_code_t::illegal_function));
+}
+
+/// Handles exception responses sent by a server.
+template <typename Visitor>
+visit_result_t<Visitor> visit_exception(tcp_data_unit_view frame,
+                                        Visitor& visitor) {
+    auto response = decode<exception_response>(frame_pdu(frame));
+    if (!response) {
+        return visit_unsupported(frame, visitor);
+    }
+    return visitor(*response);
+}
+
+/// Decodes a message of type T and hands it to the visitor. A malformed PDU is
+/// handed over as an illegal_data_value exception.
+template <typename T, typename Visitor>
+visit_result_t<Visitor> visit_message(tcp_data_unit_view frame,
+                                      Visitor& visitor) {
+    auto pdu = frame_pdu(frame);
+    auto message = decode<T>(pdu);
+    if (!message) {
+        return visitor(exception_response(
+            pdu[0], T::function_code(), exception_code_t::illegal_data_value));
+    }
+    return visitor(*message);
+}
+
+/// A table indexed by the function code byte of the frame.
+template <typename Visitor, typename... T>
+constexpr std::array<visit_handler_t<Visitor>, 256>
+make_visit_table(message_list<T...>, bool responses) {
+    std::array<visit_handler_t<Visitor>, 256> table{};
+    for (size_t i = 0; i < table.size(); i++) {
+        table[i] = (responses && (i & 0x80)) ? &visit_exception<Visitor>
+                                             : &visit_unsupported<Visitor>;
+    }
+    ((table[(uint8_t)T::function_code()] = &visit_message<T, Visitor>), ...);
+    return table;
+}
+
+template <typename Visitor>
+constexpr auto request_visit_table =
+    make_visit_table<Visitor>(visit_requests{}, false);
+
+template <typename Visitor>
+constexpr auto response_visit_table =
+    make_visit_table<Visitor>(visit_responses{}, true);
+
+} // namespace detail
+
+/**
+ * @brief Decodes the PDU of a frame and hands it to the overload of visitor
+ * for its message type.
+ *
+ * @section The function code is looked up in a table that is built at compile
+ * time, so the cost of dispatch does not depend on the function code. Messages
+ * that carry a payload are handed over as views, such as
+ * write_multiple_registers_request_view, that reference the frame. Other
+ * messages are handed over by value.
+ *
+ * @section visitor must also accept an exception_response. It receives:
+ * - illegal_function if the function code is not supported;
+ * - illegal_data_value if the PDU is malformed;
+ * - the exception sent by the server if frame is an exception response.
+ * When frame is a request, the exception_response is the response that
+ * should be sent back to the client.
+ *
+ * @param frame A frame returned by decode_frame or a tcp_framer. The buffer of
+ * the frame must outlive the call.
+ * @param visitor A callable with an overload for each message type. Every
+ * overload must return the same type as the exception_response overload.
+ * @return The result of the visitor.
+ */
+template <typename Visitor>
+detail::visit_result_t<Visitor> visit(tcp_data_unit_view frame,
+                                      Visitor&& visitor) {
+    using handler_visitor = std::remove_reference_t<Visitor>;
+
+    // the frame must at least hold the unit id and the function code
+    if (frame.buffer().size() < TCP_HEADER_SIZE + 2) {
+        return visitor(exception_response(0, (function_code_t)0,
+                                          exception_code_t::illegal_function));
+    }
+
+    uint8_t functionCode = frame.buffer()[TCP_HEADER_SIZE + 1];
+    if (frame.type() == message_type::response) {
+        return detail::response_visit_table<handler_visitor>[functionCode](
+            frame, visitor);
+    }
+    return detail::request_visit_table<handler_visitor>[functionCode](frame,
+                                                                     visitor);
+}
+
+/**
+ * @brief Decodes the PDU of a tcp_data_unit and hands it to the overload of
+ * visitor for its message type. @see visit(tcp_data_unit_view, Visitor&&)
+ * @param frame The data unit. It must outlive the call.
+ */
+template <typename Visitor>
+detail::visit_result_t<Visitor> visit(const tcp_data_unit& frame,
+                                      Visitor&& visitor) {
+    return visit(frame.view(), std::forward<Visitor>(visitor));
+}
+
+} // namespace modbus
@@ -1,11 +1,17 @@
 #pragma once
 
+#include "modbus/core/decode.hpp"
+#include "modbus/core/encode.hpp"
 #include "modbus/core/error.hpp"
 #include "modbus/core/modbus_response.hpp"
 #include "modbus/core/requests.hpp"
 #include "modbus/core/responses.hpp"
 #include "modbus/core/tcp_data_unit.hpp"
+#include "modbus/core/tcp_data_unit_view.hpp"
+#include "modbus/core/tcp_framer.hpp"
 #include "modbus/core/types.hpp"
+#include "modbus/core/views.hpp"
+#include "modbus/core/visit.hpp"
 #include "modbus/server/server_config.hpp"
 #include "modbus/server/server_helper.hpp"
 #include "modbus/server/server_types.hpp"
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string>
 
+#include "modbus/core/frame_pool.hpp"
 #include "modbus/core/types.hpp"
 #include "server_types.hpp"
 
@@ -13,18 +15,21 @@ struct server_config {
     uint16_t port;
     uint16_t max_connections;
     logging_handler_t logging_handler;
+    std::shared_ptr<frame_pool> frames;
 
     server_config()
         : endpoint("0.0.0.0")
         , port(502)
         , max_connections(DEFAULT_SERVER_MAX_CONNECTIONS)
-        , logging_handler(null_logging_handler) {}
+        , logging_handler(null_logging_handler)
+        , frames(frame_pool::default_pool()) {}
 
     server_config(std::string endpoint, uint16_t port)
         : endpoint(endpoint)
         , port(port)
         , max_connections(DEFAULT_SERVER_MAX_CONNECTIONS)
-        , logging_handler(null_logging_handler) {}
+        , logging_handler(null_logging_handler)
+        , frames(frame_pool::default_pool()) {}
 
     server_config set_endpoint(std::string endpoint) {
         this->endpoint = endpoint;
@@ -45,6 +50,11 @@ struct server_config {
         this->logging_handler = handler;
         return *this;
     }
+
+    server_config set_frame_pool(std::shared_ptr<frame_pool> frames) {
+        this->frames = frames;
+        return *this;
+    }
 };
 
 } // namespace modbus
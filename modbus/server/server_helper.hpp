@@ -1,3 +1,4 @@
+#include "modbus/core/endian.hpp"
 #include "modbus/core/types.hpp"
 
 namespace modbus {
@@ -179,14 +180,9 @@ inline buffer_t copy_data_registers(const buffer_t& from, int startAddress,
     int startByte = startAddress * 2;
     int numBytes = numRegisters * 2;
 
-    buffer_t to(numBytes);
-
     // Copy Data
-    for (int i = 0; i < numBytes; i++) {
-        to[i] = from[i + startByte];
-    }
-
-    return to;
+    auto first = from.begin() + startByte;
+    return buffer_t(first, first + numBytes);
 }
 
 /**
@@ -217,10 +213,7 @@ inline void write_registers(const vector<uint16_t>& from, buffer_t& to,
     int startByte = startAddress * 2;
 
     // Copy Data
-    for (int i = 0; i < numRegisters; i++) {
-        to[2 * i + startByte] = (uint8_t)(from[i] >> 8);
-        to[2 * i + startByte + 1] = (uint8_t)(from[i] & 0x00FF);
-    }
+    store_registers(std::span(from).first(numRegisters), to.data() + startByte);
 }
 
 } // namespace modbus
@@ -9,6 +9,7 @@
 #include <boost/asio/experimental/awaitable_operators.hpp>
 
 #include "modbus/core/tcp_data_unit.hpp"
+#include "modbus/core/tcp_data_unit_view.hpp"
 
 namespace modbus {
 
@@ -27,4 +28,9 @@ constexpr uint16_t DEFAULT_SERVER_MAX_CONNECTIONS = 4;
 using request_handler_t =
     std::function<awaitable<tcp_data_unit>(const tcp_data_unit&)>;
 
+/// Handles a request that is parsed in place over the receive buffer of the
+/// session. The view is valid until the returned awaitable completes.
+using request_view_handler_t =
+    std::function<awaitable<tcp_data_unit>(tcp_data_unit_view)>;
+
 } // namespace modbus
@@ -8,6 +8,17 @@ namespace modbus {
 
 tcp_server::tcp_server(asio::any_io_executor exec, request_handler_t handler,
                        server_config config)
+    : tcp_server(
+          exec,
+          [handler, frames = config.frames](
+              tcp_data_unit_view request) -> awaitable<tcp_data_unit> {
+              // the owning copy must outlive the handler's coroutine
+              co_return co_await handler(tcp_data_unit(request, *frames));
+          },
+          config) {}
+
+tcp_server::tcp_server(asio::any_io_executor exec,
+                       request_view_handler_t handler, server_config config)
     : exec_(exec)
     , config_(config)
     , acceptor_(exec)
@@ -23,6 +23,9 @@ class tcp_server {
     tcp_server(asio::any_io_executor exec, request_handler_t handler,
                server_config config);
 
+    tcp_server(asio::any_io_executor exec, request_view_handler_t handler,
+               server_config config);
+
     tcp_server(const tcp_server&) = delete;
 
     /// Start the server and start processing request.
@@ -36,7 +39,7 @@ class tcp_server {
     server_config config_;
     tcp::acceptor acceptor_;
     tcp_session_manager session_manager_;
-    request_handler_t request_handler_;
+    request_view_handler_t request_handler_;
     logging_handler_t on_log_;
     std::atomic_bool stop_;
 };
@@ -7,22 +7,32 @@ namespace modbus {
 
 tcp_session::tcp_session(tcp::socket socket,
                          tcp_session_manager& session_manager,
-                         request_handler_t handler, logging_handler_t on_log)
+                         request_view_handler_t handler,
+                         logging_handler_t on_log)
     : socket_(std::move(socket))
     , session_manager_(session_manager)
     , request_handler_(handler)
+    , logging_(is_logging(on_log))
     , on_log_(on_log)
     , stop_(false) {}
 
 awaitable<void> tcp_session::start() {
     auto endpoint = socket_.remote_endpoint().address().to_string();
-    buffer_t buf(MAX_APU_SIZE);
+
+    // requests are parsed in place over the receive buffer of the framer and
+    // the responses to every request in a chunk are sent with a single write
+    tcp_framer framer(message_type::request);
+    buffer_t responseBuffer(DEFAULT_FRAMER_CAPACITY);
+    tcp_frame_writer writer(responseBuffer);
 
     while (!stop_) {
         on_log_(log_level::trace, "waiting for request");
+        auto space = framer.prepare();
         auto [read_err, bytes_read] = co_await socket_.async_read_some(
-            asio::buffer(buf), as_tuple(use_awaitable));
-        on_log_(log_level::debug, fmt::format("read {} bytes", bytes_read));
+            asio::buffer(space.data(), space.size()), as_tuple(use_awaitable));
+        if (logging_) {
+            on_log_(log_level::debug, fmt::format("read {} bytes", bytes_read));
+        }
         if (read_err && read_err != asio::error::operation_aborted) {
             if (read_err == asio::error::eof) {
                 on_log_(log_level::info,
@@ -39,34 +49,65 @@ awaitable<void> tcp_session::start() {
         } else if (read_err == asio::error::operation_aborted) {
             break;
         }
+        framer.commit(bytes_read);
 
-        if (bytes_read < TCP_HEADER_SIZE + MIN_PDU_SIZE) {
-            on_log_(log_level::error,
-                    fmt::format("malformed message from {}", endpoint));
-            continue;
-        }
+        // the framer is not touched until every handler has completed
+        while (auto request = framer.next()) {
+            on_log_(log_level::trace, "processing request");
+            auto response = co_await request_handler_(*request);
+            on_log_(log_level::trace, "created response");
+            if (response.bytes().empty()) {
+                continue;
+            }
 
-        auto request = tcp_data_unit{buf, bytes_read, message_type::request};
-        on_log_(log_level::trace, "processing request");
-        auto response = co_await request_handler_(request);
-        on_log_(log_level::trace, "created response");
+            if (writer.append(response.bytes()) == 0) {
+                if (!co_await write_responses(writer, endpoint)) {
+                    co_return;
+                }
+                writer.append(response.bytes());
+            }
+        }
 
-        auto [write_err, bytes_written] = co_await socket_.async_write_some(
-            asio::buffer(*(response.buffer())), as_tuple(use_awaitable));
+        if (!writer.empty() && !co_await write_responses(writer, endpoint)) {
+            co_return;
+        }
 
-        on_log_(log_level::debug, fmt::format("wrote {} bytes", bytes_written));
-        if (write_err && write_err != asio::error::operation_aborted) {
-            session_manager_.stop(shared_from_this());
+        // a malformed header leaves no way to find the start of the next
+        // frame
+        if (framer.error() != modbus_error_code::success) {
             on_log_(log_level::error,
-                    fmt::format("unanticipated write error {}; client: {}",
-                                read_err.message(), endpoint));
-            break;
-        } else if (read_err == asio::error::operation_aborted) {
+                    fmt::format("malformed message from {}; {}", endpoint,
+                                make_error_code(framer.error()).message()));
+            session_manager_.stop(shared_from_this());
             break;
         }
     }
 }
 
+awaitable<bool> tcp_session::write_responses(tcp_frame_writer& writer,
+                                             const std::string& endpoint) {
+    auto [write_err, bytes_written] = co_await asio::async_write(
+        socket_, asio::buffer(writer.data().data(), writer.size()),
+        as_tuple(use_awaitable));
+    writer.clear();
+
+    if (logging_) {
+        on_log_(log_level::debug,
+                fmt::format("wrote {} bytes", bytes_written));
+    }
+    if (write_err && write_err != asio::error::operation_aborted) {
+        session_manager_.stop(shared_from_this());
+        on_log_(log_level::error,
+                fmt::format("unanticipated write error {}; client: {}",
+                            write_err.message(), endpoint));
+        co_return false;
+    } else if (write_err == asio::error::operation_aborted) {
+        co_return false;
+    }
+
+    co_return true;
+}
+
 void tcp_session::stop() {
     stop_ = true;
     boost::system::error_code ignored_err;
@@ -8,6 +8,8 @@
 #include <string>
 #include <vector>
 
+#include "modbus/core/encode.hpp"
+#include "modbus/core/tcp_framer.hpp"
 #include "modbus/core/types.hpp"
 #include "server_types.hpp"
 
@@ -20,7 +22,8 @@ class tcp_session : public std::enable_shared_from_this<tcp_session> {
   public:
     explicit tcp_session(tcp::socket socket,
                          tcp_session_manager& session_manager,
-                         request_handler_t handler, logging_handler_t on_log);
+                         request_view_handler_t handler,
+                         logging_handler_t on_log);
 
     tcp_session(const tcp_session&) = delete;
     tcp_session& operator=(const tcp_session&) = delete;
@@ -32,13 +35,21 @@ class tcp_session : public std::enable_shared_from_this<tcp_session> {
     void stop();
 
   private:
+    /// Writes the responses held by writer and clears it. Returns false if the
+    /// session should end.
+    awaitable<bool> write_responses(tcp_frame_writer& writer,
+                                    const std::string& endpoint);
+
     /// Socket for the session
     tcp::socket socket_;
 
     /// The manager for this session
     tcp_session_manager& session_manager_;
 
-    request_handler_t request_handler_;
+    request_view_handler_t request_handler_;
+    /// Whether on_log_ goes anywhere; debug messages are only formatted if it
+    /// does.
+    bool logging_;
     logging_handler_t on_log_;
 
     std::atomic_bool stop_;
@@ -0,0 +1,131 @@
+#include "modbus/core/bit_pack.hpp"
+#include "modbus/core/modbus_response.hpp"
+#include "modbus/core/register_span.hpp"
+#include "modbus/core/requests.hpp"
+#include "modbus/core/responses.hpp"
+
+#include <memory>
+#include <random>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace modbus;
+using namespace std;
+
+/// Packs bits one at a time, as the messages used to.
+buffer_t pack_reference(const vector<uint8_t>& bits) {
+    buffer_t packed((bits.size() + 7) / 8);
+    for (size_t i = 0; i < bits.size(); i++) {
+        if (bits[i]) {
+            packed[i / 8] |= 1 << (i % 8);
+        }
+    }
+    return packed;
+}
+
+TEST(bit_pack, pack_bits) {
+    bool coils[]{true, false, true, true, false, false, true, true,
+                 true, true, false, true, false, true, true, false,
+                 true, false, true};
+    buffer_t packed(3, 0xFF);
+    EXPECT_EQ(pack_bits(coils, packed.data()), packed.data() + 3);
+    EXPECT_EQ(packed, (buffer_t{0xCD, 0x6B, 0x05}));
+
+    // any value other than 0 is on
+    uint8_t bytes[]{0x00, 0x80, 0x01, 0xFF, 0x00, 0x00, 0x00, 0x10};
+    EXPECT_EQ(pack_bits(bytes, packed.data()), packed.data() + 1);
+    EXPECT_EQ(packed[0], 0x8E);
+}
+
+TEST(bit_pack, all_lengths) {
+    mt19937 random(1234);
+
+    // cover every vector width and the tail
+    for (size_t count : {0, 1, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65,
+                         1968, 2000}) {
+        vector<uint8_t> bits(count);
+        for (auto& bit : bits) {
+            bit = random() % 2;
+        }
+
+        auto expected = pack_reference(bits);
+        buffer_t packed(expected.size());
+        pack_bits(std::span<const uint8_t>(bits), packed.data());
+        EXPECT_EQ(packed, expected) << count;
+
+        // keep a sentinel after the unpacked bits
+        vector<uint8_t> unpacked(count + 1, 0xA5);
+        unpack_bits(packed.data(), std::span(unpacked).first(count));
+        EXPECT_EQ(unpacked.back(), 0xA5) << count;
+        unpacked.pop_back();
+        EXPECT_EQ(unpacked, bits) << count;
+    }
+}
+
+TEST(bit_pack, unpack_offset) {
+    buffer_t packed{0xCD, 0x6B, 0x05};
+    coil_span coils(packed);
+
+    for (size_t first = 0; first < 16; first++) {
+        bool out[8];
+        unpack_bits(packed.data(), first, out);
+        for (size_t i = 0; i < 8; i++) {
+            EXPECT_EQ(out[i], coils[first + i]) << first;
+        }
+    }
+}
+
+TEST(bit_pack, words) {
+    buffer_t packed{0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09};
+
+    uint64_t words[3];
+    EXPECT_EQ(unpack_words(packed, words), 2);
+    EXPECT_EQ(words[0], 0x0807060504030201);
+    EXPECT_EQ(words[1], 0x09);
+    EXPECT_EQ(words[2], 0);
+
+    auto bits = unpack_bitset<72>(packed);
+    EXPECT_TRUE(bits[0]);
+    EXPECT_TRUE(bits[9]);
+    EXPECT_TRUE(bits[64]);
+    EXPECT_EQ(bits.count(), 15);
+
+    auto low = unpack_bitset<10>(packed);
+    EXPECT_EQ(low.to_ulong(), 0x201);
+}
+
+TEST(bit_pack, messages) {
+    bool coils[]{true, false, true, true, false, false, true, true,
+                 true, true, false, true, false, true, true, false,
+                 true, false, true};
+
+    write_multiple_coils_request request{17, 19, coils};
+    write_multiple_coils_request expected{
+        17, 19, vector<bool>(std::begin(coils), std::end(coils))};
+    EXPECT_EQ(request, expected);
+    EXPECT_EQ(request.length, 19);
+    EXPECT_EQ(request.values, (buffer_t{0xCD, 0x6B, 0x05}));
+
+    read_coils_response response{17, coils};
+    EXPECT_EQ(response.values, request.values);
+    read_discrete_inputs_response inputs{17, coils};
+    EXPECT_EQ(inputs.inputs, request.values);
+
+    bool unpacked[19];
+    EXPECT_EQ(coil_span(response.values).copy_to(unpacked), 19);
+    EXPECT_TRUE(equal(std::begin(coils), std::end(coils), unpacked));
+
+    modbus_response_t data(data_model_t::coil,
+                           make_shared<buffer_t>(response.values), 19, 19);
+    bool block[24];
+    EXPECT_EQ(data.getBools(3, block), 21);
+    for (size_t i = 0; i < 16; i++) {
+        EXPECT_EQ(block[i], data.getBool(3 + i));
+    }
+    EXPECT_EQ(data.getBools(24, block), 0);
+}
+
+} // namespace
@@ -0,0 +1,162 @@
+#include "modbus/core/decode.hpp"
+#include "modbus/core/requests.hpp"
+#include "modbus/core/responses.hpp"
+#include "modbus/core/tcp_data_unit_view.hpp"
+#include "modbus/core/views.hpp"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace modbus;
+using namespace std;
+
+TEST(decode, read_coils_request) {
+    read_coils_request request{17, 19, 37};
+    buffer_t data{0x11, 0x01, 0x00, 0x13, 0x00, 0x25};
+
+    auto result = decode<read_coils_request>(data);
+    EXPECT_TRUE(result);
+    EXPECT_EQ(*result, request);
+
+    // the wrong function code is rejected
+    auto wrongType = decode<read_discrete_inputs_request>(data);
+    EXPECT_FALSE(wrongType);
+    EXPECT_EQ(wrongType.error(), modbus_error_code::invalid_function_code);
+
+    // trailing bytes are rejected
+    buffer_t trailing{0x11, 0x01, 0x00, 0x13, 0x00, 0x25, 0x00};
+    EXPECT_EQ(decode<read_coils_request>(trailing).error(),
+              modbus_error_code::invalid_length);
+
+    // quantity must be between 1 and 2000
+    buffer_t zero{0x11, 0x01, 0x00, 0x13, 0x00, 0x00};
+    EXPECT_EQ(decode<read_coils_request>(zero).error(),
+              modbus_error_code::invalid_quantity);
+    buffer_t tooMany{0x11, 0x01, 0x00, 0x13, 0x07, 0xD1};
+    EXPECT_EQ(decode<read_coils_request>(tooMany).error(),
+              modbus_error_code::invalid_quantity);
+}
+
+TEST(decode, read_holding_registers_response) {
+    read_holding_registers_response response{
+        17, std::vector<uint16_t>{0x022B, 0x0000, 0x0064}};
+    buffer_t data{0x11, 0x03, 0x06, 0x02, 0x2B, 0x00, 0x00, 0x00, 0x64};
+
+    auto result = decode<read_holding_registers_response>(data);
+    EXPECT_TRUE(result);
+    EXPECT_EQ(*result, response);
+
+    auto view = decode<read_holding_registers_response_view>(data);
+    EXPECT_TRUE(view);
+    EXPECT_EQ(view->values.bytes().data(), data.data() + 3);
+
+    // the byte count must describe whole registers
+    buffer_t oddBytes{0x11, 0x03, 0x05, 0x02, 0x2B, 0x00, 0x00, 0x00};
+    EXPECT_EQ(decode<read_holding_registers_response>(oddBytes).error(),
+              modbus_error_code::invalid_byte_count);
+
+    // the byte count must match the PDU
+    buffer_t truncated{0x11, 0x03, 0x06, 0x02, 0x2B, 0x00, 0x00};
+    EXPECT_EQ(decode<read_holding_registers_response>(truncated).error(),
+              modbus_error_code::invalid_length);
+}
+
+TEST(decode, write_multiple_requests) {
+    buffer_t coils{0x11, 0x0F, 0x00, 0x13, 0x00, 0x0A, 0x02, 0xCD, 0x01};
+    EXPECT_TRUE(decode<write_multiple_coils_request>(coils));
+
+    buffer_t wrongCount{0x11, 0x0F, 0x00, 0x13, 0x00, 0x0A, 0x01, 0xCD};
+    EXPECT_EQ(decode<write_multiple_coils_request>(wrongCount).error(),
+              modbus_error_code::invalid_byte_count);
+
+    buffer_t registers{0x11, 0x10, 0x00, 0x01, 0x00, 0x02,
+                       0x04, 0x00, 0x0A, 0x01, 0x02};
+    EXPECT_TRUE(decode<write_multiple_registers_request>(registers));
+    EXPECT_TRUE(decode<write_multiple_registers_request_view>(registers));
+
+    // 124 registers is more than a single request may write
+    buffer_t tooMany{0x11, 0x10, 0x00, 0x01, 0x00, 0x7C, 0xF8};
+    EXPECT_EQ(decode<write_multiple_registers_request>(tooMany).error(),
+              modbus_error_code::invalid_quantity);
+}
+
+TEST(decode, read_write_registers_request) {
+    read_write_registers_request request{17, 3, 6, 14,
+                                         std::vector<uint16_t>{0x00FF}};
+    buffer_t data(request.size());
+    request.serialize(data.data());
+
+    auto result = decode<read_write_registers_request>(data);
+    EXPECT_TRUE(result);
+    EXPECT_EQ(*result, request);
+
+    data[10] = 0x04;
+    EXPECT_EQ(decode<read_write_registers_request>(data).error(),
+              modbus_error_code::invalid_byte_count);
+}
+
+TEST(decode, exception_response) {
+    exception_response response{17, function_code_t::read_coils,
+                                exception_code_t::illegal_data_address};
+    buffer_t data{0x11, 0x81, 0x02};
+
+    auto result = decode<exception_response>(data);
+    EXPECT_TRUE(result);
+    EXPECT_EQ(*result, response);
+
+    EXPECT_EQ(decode<read_coils_response>(data).error(),
+              modbus_error_code::invalid_function_code);
+
+    buffer_t notException{0x11, 0x01, 0x01, 0x00};
+    EXPECT_EQ(decode<exception_response>(notException).error(),
+              modbus_error_code::invalid_function_code);
+
+    // requests cannot be exceptions
+    EXPECT_EQ(validate_pdu(data, message_type::request),
+              modbus_error_code::invalid_function_code);
+}
+
+TEST(decode, validate_pdu) {
+    buffer_t empty;
+    EXPECT_EQ(validate_pdu(empty, message_type::request),
+              modbus_error_code::invalid_length);
+
+    buffer_t unknown{0x11, 0x2B, 0x0E, 0x01, 0x00};
+    EXPECT_EQ(validate_pdu(unknown, message_type::request),
+              modbus_error_code::invalid_function_code);
+
+    buffer_t maskWrite{0x11, 0x16, 0x00, 0x04, 0x00, 0xF2, 0x00, 0x25};
+    EXPECT_EQ(validate_pdu(maskWrite, message_type::request),
+              modbus_error_code::success);
+    EXPECT_EQ(validate_pdu(maskWrite, message_type::response),
+              modbus_error_code::success);
+}
+
+TEST(decode, decode_frame) {
+    buffer_t data{0x00, 0x01, 0x00, 0x00, 0x00, 0x06, 0x11,
+                  0x01, 0x00, 0x13, 0x00, 0x25, 0xFF};
+
+    auto frame = decode_frame(data, message_type::request);
+    EXPECT_TRUE(frame);
+    EXPECT_EQ(frame->transaction_id(), 0x0001);
+    EXPECT_EQ(frame->buffer().size(), data.size() - 1);
+    EXPECT_TRUE(frame->pdu<read_coils_request>());
+
+    buffer_t shortHeader{0x00, 0x01, 0x00, 0x00, 0x00};
+    EXPECT_EQ(decode_frame(shortHeader, message_type::request).error(),
+              modbus_error_code::invalid_length);
+
+    buffer_t badProtocol{0x00, 0x01, 0x00, 0x01, 0x00, 0x06,
+                         0x11, 0x01, 0x00, 0x13, 0x00, 0x25};
+    EXPECT_EQ(decode_frame(badProtocol, message_type::request).error(),
+              modbus_error_code::invalid_protocol_id);
+
+    buffer_t truncated{0x00, 0x01, 0x00, 0x00, 0x00, 0x06,
+                       0x11, 0x01, 0x00, 0x13};
+    EXPECT_EQ(decode_frame(truncated, message_type::request).error(),
+              modbus_error_code::invalid_length);
+}
+
+} // namespace
@@ -0,0 +1,246 @@
+#include "modbus/client.hpp"
+#include "modbus/server.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace modbus;
+using namespace std;
+
+const uint16_t FLEET_PORT = 5080;
+/// Nothing listens on this port.
+const uint16_t CLOSED_PORT = 5081;
+const size_t DEVICES = 5;
+const size_t BUSY_REQUESTS = 20;
+const size_t BUDGET = 2;
+/// Requests to this unit are answered after SLOW_WAIT instead of 2ms.
+const uint8_t SLOW_UNIT = 2;
+const std::chrono::milliseconds SLOW_WAIT = 100ms;
+
+/// The number of requests the server is handling.
+size_t serverInFlight = 0;
+/// The most requests the server handled at once.
+size_t serverMaxInFlight = 0;
+
+/// Answers read_holding_registers_request with zeroes after 2ms, or after
+/// SLOW_WAIT for SLOW_UNIT.
+awaitable<tcp_data_unit> fleet_handler(tcp_data_unit_view request) {
+    auto optionalRequest = request.pdu<read_holding_registers_request>();
+    if (!optionalRequest) {
+        co_return tcp_data_unit(
+            request.transaction_id(),
+            exception_response(request.unit_id(), request.function_code(),
+                               exception_code_t::illegal_function));
+    }
+
+    serverInFlight++;
+    serverMaxInFlight = max(serverMaxInFlight, serverInFlight);
+    asio::steady_timer timer(co_await asio::this_coro::executor,
+                             request.unit_id() == SLOW_UNIT
+                                 ? SLOW_WAIT
+                                 : std::chrono::milliseconds(2));
+    co_await timer.async_wait(use_awaitable);
+    serverInFlight--;
+
+    co_return tcp_data_unit(
+        request.transaction_id(),
+        read_holding_registers_response(
+            request.unit_id(), vector<uint16_t>(optionalRequest->length)));
+}
+
+awaitable<void> read_device(device_fleet& fleet, device_id device,
+                            vector<device_id>& completed) {
+    auto [response, error] = co_await fleet.send_request(
+        device,
+        fleet.create_request(read_holding_registers_request{1, 0, 4}), 5s);
+    EXPECT_FALSE(error) << error.message();
+    EXPECT_EQ(response.function_code(),
+              function_code_t::read_holding_registers);
+    completed.push_back(device);
+}
+
+awaitable<void> run_fleet(asio::io_context& ctx, tcp_server& server,
+                          device_fleet& fleet, vector<device_id>& devices,
+                          vector<device_id>& completed) {
+    asio::steady_timer timer(ctx, 50ms);
+    co_await timer.async_wait(use_awaitable);
+
+    // the busy device queues all of its requests before the others
+    for (size_t i = 0; i < BUSY_REQUESTS; i++) {
+        co_spawn(ctx, read_device(fleet, devices[0], completed), detached);
+    }
+    for (size_t i = 1; i < devices.size(); i++) {
+        co_spawn(ctx, read_device(fleet, devices[i], completed), detached);
+    }
+
+    timer.expires_after(1ms);
+    co_await timer.async_wait(use_awaitable);
+    EXPECT_LE(fleet.in_flight(), BUDGET);
+    EXPECT_EQ(fleet.in_flight(devices[0]), 1);
+
+    while (completed.size() < BUSY_REQUESTS + devices.size() - 1) {
+        timer.expires_after(10ms);
+        co_await timer.async_wait(use_awaitable);
+    }
+
+    // a device that cannot be reached only fails its own requests
+    auto closed = fleet.add_device("127.0.0.1", CLOSED_PORT);
+    auto [response, error] = co_await fleet.send_request(
+        closed, fleet.create_request(read_holding_registers_request{1, 0, 1}),
+        1s);
+    EXPECT_TRUE(error);
+    EXPECT_EQ(fleet.stats(closed).failures, 1);
+    EXPECT_FALSE(fleet.connected(closed));
+
+    server.stop();
+    ctx.stop();
+}
+
+/// Reads from SLOW_UNIT and records how the read ended.
+awaitable<void> read_slow(device_fleet& fleet, device_id device,
+                          std::chrono::milliseconds timeout,
+                          cpool::error& result, bool& done) {
+    auto [response, error] = co_await fleet.send_request(
+        device,
+        fleet.create_request(read_holding_registers_request{SLOW_UNIT, 0, 1}),
+        timeout);
+    result = error;
+    done = true;
+}
+
+awaitable<void> run_abandoned_turns(asio::io_context& ctx, tcp_server& server,
+                                    device_fleet& fleet, device_id device) {
+    asio::steady_timer timer(ctx, 50ms);
+    co_await timer.async_wait(use_awaitable);
+
+    // the first request holds the only turn of the device
+    cpool::error firstError;
+    bool firstDone = false;
+    co_spawn(ctx, read_slow(fleet, device, 5s, firstError, firstDone),
+             detached);
+
+    asio::cancellation_signal signal;
+    cpool::error cancelledError;
+    bool cancelledDone = false;
+    co_spawn(ctx,
+             read_slow(fleet, device, 5s, cancelledError, cancelledDone),
+             asio::bind_cancellation_slot(signal.slot(), detached));
+    timer.expires_after(1ms);
+    co_await timer.async_wait(use_awaitable);
+    EXPECT_EQ(fleet.queued(device), 1);
+
+    // a cancelled request leaves the queue and is never granted a turn
+    signal.emit(asio::cancellation_type::terminal);
+    timer.expires_after(1ms);
+    co_await timer.async_wait(use_awaitable);
+    EXPECT_TRUE(cancelledDone);
+    EXPECT_EQ(cancelledError.value(),
+              (int)modbus_client_error_code::cancelled);
+    EXPECT_EQ(fleet.queued(device), 0);
+
+    // a request that runs out of time leaves the queue at its deadline
+    cpool::error expiredError;
+    bool expiredDone = false;
+    co_spawn(ctx, read_slow(fleet, device, 10ms, expiredError, expiredDone),
+             detached);
+    timer.expires_after(30ms);
+    co_await timer.async_wait(use_awaitable);
+    EXPECT_TRUE(expiredDone);
+    EXPECT_EQ(expiredError.value(),
+              (int)modbus_client_error_code::write_timeout);
+    EXPECT_EQ(fleet.queued(device), 0);
+    EXPECT_FALSE(firstDone);
+
+    // the device still takes requests once the first is answered
+    cpool::error lastError;
+    bool lastDone = false;
+    co_await read_slow(fleet, device, 5s, lastError, lastDone);
+    EXPECT_TRUE(firstDone);
+    EXPECT_FALSE(firstError) << firstError.message();
+    EXPECT_FALSE(lastError) << lastError.message();
+
+    const auto& stats = fleet.stats(device);
+    EXPECT_EQ(stats.requests, 4);
+    EXPECT_EQ(stats.failures, 2);
+    EXPECT_EQ(stats.timeouts, 1);
+    EXPECT_EQ(fleet.in_flight(), 0);
+
+    server.stop();
+    ctx.stop();
+}
+
+TEST(device_fleet, devices_share_the_budget_fairly) {
+    asio::io_context ctx(1);
+
+    server_config sconfig = server_config{std::string("0.0.0.0"), FLEET_PORT}
+                                .set_logging_handler(print_logging_handler);
+    tcp_server server(ctx.get_executor(),
+                      request_view_handler_t(fleet_handler), sconfig);
+    co_spawn(ctx, server.start(), detached);
+
+    device_fleet fleet(ctx.get_executor(),
+                       fleet_config()
+                           .set_max_in_flight(BUDGET)
+                           .set_connect_timeout(1s)
+                           .set_logging_handler(print_logging_handler));
+    vector<device_id> devices;
+    for (size_t i = 0; i < DEVICES; i++) {
+        devices.push_back(fleet.add_device("127.0.0.1", FLEET_PORT));
+    }
+    EXPECT_EQ(fleet.size(), DEVICES);
+    EXPECT_FALSE(fleet.connected(devices[0]));
+
+    vector<device_id> completed;
+    co_spawn(ctx, run_fleet(ctx, server, fleet, devices, completed),
+             detached);
+    ctx.run_for(10s);
+
+    ASSERT_EQ(completed.size(), BUSY_REQUESTS + DEVICES - 1);
+    EXPECT_LE(serverMaxInFlight, BUDGET);
+
+    // the other devices take turns with the busy one instead of waiting
+    // behind its whole queue
+    auto lastOther =
+        find_if(completed.rbegin(), completed.rend(),
+                [&](device_id id) { return id != devices[0]; });
+    EXPECT_LT(completed.rend() - lastOther, (ptrdiff_t)(DEVICES * 2));
+
+    const auto& busy = fleet.stats(devices[0]);
+    EXPECT_EQ(busy.requests, BUSY_REQUESTS);
+    EXPECT_EQ(busy.responses(), BUSY_REQUESTS);
+    EXPECT_EQ(busy.connects, 1);
+    EXPECT_GE(busy.max_latency, 2ms);
+    EXPECT_LE(busy.mean_latency(), busy.max_latency);
+    for (size_t i = 1; i < DEVICES; i++) {
+        EXPECT_EQ(fleet.stats(devices[i]).responses(), 1);
+        EXPECT_TRUE(fleet.connected(devices[i]));
+    }
+}
+
+TEST(device_fleet, abandoned_requests_leave_the_queue) {
+    asio::io_context ctx(1);
+
+    server_config sconfig =
+        server_config{std::string("0.0.0.0"), FLEET_PORT + 2}
+            .set_logging_handler(print_logging_handler);
+    tcp_server server(ctx.get_executor(),
+                      request_view_handler_t(fleet_handler), sconfig);
+    co_spawn(ctx, server.start(), detached);
+
+    device_fleet fleet(ctx.get_executor(),
+                       fleet_config().set_logging_handler(
+                           print_logging_handler));
+    auto device = fleet.add_device("127.0.0.1", FLEET_PORT + 2);
+
+    co_spawn(ctx, run_abandoned_turns(ctx, server, fleet, device), detached);
+    ctx.run_for(10s);
+
+    EXPECT_EQ(fleet.stats(device).responses(), 2);
+}
+
+} // namespace
@@ -0,0 +1,86 @@
+#include <array>
+
+#include "modbus/core/encode.hpp"
+#include "modbus/core/requests.hpp"
+#include "modbus/core/responses.hpp"
+#include "modbus/core/tcp_data_unit.hpp"
+#include "modbus/core/tcp_data_unit_view.hpp"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace modbus;
+using namespace std;
+
+TEST(encode, read_coils_request) {
+    read_coils_request request{17, 19, 37};
+    buffer_t expected{0x00, 0x01, 0x00, 0x00, 0x00, 0x06,
+                      0x11, 0x01, 0x00, 0x13, 0x00, 0x25};
+
+    std::array<uint8_t, MAX_APU_SIZE> buffer{};
+    size_t written = encode(0x0001, request, buffer);
+    EXPECT_EQ(written, expected.size());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), buffer.begin()));
+
+    tcp_data_unit dataUnit(0x0001, request);
+    EXPECT_EQ(*dataUnit.buffer(), expected);
+}
+
+TEST(encode, buffer_too_small) {
+    write_multiple_registers_request request{17, 1, 2,
+                                             std::vector<uint16_t>{10, 258}};
+    buffer_t buffer(TCP_HEADER_SIZE + request.size() - 1, 0xFF);
+
+    EXPECT_EQ(encode(0x000F, request, buffer), 0);
+    EXPECT_THAT(buffer, testing::Each(0xFF));
+}
+
+TEST(encode, round_trip) {
+    read_holding_registers_response response{
+        17, std::vector<uint16_t>{0x022B, 0x0000, 0x0064}};
+
+    std::array<uint8_t, MAX_APU_SIZE> buffer{};
+    size_t written = encode(0x0042, response, buffer);
+    ASSERT_GT(written, 0);
+
+    std::span<const uint8_t> frame(buffer.data(), written);
+    tcp_data_unit_view view(frame, message_type::response);
+    EXPECT_EQ(view.transaction_id(), 0x0042);
+    auto optionalResponse = view.pdu<read_holding_registers_response>();
+    EXPECT_TRUE(optionalResponse);
+    EXPECT_EQ(response, optionalResponse.value());
+}
+
+TEST(encode, frame_writer) {
+    read_coils_request first{17, 19, 37};
+    write_single_register_request second{17, 1, 3};
+    std::array<uint8_t, 2 * (TCP_HEADER_SIZE + 6) + 2> buffer{};
+
+    tcp_frame_writer writer(buffer);
+    EXPECT_TRUE(writer.empty());
+    EXPECT_EQ(writer.append(0x0001, first), TCP_HEADER_SIZE + first.size());
+    EXPECT_EQ(writer.append(0x0002, second), TCP_HEADER_SIZE + second.size());
+    EXPECT_EQ(writer.remaining(), 2);
+    EXPECT_EQ(writer.append(0x0003, first), 0);
+
+    // both frames can be parsed back out of the same buffer
+    auto frames = writer.data();
+    tcp_data_unit_view firstView(frames, message_type::request);
+    EXPECT_EQ(firstView.transaction_id(), 0x0001);
+    EXPECT_EQ(firstView.pdu<read_coils_request>().value(), first);
+
+    tcp_data_unit_view secondView(
+        frames.subspan(firstView.buffer().size()), message_type::request);
+    EXPECT_EQ(secondView.transaction_id(), 0x0002);
+    EXPECT_EQ(secondView.pdu<write_single_register_request>().value(), second);
+
+    tcp_data_unit encoded(0x0003, first);
+    writer.clear();
+    EXPECT_EQ(writer.append(encoded.view().buffer()),
+              encoded.buffer()->size());
+    EXPECT_EQ(writer.size(), encoded.buffer()->size());
+}
+
+} // namespace
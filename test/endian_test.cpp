@@ -0,0 +1,61 @@
+#include "modbus/core/endian.hpp"
+#include "modbus/core/register_span.hpp"
+#include "modbus/core/responses.hpp"
+
+#include <numeric>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace modbus;
+using namespace std;
+
+TEST(endian, store_registers) {
+    vector<uint16_t> registers{0x022B, 0x0000, 0x0064};
+    buffer_t expected{0x02, 0x2B, 0x00, 0x00, 0x00, 0x64};
+
+    buffer_t data(registers.size() * 2);
+    EXPECT_EQ(store_registers(registers, data.data()), data.data() + 6);
+    EXPECT_EQ(data, expected);
+
+    vector<uint16_t> loaded(registers.size());
+    EXPECT_EQ(load_registers(data.data(), loaded), data.data() + 6);
+    EXPECT_EQ(loaded, registers);
+}
+
+TEST(endian, all_lengths) {
+    // cover every vector width and the scalar tail
+    for (size_t count : {0, 1, 7, 8, 9, 15, 16, 17, 31, 32, 33, 125, 65536}) {
+        vector<uint16_t> registers(count);
+        iota(registers.begin(), registers.end(), (uint16_t)0x0102);
+
+        // keep a sentinel after the converted bytes
+        buffer_t data(count * 2 + 1, 0xA5);
+        store_registers(registers, data.data());
+        for (size_t i = 0; i < count; i++) {
+            ASSERT_EQ(data[2 * i], registers[i] >> 8) << count;
+            ASSERT_EQ(data[2 * i + 1], registers[i] & 0xFF) << count;
+        }
+        EXPECT_EQ(data.back(), 0xA5);
+
+        vector<uint16_t> loaded(count);
+        load_registers(data.data(), loaded);
+        EXPECT_EQ(loaded, registers);
+    }
+}
+
+TEST(endian, messages) {
+    vector<uint16_t> registers(125);
+    iota(registers.begin(), registers.end(), (uint16_t)0xFF00);
+
+    read_holding_registers_response response{17, registers};
+    EXPECT_EQ(register_span(response.values).to_vector(), registers);
+
+    buffer_t data(response.size());
+    response.serialize(data.data());
+    EXPECT_EQ(read_holding_registers_response(data.data()), response);
+}
+
+} // namespace
@@ -0,0 +1,113 @@
+#include <thread>
+#include <vector>
+
+#include "modbus/core/frame_pool.hpp"
+#include "modbus/core/requests.hpp"
+#include "modbus/core/tcp_data_unit.hpp"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace modbus;
+using namespace std;
+
+TEST(frame_pool, acquire_release) {
+    frame_pool pool(2);
+    EXPECT_EQ(pool.capacity(), 2);
+    EXPECT_EQ(pool.available(), 2);
+
+    frame* first = nullptr;
+    {
+        frame_ptr f = pool.acquire(12);
+        ASSERT_TRUE(f);
+        EXPECT_EQ(f->size, 12);
+        EXPECT_EQ(f.bytes().size(), 12);
+        EXPECT_EQ(pool.available(), 1);
+        first = f.get();
+
+        frame_ptr copy = f;
+        EXPECT_EQ(copy.get(), first);
+        EXPECT_EQ(f->refs.load(), 2);
+    }
+
+    // the frame is recycled rather than freed
+    EXPECT_EQ(pool.available(), 2);
+    frame_ptr f = pool.acquire();
+    EXPECT_EQ(f.get(), first);
+    EXPECT_THROW(pool.acquire(MAX_APU_SIZE + 1), std::out_of_range);
+    EXPECT_THROW(frame_pool(0), std::invalid_argument);
+}
+
+TEST(frame_pool, exhausted) {
+    frame_pool pool(1);
+    frame_ptr pooled = pool.acquire();
+    frame_ptr heap = pool.acquire();
+
+    EXPECT_TRUE(heap);
+    EXPECT_NE(heap.get(), pooled.get());
+    EXPECT_EQ(heap->slab, nullptr);
+    EXPECT_EQ(pool.available(), 0);
+
+    heap = frame_ptr();
+    EXPECT_EQ(pool.available(), 0);
+    pooled = frame_ptr();
+    EXPECT_EQ(pool.available(), 1);
+}
+
+TEST(frame_pool, outlives_pool) {
+    frame_ptr f;
+    {
+        frame_pool pool(4);
+        f = pool.acquire(3);
+        f->data[0] = 0xAB;
+    }
+
+    // the slab stays alive until the last frame is released
+    EXPECT_EQ(f->data[0], 0xAB);
+    EXPECT_EQ(f.bytes().size(), 3);
+}
+
+TEST(frame_pool, concurrent) {
+    frame_pool pool(8);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&pool]() {
+            for (int i = 0; i < 10000; i++) {
+                frame_ptr a = pool.acquire(1);
+                frame_ptr b = pool.acquire(1);
+                a->data[0] = 1;
+                b->data[0] = 2;
+                EXPECT_NE(a.get(), b.get());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(pool.available(), pool.capacity());
+}
+
+TEST(frame_pool, tcp_data_unit) {
+    frame_pool pool(1);
+    read_coils_request request{17, 19, 37};
+    buffer_t data{0x00, 0x01, 0x00, 0x00, 0x00, 0x06,
+                  0x11, 0x01, 0x00, 0x13, 0x00, 0x25};
+
+    {
+        tcp_data_unit dataUnit(0x0001, request, pool);
+        EXPECT_EQ(pool.available(), 0);
+        EXPECT_TRUE(std::ranges::equal(dataUnit.bytes(), data));
+
+        // copies share the frame
+        tcp_data_unit copy = dataUnit;
+        EXPECT_EQ(copy.bytes().data(), dataUnit.bytes().data());
+        EXPECT_EQ(pool.available(), 0);
+    }
+
+    EXPECT_EQ(pool.available(), 1);
+}
+
+} // namespace
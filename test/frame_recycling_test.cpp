@@ -0,0 +1,124 @@
+#include "modbus/client.hpp"
+#include "modbus/server.hpp"
+
+#include <array>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+/// Whether allocations on this thread are counted.
+thread_local bool counting = false;
+/// The allocations counted on this thread.
+thread_local size_t allocations = 0;
+
+} // namespace
+
+void* operator new(size_t size) {
+    if (counting) {
+        allocations++;
+    }
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+using namespace modbus;
+using namespace std;
+
+const uint16_t RECYCLING_PORT = 5150;
+const size_t WARM_UP_READS = 20;
+const size_t COUNTED_READS = 100;
+
+/// The requests handled by the server. Only the server thread uses it.
+size_t handled = 0;
+/// The allocations the server made while handling the counted reads.
+size_t serverCounted = SIZE_MAX;
+
+/// Answers each read of 10 registers with zeros. The response is built once
+/// and encoded into a pooled frame for every request, so the handler itself
+/// does not allocate. Allocations are counted on the server thread for the
+/// same reads that the client counts.
+awaitable<tcp_data_unit> zero_handler(tcp_data_unit_view request) {
+    static const read_holding_registers_response response(
+        request.unit_id(), vector<uint16_t>(10));
+
+    handled++;
+    if (handled == WARM_UP_READS + 1) {
+        allocations = 0;
+        counting = true;
+    } else if (handled == WARM_UP_READS + COUNTED_READS + 1) {
+        counting = false;
+        serverCounted = allocations;
+    }
+
+    array<uint8_t, MAX_APU_SIZE> frame;
+    size_t size = encode(request.transaction_id(), response, frame);
+    co_return tcp_data_unit(tcp_data_unit_view(
+        std::span<const uint8_t>(frame.data(), size), message_type::response));
+}
+
+awaitable<void> count_reads(asio::io_context& ctx, tcp_client& client,
+                            size_t& counted) {
+    array<uint16_t, 10> values;
+
+    // the first reads connect and fill the frame caches; one more read ends
+    // the count on the server
+    for (size_t i = 0; i < WARM_UP_READS; i++) {
+        auto error = co_await client.read_holding_registers(1, 0, 10, values);
+        EXPECT_FALSE(error) << error.message();
+    }
+
+    allocations = 0;
+    counting = true;
+    for (size_t i = 0; i < COUNTED_READS; i++) {
+        auto error = co_await client.read_holding_registers(1, 0, 10, values);
+        EXPECT_FALSE(error) << error.message();
+    }
+    counting = false;
+
+    counted = allocations;
+    auto error = co_await client.read_holding_registers(1, 0, 10, values);
+    EXPECT_FALSE(error) << error.message();
+    ctx.stop();
+}
+
+TEST(frame_recycling, steady_state_reads_do_not_allocate) {
+    // the server runs on a thread of its own so that each side counts only
+    // its own allocations
+    asio::io_context serverCtx(1);
+    tcp_server server(serverCtx.get_executor(),
+                      request_view_handler_t(zero_handler),
+                      server_config{std::string("0.0.0.0"), RECYCLING_PORT});
+    co_spawn(serverCtx, server.start(), detached);
+    thread serverThread([&serverCtx]() { serverCtx.run_for(10s); });
+
+    asio::io_context ctx(1);
+    tcp_client client(ctx.get_executor(),
+                      client_config("127.0.0.1", RECYCLING_PORT));
+    size_t counted = SIZE_MAX;
+    co_spawn(ctx, count_reads(ctx, client, counted), detached);
+    ctx.run_for(10s);
+
+    EXPECT_EQ(counted, 0) << "allocations in " << COUNTED_READS << " reads";
+
+    server.stop();
+    serverCtx.stop();
+    serverThread.join();
+    EXPECT_EQ(serverCounted, 0)
+        << "server allocations in " << COUNTED_READS << " reads";
+}
+
+} // namespace
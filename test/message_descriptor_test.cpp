@@ -0,0 +1,114 @@
+#include "modbus/core/decode.hpp"
+#include "modbus/core/messages/message_descriptor.hpp"
+#include "modbus/core/requests.hpp"
+#include "modbus/core/responses.hpp"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace modbus;
+using namespace std;
+
+// fixed layouts are sized at compile time
+static_assert(write_single_register_request::size() == 6);
+static_assert(mask_write_register_request::size() == 8);
+static_assert(read_coils_request::size() == 6);
+static_assert(exception_response::size() == EXCEPTION_PDU_SIZE);
+static_assert(message_codec<write_single_coil_response>::layout::is_fixed);
+static_assert(!message_codec<read_coils_response>::layout::is_fixed);
+static_assert(
+    message_codec<read_write_registers_request>::layout::header_size == 11);
+
+// every descriptor agrees with the message it describes
+static_assert(descriptor_matches<read_holding_registers_request>());
+static_assert(descriptor_matches<write_multiple_coils_request>());
+static_assert(descriptor_matches<exception_response>());
+
+template <typename T> T round_trip(const T& message) {
+    buffer_t data(message.size());
+    EXPECT_EQ(message.serialize(data.data()), data.data() + data.size());
+    return T(data.data());
+}
+
+TEST(message_descriptor, constants) {
+    using descriptor = message_descriptor<write_multiple_registers_request>;
+    EXPECT_EQ(descriptor::function_code,
+              function_code_t::write_multiple_registers);
+    EXPECT_EQ(descriptor::type, message_type::request);
+    EXPECT_EQ(descriptor::max_quantity, MAX_WRITE_REGISTERS);
+    EXPECT_TRUE((is_same_v<descriptor::payload_type, uint16_t>));
+
+    EXPECT_TRUE(
+        (is_same_v<message_descriptor<read_coils_request>::payload_type,
+                   void>));
+    EXPECT_EQ(message_descriptor<read_coils_response>::max_quantity,
+              MAX_READ_BITS);
+    EXPECT_EQ(message_descriptor<mask_write_register_request>::max_quantity,
+              0);
+}
+
+TEST(message_descriptor, fixed_layout) {
+    write_single_register_request request{17, 1, 3};
+    buffer_t expected{0x11, 0x06, 0x00, 0x01, 0x00, 0x03};
+    buffer_t data(request.size());
+    request.serialize(data.data());
+    EXPECT_EQ(data, expected);
+    EXPECT_EQ(round_trip(request), request);
+
+    mask_write_register_response response{17, 4, 0x00F2, 0x0025};
+    EXPECT_EQ(round_trip(response), response);
+
+    write_single_coil_request coil{17, 172, true};
+    EXPECT_EQ(round_trip(coil), coil);
+}
+
+TEST(message_descriptor, payload_layout) {
+    write_multiple_registers_request request{
+        17, 1, 2, vector<uint16_t>{0x000A, 0x0102}};
+    buffer_t expected{0x11, 0x10, 0x00, 0x01, 0x00, 0x02,
+                      0x04, 0x00, 0x0A, 0x01, 0x02};
+    buffer_t data(request.size());
+    request.serialize(data.data());
+    EXPECT_EQ(data, expected);
+    EXPECT_EQ(round_trip(request), request);
+
+    read_coils_response response{17, buffer_t{0xCD, 0x6B, 0x05}};
+    EXPECT_EQ(response.size(), 6);
+    EXPECT_EQ(round_trip(response), response);
+
+    read_write_registers_response registers{17, vector<uint16_t>{0xFE, 0xAC}};
+    EXPECT_EQ(round_trip(registers), registers);
+}
+
+TEST(message_descriptor, exception_response) {
+    exception_response response{17, function_code_t::read_coils,
+                                exception_code_t::illegal_data_address};
+    buffer_t data(response.size());
+    response.serialize(data.data());
+    EXPECT_EQ(data, (buffer_t{0x11, 0x81, 0x02}));
+    EXPECT_EQ(round_trip(response), response);
+}
+
+TEST(message_descriptor, limits_validation) {
+    // the largest quantity of the descriptor passes and one more does not
+    auto quantity =
+        message_descriptor<read_holding_registers_request>::max_quantity;
+    buffer_t pdu(read_holding_registers_request::size());
+    read_holding_registers_request(1, 0, quantity).serialize(pdu.data());
+    EXPECT_EQ(validate_pdu(pdu, message_type::request),
+              modbus_error_code::success);
+    read_holding_registers_request(1, 0, quantity + 1).serialize(pdu.data());
+    EXPECT_EQ(validate_pdu(pdu, message_type::request),
+              modbus_error_code::invalid_quantity);
+
+    quantity = message_descriptor<write_multiple_coils_request>::max_quantity;
+    write_multiple_coils_request write(1, 0, vector<bool>(quantity, true));
+    pdu.resize(write.size());
+    write.serialize(pdu.data());
+    EXPECT_EQ(validate_pdu(pdu, message_type::request),
+              modbus_error_code::success);
+}
+
+} // namespace
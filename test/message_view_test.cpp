@@ -0,0 +1,207 @@
+#include "modbus/core/requests.hpp"
+#include "modbus/core/responses.hpp"
+#include "modbus/core/tcp_data_unit.hpp"
+#include "modbus/core/tcp_data_unit_view.hpp"
+#include "modbus/core/views.hpp"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace modbus;
+using namespace std;
+
+TEST(message_views, register_span) {
+    buffer_t data{0x0F, 0xF0, 0x12, 0x34, 0xFF};
+    register_span registers(data);
+
+    EXPECT_EQ(registers.size(), 2);
+    EXPECT_EQ(registers[0], 0x0FF0);
+    EXPECT_EQ(registers[1], 0x1234);
+    EXPECT_EQ(registers.at(1), 0x1234);
+    EXPECT_THROW(registers.at(2), std::out_of_range);
+
+    std::vector<uint16_t> out(4, 0);
+    EXPECT_EQ(registers.copy_to(out), 2);
+    EXPECT_THAT(out, testing::ElementsAre(0x0FF0, 0x1234, 0, 0));
+    EXPECT_THAT(registers.to_vector(), testing::ElementsAre(0x0FF0, 0x1234));
+}
+
+TEST(message_views, coil_span) {
+    buffer_t data{0xCD, 0x01};
+    coil_span coils(data);
+
+    EXPECT_EQ(coils.size(), 16);
+    EXPECT_TRUE(coils[0]);
+    EXPECT_FALSE(coils[1]);
+    EXPECT_TRUE(coils[2]);
+    EXPECT_TRUE(coils[3]);
+    EXPECT_FALSE(coils[4]);
+    EXPECT_FALSE(coils[5]);
+    EXPECT_TRUE(coils[6]);
+    EXPECT_TRUE(coils[7]);
+    EXPECT_TRUE(coils[8]);
+    EXPECT_FALSE(coils[9]);
+    EXPECT_THROW(coils.at(16), std::out_of_range);
+}
+
+TEST(message_views, read_coils_response_view) {
+    buffer_t data{0x11, 0x01, 0x02, 0xCD, 0x01};
+    read_coils_response_view response(data);
+
+    EXPECT_EQ(response.unit_id, 0x11);
+    EXPECT_EQ(response.values.bytes().data(), data.data() + 3);
+    EXPECT_EQ(response.values.bytes().size(), 2);
+    EXPECT_TRUE(response.values[0]);
+    EXPECT_TRUE(response.values[8]);
+    EXPECT_EQ(response.size(), data.size());
+
+    buffer_t truncated{0x11, 0x01, 0x03, 0xCD, 0x01};
+    EXPECT_THROW(read_coils_response_view{truncated}, std::out_of_range);
+
+    buffer_t trailing{0x11, 0x01, 0x02, 0xCD, 0x01, 0x00};
+    EXPECT_THROW(read_coils_response_view{trailing}, std::out_of_range);
+
+    buffer_t wrongFunction{0x11, 0x02, 0x02, 0xCD, 0x01};
+    EXPECT_THROW(read_coils_response_view{wrongFunction},
+                 std::invalid_argument);
+}
+
+TEST(message_views, read_discrete_inputs_response_view) {
+    buffer_t data{0x11, 0x02, 0x01, 0xAC};
+    read_discrete_inputs_response_view response(data);
+
+    EXPECT_EQ(response.unit_id, 0x11);
+    EXPECT_FALSE(response.inputs[0]);
+    EXPECT_FALSE(response.inputs[1]);
+    EXPECT_TRUE(response.inputs[2]);
+    EXPECT_TRUE(response.inputs[7]);
+}
+
+TEST(message_views, read_holding_registers_response_view) {
+    read_holding_registers_response message{
+        17, std::vector<uint16_t>{0x022B, 0x0000, 0x0064}};
+    buffer_t data{0x11, 0x03, 0x06, 0x02, 0x2B, 0x00, 0x00, 0x00, 0x64};
+
+    read_holding_registers_response_view response(data);
+    EXPECT_EQ(response.unit_id, message.unit_id);
+    EXPECT_EQ(response.values.size(), 3);
+    EXPECT_EQ(response.values[0], 0x022B);
+    EXPECT_EQ(response.values[1], 0x0000);
+    EXPECT_EQ(response.values[2], 0x0064);
+    EXPECT_EQ(response.size(), message.size());
+
+    buffer_t oddBytes{0x11, 0x03, 0x05, 0x02, 0x2B, 0x00, 0x00, 0x00};
+    EXPECT_THROW(read_holding_registers_response_view{oddBytes},
+                 std::invalid_argument);
+}
+
+TEST(message_views, read_input_registers_response_view) {
+    buffer_t data{0x11, 0x04, 0x02, 0x00, 0x0A};
+    read_input_registers_response_view response(data);
+
+    EXPECT_EQ(response.unit_id, 0x11);
+    EXPECT_EQ(response.values.size(), 1);
+    EXPECT_EQ(response.values[0], 0x000A);
+}
+
+TEST(message_views, read_write_registers_response_view) {
+    buffer_t data{0x11, 0x17, 0x04, 0x00, 0xFE, 0x0A, 0xCD};
+    read_write_registers_response_view response(data);
+
+    EXPECT_EQ(response.unit_id, 0x11);
+    EXPECT_THAT(response.values.to_vector(),
+                testing::ElementsAre(0x00FE, 0x0ACD));
+}
+
+TEST(message_views, write_multiple_coils_request_view) {
+    buffer_t data{0x11, 0x0F, 0x00, 0x13, 0x00, 0x0A, 0x02, 0xCD, 0x01};
+    write_multiple_coils_request_view request(data);
+
+    EXPECT_EQ(request.unit_id, 0x11);
+    EXPECT_EQ(request.start_address, 0x0013);
+    EXPECT_EQ(request.length, 10);
+    EXPECT_TRUE(request.values[0]);
+    EXPECT_TRUE(request.values[8]);
+    EXPECT_FALSE(request.values[9]);
+    EXPECT_EQ(request.size(), data.size());
+
+    // 10 coils need 2 bytes
+    buffer_t wrongCount{0x11, 0x0F, 0x00, 0x13, 0x00, 0x0A, 0x01, 0xCD};
+    EXPECT_THROW(write_multiple_coils_request_view{wrongCount},
+                 std::invalid_argument);
+}
+
+TEST(message_views, write_multiple_registers_request_view) {
+    buffer_t data{0x11, 0x10, 0x00, 0x01, 0x00, 0x02,
+                  0x04, 0x00, 0x0A, 0x01, 0x02};
+    write_multiple_registers_request_view request(data);
+
+    EXPECT_EQ(request.unit_id, 0x11);
+    EXPECT_EQ(request.start_address, 0x0001);
+    EXPECT_EQ(request.length, 2);
+    EXPECT_EQ(request.values[0], 0x000A);
+    EXPECT_EQ(request.values[1], 0x0102);
+
+    buffer_t shortHeader{0x11, 0x10, 0x00, 0x01, 0x00};
+    EXPECT_THROW(write_multiple_registers_request_view{shortHeader},
+                 std::out_of_range);
+
+    data.push_back(0x00);
+    EXPECT_THROW(write_multiple_registers_request_view{data},
+                 std::out_of_range);
+}
+
+TEST(message_views, read_write_registers_request_view) {
+    read_write_registers_request message{17, 3, 6, 14,
+                                         std::vector<uint16_t>{0x00FF}};
+    buffer_t data(message.size());
+    message.serialize(data.begin());
+
+    read_write_registers_request_view request(data);
+    EXPECT_EQ(request.unit_id, message.unit_id);
+    EXPECT_EQ(request.read_start_address, message.read_start_address);
+    EXPECT_EQ(request.read_num_registers, message.read_num_registers);
+    EXPECT_EQ(request.write_start_address, message.write_start_address);
+    EXPECT_EQ(request.write_num_registers, message.write_num_registers);
+    EXPECT_THAT(request.values.to_vector(), testing::ElementsAre(0x00FF));
+}
+
+TEST(message_views, tcp_data_unit_pdu) {
+    read_holding_registers_response message{
+        17, std::vector<uint16_t>{0x0FF0, 0x1234}};
+    tcp_data_unit dataUnit(0x0001, message);
+
+    auto optionalResponse =
+        dataUnit.pdu<read_holding_registers_response_view>();
+    EXPECT_TRUE(optionalResponse);
+    EXPECT_EQ(optionalResponse->values.size(), 2);
+    EXPECT_EQ(optionalResponse->values[1], 0x1234);
+    EXPECT_EQ(optionalResponse->values.bytes().data(),
+              dataUnit.bytes().data() + TCP_HEADER_SIZE + 3);
+
+    EXPECT_FALSE(dataUnit.pdu<read_input_registers_response_view>());
+    EXPECT_FALSE(dataUnit.pdu<write_multiple_registers_request_view>());
+}
+
+TEST(message_views, tcp_data_unit_view_pdu) {
+    buffer_t data{0x00, 0x0F, 0x00, 0x00, 0x00, 0x0B, 0x11, 0x10, 0x00,
+                  0x01, 0x00, 0x02, 0x04, 0x00, 0x0A, 0x01, 0x02};
+    tcp_data_unit_view dataUnit(data, message_type::request);
+
+    auto optionalRequest =
+        dataUnit.pdu<write_multiple_registers_request_view>();
+    EXPECT_TRUE(optionalRequest);
+    EXPECT_EQ(optionalRequest->start_address, 1);
+    EXPECT_EQ(optionalRequest->values[0], 0x000A);
+    EXPECT_EQ(optionalRequest->values[1], 0x0102);
+
+    // truncated frames are rejected rather than read past the end
+    buffer_t truncated{0x00, 0x0F, 0x00, 0x00, 0x00, 0x0A, 0x11, 0x10, 0x00,
+                       0x01, 0x00, 0x02, 0x04, 0x00, 0x0A, 0x01};
+    tcp_data_unit_view truncatedUnit(truncated, message_type::request);
+    EXPECT_FALSE(truncatedUnit.pdu<write_multiple_registers_request_view>());
+}
+
+} // namespace
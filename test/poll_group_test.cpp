@@ -0,0 +1,162 @@
+#include "modbus/client.hpp"
+#include "modbus/server.hpp"
+
+#include <memory>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace modbus;
+using namespace std;
+
+const uint16_t POLL_PORT = 5070;
+const uint8_t FAST_UNIT = 1;
+const uint8_t SLOW_UNIT = 2;
+const std::chrono::milliseconds SLOW_WAIT = 120ms;
+const std::chrono::milliseconds PERIOD = 50ms;
+
+using clock_type = timer_wheel::clock_type;
+
+/// Answers read_holding_registers_request with the address of each register.
+/// Requests to SLOW_UNIT are answered after SLOW_WAIT.
+awaitable<tcp_data_unit> poll_handler(tcp_data_unit_view request) {
+    auto optionalRequest = request.pdu<read_holding_registers_request>();
+    if (!optionalRequest) {
+        co_return tcp_data_unit(
+            request.transaction_id(),
+            exception_response(request.unit_id(), request.function_code(),
+                               exception_code_t::illegal_function));
+    }
+
+    if (request.unit_id() == SLOW_UNIT) {
+        asio::steady_timer timer(co_await asio::this_coro::executor, SLOW_WAIT);
+        co_await timer.async_wait(use_awaitable);
+    }
+
+    vector<uint16_t> values(optionalRequest->length);
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = optionalRequest->start_address + i;
+    }
+    co_return tcp_data_unit(
+        request.transaction_id(),
+        read_holding_registers_response(request.unit_id(), values));
+}
+
+TEST(timer_wheel, fires_in_deadline_order) {
+    asio::io_context ctx(1);
+    // a short rotation so that one entry waits for more than one
+    timer_wheel wheel(ctx.get_executor(), 1ms, 16);
+
+    vector<char> fired;
+    vector<clock_type::duration> late;
+    auto now = clock_type::now();
+    auto make_entry = [&](char name, std::chrono::milliseconds delay) {
+        auto e = make_unique<timer_wheel::entry>([&, name, delay, now]() {
+            fired.push_back(name);
+            late.push_back(clock_type::now() - (now + delay));
+        });
+        wheel.schedule(*e, now + delay);
+        return e;
+    };
+
+    auto a = make_entry('a', 30ms);
+    auto b = make_entry('b', 10ms);
+    auto c = make_entry('c', 20ms);
+    auto d = make_entry('d', 45ms);
+    EXPECT_EQ(wheel.size(), 4);
+
+    wheel.cancel(*c);
+    EXPECT_FALSE(c->scheduled());
+    EXPECT_EQ(wheel.size(), 3);
+
+    // destroying an entry takes it off the wheel
+    auto e = make_entry('e', 5ms);
+    e.reset();
+
+    ctx.run();
+    EXPECT_THAT(fired, testing::ElementsAre('b', 'a', 'd'));
+    for (auto delay : late) {
+        EXPECT_GE(delay, 0ms);
+    }
+    EXPECT_EQ(wheel.size(), 0);
+}
+
+awaitable<void> run_polls(asio::io_context& ctx, tcp_server& server,
+                          shared_ptr<poll_group> fast,
+                          shared_ptr<poll_group> slow) {
+    asio::steady_timer timer(ctx, 50ms);
+    co_await timer.async_wait(use_awaitable);
+
+    fast->start();
+    slow->start();
+    // one scan at the start and one every PERIOD after it
+    timer.expires_after(PERIOD * 8 - PERIOD / 2);
+    co_await timer.async_wait(use_awaitable);
+    fast->stop();
+    slow->stop();
+
+    // let the last slow scan finish
+    timer.expires_after(SLOW_WAIT * 2);
+    co_await timer.async_wait(use_awaitable);
+    server.stop();
+    ctx.stop();
+}
+
+TEST(poll_group, keeps_phase_and_skips_overruns) {
+    asio::io_context ctx(1);
+
+    server_config sconfig = server_config{std::string("0.0.0.0"), POLL_PORT}
+                                .set_logging_handler(print_logging_handler);
+    tcp_server server(ctx.get_executor(), request_view_handler_t(poll_handler),
+                      sconfig);
+    co_spawn(ctx, server.start(), detached);
+
+    client_config cconfig = client_config("127.0.0.1", POLL_PORT)
+                                .set_max_connections(2)
+                                .set_logging_handler(print_logging_handler);
+    tcp_client client(ctx.get_executor(), cconfig);
+    timer_wheel wheel(ctx.get_executor());
+
+    const auto HOLDING = data_model_t::holding_register;
+    vector<tag_read> fastTags{{FAST_UNIT, HOLDING, 0, 2},
+                              {FAST_UNIT, HOLDING, 5, 1}};
+    auto fast = make_shared<poll_group>(wheel, client, plan_reads(fastTags),
+                                        PERIOD);
+    size_t fastScans = 0;
+    fast->set_scan_handler([&](const read_plan& plan) {
+        fastScans++;
+        EXPECT_EQ(plan.tag(0).getUINT32(0), 0x00000001);
+        EXPECT_EQ(plan.tag(1).getUINT16(0), 5);
+    });
+
+    // every scan of the slow group takes longer than its period
+    vector<tag_read> slowTags{{SLOW_UNIT, HOLDING, 0, 1}};
+    auto slow = make_shared<poll_group>(wheel, client, plan_reads(slowTags),
+                                        PERIOD);
+    slow->set_timeout(1s);
+
+    co_spawn(ctx, run_polls(ctx, server, fast, slow), detached);
+    ctx.run_for(10s);
+
+    const auto& fastStats = fast->stats();
+    EXPECT_EQ(fastStats.scans, 8);
+    EXPECT_EQ(fastScans, 8);
+    EXPECT_EQ(fastStats.overruns, 0);
+    EXPECT_EQ(fastStats.failed_reads, 0);
+    EXPECT_LT(fastStats.max_jitter, 20ms);
+    EXPECT_LE(fastStats.mean_jitter(), fastStats.max_jitter);
+
+    // a scan at 0, 150 and 300 ms; the deadlines in between are skipped
+    const auto& slowStats = slow->stats();
+    EXPECT_EQ(slowStats.scans, 3);
+    EXPECT_EQ(slowStats.overruns, 5);
+    EXPECT_EQ(slowStats.failed_reads, 0);
+    EXPECT_GE(slowStats.max_duration, SLOW_WAIT);
+    EXPECT_FALSE(slow->scanning());
+    EXPECT_EQ(slow->plan().tag(0).getUINT16(0), 0);
+}
+
+} // namespace
@@ -0,0 +1,165 @@
+#include "modbus/client.hpp"
+#include "modbus/server.hpp"
+
+#include <array>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace modbus;
+using namespace std;
+
+const uint16_t READ_CACHE_PORT = 5120;
+const size_t TABLE_SIZE = 100;
+
+/// The number of reads the server answered.
+size_t serverReads = 0;
+
+/// Answers read_holding_registers_request with each register's address after
+/// a short delay so that reads overlap.
+awaitable<tcp_data_unit> slow_handler(tcp_data_unit_view request) {
+    auto read = request.pdu<read_holding_registers_request>();
+    if (!read || read->start_address + read->length > TABLE_SIZE) {
+        co_return tcp_data_unit(
+            request.transaction_id(),
+            exception_response(request.unit_id(), request.function_code(),
+                               exception_code_t::illegal_data_address));
+    }
+
+    serverReads++;
+    asio::steady_timer timer(co_await asio::this_coro::executor, 20ms);
+    co_await timer.async_wait(use_awaitable);
+
+    vector<uint16_t> values(read->length);
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = (uint16_t)(read->start_address + i);
+    }
+    co_return tcp_data_unit(
+        request.transaction_id(),
+        read_holding_registers_response(request.unit_id(), values));
+}
+
+awaitable<void> read_registers(read_cache& cache, uint16_t address,
+                               cpool::error expected, size_t& completed,
+                               std::chrono::milliseconds timeout = 5s) {
+    array<uint16_t, 4> values{};
+    auto error =
+        co_await cache.read_holding_registers(1, address, 4, values, timeout);
+    EXPECT_EQ(error, expected) << error.message();
+    if (!error) {
+        EXPECT_THAT(values, testing::ElementsAre(address, address + 1,
+                                                 address + 2, address + 3));
+    }
+    completed++;
+}
+
+awaitable<void> share_reads(asio::io_context& ctx, tcp_server& server,
+                            read_cache& cache) {
+    asio::steady_timer timer(ctx, 50ms);
+    co_await timer.async_wait(use_awaitable);
+
+    // identical reads in flight share one request
+    size_t completed = 0;
+    for (size_t i = 0; i < 3; i++) {
+        co_spawn(ctx, read_registers(cache, 10, cpool::error(), completed),
+                 detached);
+    }
+    timer.expires_after(200ms);
+    co_await timer.async_wait(use_awaitable);
+    EXPECT_EQ(completed, 3);
+    EXPECT_EQ(serverReads, 1);
+    EXPECT_EQ(cache.misses(), 1);
+    EXPECT_EQ(cache.joins(), 2);
+
+    // a fresh read is answered from the cache
+    co_await read_registers(cache, 10, cpool::error(), completed);
+    EXPECT_EQ(serverReads, 1);
+    EXPECT_EQ(cache.hits(), 1);
+
+    // a different range is not
+    co_await read_registers(cache, 11, cpool::error(), completed);
+    EXPECT_EQ(serverReads, 2);
+    EXPECT_EQ(cache.misses(), 2);
+
+    // errors are shared but not cached
+    auto illegal = cpool::error(exception_code_t::illegal_data_address);
+    for (size_t i = 0; i < 2; i++) {
+        co_spawn(ctx, read_registers(cache, TABLE_SIZE, illegal, completed),
+                 detached);
+    }
+    timer.expires_after(200ms);
+    co_await timer.async_wait(use_awaitable);
+    EXPECT_EQ(cache.misses(), 3);
+    EXPECT_EQ(cache.joins(), 3);
+    co_await read_registers(cache, TABLE_SIZE, illegal, completed);
+    EXPECT_EQ(cache.misses(), 4);
+
+    // cleared values are read again
+    cache.clear();
+    co_await read_registers(cache, 10, cpool::error(), completed);
+    EXPECT_EQ(serverReads, 3);
+    EXPECT_EQ(completed, 9);
+
+    // a cancelled read is sent again by the read that joined it
+    auto cancelled = cpool::error(modbus_client_error_code::cancelled);
+    asio::cancellation_signal signal;
+    co_spawn(ctx, read_registers(cache, 20, cancelled, completed),
+             asio::bind_cancellation_slot(signal.slot(), detached));
+    co_spawn(ctx, read_registers(cache, 20, cpool::error(), completed),
+             detached);
+    timer.expires_after(5ms);
+    co_await timer.async_wait(use_awaitable);
+    signal.emit(asio::cancellation_type::terminal);
+    timer.expires_after(1ms);
+    co_await timer.async_wait(use_awaitable);
+    EXPECT_EQ(completed, 10);
+    timer.expires_after(50ms);
+    co_await timer.async_wait(use_awaitable);
+    EXPECT_EQ(completed, 11);
+    EXPECT_EQ(serverReads, 5);
+    EXPECT_EQ(cache.misses(), 7);
+    co_await read_registers(cache, 20, cpool::error(), completed);
+    EXPECT_EQ(serverReads, 5);
+    EXPECT_EQ(completed, 12);
+
+    // a joined read gives up at its own timeout
+    auto timedOut = cpool::error(modbus_client_error_code::read_timeout);
+    co_spawn(ctx, read_registers(cache, 30, cpool::error(), completed),
+             detached);
+    co_spawn(ctx, read_registers(cache, 30, timedOut, completed, 5ms),
+             detached);
+    timer.expires_after(10ms);
+    co_await timer.async_wait(use_awaitable);
+    EXPECT_EQ(completed, 13);
+    timer.expires_after(50ms);
+    co_await timer.async_wait(use_awaitable);
+    EXPECT_EQ(completed, 14);
+    EXPECT_EQ(serverReads, 6);
+
+    server.stop();
+    ctx.stop();
+}
+
+TEST(read_cache, joins_and_caches_reads) {
+    asio::io_context ctx(1);
+
+    server_config sconfig =
+        server_config{std::string("0.0.0.0"), READ_CACHE_PORT}
+            .set_logging_handler(print_logging_handler);
+    tcp_server server(ctx.get_executor(),
+                      request_view_handler_t(slow_handler), sconfig);
+    co_spawn(ctx, server.start(), detached);
+
+    client_config cconfig = client_config("127.0.0.1", READ_CACHE_PORT)
+                                .set_logging_handler(print_logging_handler);
+    tcp_client client(ctx.get_executor(), cconfig);
+    read_cache cache(client, 10s);
+
+    co_spawn(ctx, share_reads(ctx, server, cache), detached);
+    ctx.run_for(10s);
+}
+
+} // namespace
@@ -0,0 +1,169 @@
+#include "modbus/core/read_planner.hpp"
+#include "modbus/core/responses.hpp"
+
+#include <stdexcept>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace modbus;
+using namespace std;
+
+const auto HOLDING = data_model_t::holding_register;
+const auto COIL = data_model_t::coil;
+
+TEST(read_planner, merges_near_tags) {
+    vector<tag_read> tags{
+        {1, HOLDING, 10, 2},
+        {1, HOLDING, 0, 2},
+        {1, HOLDING, 2, 1},
+        {1, HOLDING, 1, 1},
+    };
+
+    auto plan = plan_reads(tags);
+    EXPECT_THAT(plan.requests(),
+                testing::ElementsAre(planned_read{1, HOLDING, 0, 12}));
+    EXPECT_EQ(plan.stats().tags, 4);
+    EXPECT_EQ(plan.stats().requests, 1);
+    EXPECT_EQ(plan.stats().registers, 12);
+    EXPECT_EQ(plan.stats().wasted_registers, 7);
+    EXPECT_EQ(plan.stats().wasted_bytes(), 14);
+
+    // the gap between 3 and 10 is too wide
+    plan = plan_reads(tags, read_plan_options().set_max_register_gap(4));
+    EXPECT_THAT(plan.requests(),
+                testing::ElementsAre(planned_read{1, HOLDING, 0, 3},
+                                     planned_read{1, HOLDING, 10, 2}));
+    EXPECT_EQ(plan.request_of(0), 1);
+    EXPECT_EQ(plan.request_of(1), 0);
+    EXPECT_EQ(plan.stats().wasted_registers, 0);
+}
+
+TEST(read_planner, quantity_limits) {
+    vector<tag_read> registers{{1, HOLDING, 0, 100}, {1, HOLDING, 100, 25}};
+    EXPECT_EQ(plan_reads(registers).stats().requests, 1);
+    registers.push_back({1, HOLDING, 125, 1});
+    EXPECT_THAT(plan_reads(registers).requests(),
+                testing::ElementsAre(planned_read{1, HOLDING, 0, 125},
+                                     planned_read{1, HOLDING, 125, 1}));
+
+    vector<tag_read> coils{{1, COIL, 0, 1000}, {1, COIL, 1000, 1000}};
+    EXPECT_EQ(plan_reads(coils).stats().requests, 1);
+    coils.push_back({1, COIL, 2000, 1});
+    EXPECT_EQ(plan_reads(coils).stats().requests, 2);
+
+    vector<tag_read> invalid{{1, HOLDING, 0, 126}};
+    EXPECT_THROW(plan_reads(invalid), std::invalid_argument);
+    invalid = {{1, HOLDING, 0xFFFF, 2}};
+    EXPECT_THROW(plan_reads(invalid), std::invalid_argument);
+    invalid = {{1, data_model_t::invalid_data_type, 0, 1}};
+    EXPECT_THROW(plan_reads(invalid), std::invalid_argument);
+
+    // limits above the protocol maximum are clamped
+    auto options = read_plan_options().set_max_registers(1000).set_max_bits(
+        10000);
+    EXPECT_EQ(plan_reads(registers, options).stats().requests, 2);
+    EXPECT_EQ(plan_reads(coils, options).stats().requests, 2);
+    invalid = {{1, HOLDING, 0, 126}};
+    EXPECT_THROW(plan_reads(invalid, options), std::invalid_argument);
+}
+
+TEST(read_planner, units_and_models_are_not_merged) {
+    vector<tag_read> tags{
+        {2, HOLDING, 0, 1},
+        {1, HOLDING, 0, 1},
+        {1, data_model_t::input_register, 1, 1},
+        {1, COIL, 0, 8},
+        // overlapping and duplicate tags share a request
+        {1, COIL, 4, 8},
+        {1, COIL, 4, 8},
+    };
+
+    auto plan = plan_reads(tags);
+    EXPECT_EQ(plan.stats().requests, 4);
+    EXPECT_EQ(plan.request_of(3), plan.request_of(4));
+    EXPECT_EQ(plan.request_of(4), plan.request_of(5));
+    EXPECT_EQ(plan.requests()[plan.request_of(3)],
+              (planned_read{1, COIL, 0, 12}));
+    EXPECT_EQ(plan.requests()[plan.request_of(2)].function_code(),
+              function_code_t::read_input_registers);
+    EXPECT_EQ(plan.stats().wasted_bits, 0);
+}
+
+TEST(read_planner, scatters_responses) {
+    vector<tag_read> tags{
+        {1, HOLDING, 4, 2},
+        {1, HOLDING, 0, 1},
+        {1, COIL, 3, 5},
+        {1, COIL, 6, 2},
+    };
+    auto plan = plan_reads(tags);
+    ASSERT_EQ(plan.stats().requests, 2);
+
+    // nothing is stored yet
+    EXPECT_FALSE(plan.tag(0).isValid());
+
+    buffer_t frame(MAX_APU_SIZE);
+    for (size_t i = 0; i < plan.requests().size(); i++) {
+        const auto& read = plan.requests()[i];
+        EXPECT_EQ(read.encode(7, frame), 12);
+        EXPECT_EQ(read.create_request(7).function_code(),
+                  read.function_code());
+
+        tcp_data_unit response;
+        if (read.data_model == HOLDING) {
+            EXPECT_EQ(read, (planned_read{1, HOLDING, 0, 6}));
+            response = tcp_data_unit(
+                7, read_holding_registers_response(
+                       1, vector<uint16_t>{0x0102, 0, 0, 0, 0x0A0B, 0x0C0D}));
+        } else {
+            EXPECT_EQ(read, (planned_read{1, COIL, 3, 5}));
+            response =
+                tcp_data_unit(7, read_coils_response(1, buffer_t{0x15}));
+        }
+        EXPECT_EQ(plan.store(i, response.view()), modbus_error_code::success);
+    }
+
+    auto wide = plan.tag(0);
+    EXPECT_TRUE(wide.isValid());
+    EXPECT_EQ(wide.start_address(), 4);
+    EXPECT_EQ(wide.getUINT16(0), 0x0A0B);
+    EXPECT_EQ(wide.getUINT16(1, byte_order::byte_swapped), 0x0D0C);
+    EXPECT_EQ(wide.getUINT32(0), 0x0A0B0C0D);
+    EXPECT_THROW(wide.getUINT16(2), std::out_of_range);
+
+    EXPECT_EQ(plan.tag(1).getINT16(0), 0x0102);
+
+    auto coils = plan.tag(2);
+    bool values[5];
+    EXPECT_EQ(coils.getBools(0, values), 5);
+    EXPECT_THAT(values, testing::ElementsAre(true, false, true, false, true));
+    EXPECT_TRUE(coils.getBool(4));
+
+    // the tag starts in the middle of a byte
+    auto unaligned = plan.tag(3);
+    EXPECT_FALSE(unaligned.getBool(0));
+    EXPECT_TRUE(unaligned.getBool(1));
+    EXPECT_EQ(*unaligned.to_response().data(), buffer_t{0x02});
+
+    auto response = coils.to_response();
+    EXPECT_EQ(response.data_model(), COIL);
+    EXPECT_EQ(response.start_address(), 3);
+    EXPECT_EQ(*response.data(), buffer_t{0x15});
+
+    // an exception leaves the tags of the request invalid
+    tcp_data_unit exception(
+        7, exception_response(1, function_code_t::read_coils,
+                              exception_code_t::illegal_data_address));
+    EXPECT_EQ(plan.store(plan.request_of(2), exception.view()),
+              modbus_error_code::invalid_function_code);
+    EXPECT_FALSE(plan.tag(2).isValid());
+    EXPECT_TRUE(plan.tag(0).isValid());
+
+    plan.invalidate();
+    EXPECT_FALSE(plan.tag(0).isValid());
+}
+
+} // namespace
@@ -0,0 +1,196 @@
+#include "modbus/client.hpp"
+#include "modbus/server.hpp"
+
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace modbus;
+using namespace std;
+
+const uint16_t RETRY_PORT = 5090;
+const std::chrono::milliseconds SLOW_WAIT = 150ms;
+
+/// The number of requests the server received by function code.
+array<size_t, 256> serverRequests{};
+/// Whether the next request is answered after SLOW_WAIT.
+bool slowNext = false;
+
+/// Answers reads with zeroes and echoes writes.
+awaitable<tcp_data_unit> retry_handler(tcp_data_unit_view request) {
+    serverRequests[(uint8_t)request.function_code()]++;
+    if (slowNext) {
+        slowNext = false;
+        asio::steady_timer timer(co_await asio::this_coro::executor, SLOW_WAIT);
+        co_await timer.async_wait(use_awaitable);
+    }
+
+    if (auto read = request.pdu<read_holding_registers_request>()) {
+        co_return tcp_data_unit(
+            request.transaction_id(),
+            read_holding_registers_response(request.unit_id(),
+                                            vector<uint16_t>(read->length)));
+    }
+    if (auto write = request.pdu<write_single_register_request>()) {
+        co_return tcp_data_unit(
+            request.transaction_id(),
+            write_single_register_response(request.unit_id(),
+                                           write->start_address,
+                                           write->value));
+    }
+    co_return tcp_data_unit(
+        request.transaction_id(),
+        exception_response(request.unit_id(), request.function_code(),
+                           exception_code_t::illegal_function));
+}
+
+TEST(rtt_estimator, follows_rfc6298) {
+    rtt_estimator rtt;
+    EXPECT_EQ(rtt.timeout(), DEFAULT_INITIAL_RTO);
+    EXPECT_EQ(rtt.percentile(0.5), 0us);
+
+    rtt.add_sample(100ms);
+    EXPECT_EQ(rtt.srtt(), 100ms);
+    EXPECT_EQ(rtt.rttvar(), 50ms);
+    EXPECT_EQ(rtt.timeout(), 300ms);
+
+    rtt.add_sample(100ms);
+    EXPECT_EQ(rtt.srtt(), 100ms);
+    EXPECT_EQ(rtt.rttvar(), 37500us);
+    EXPECT_EQ(rtt.timeout(), 250ms);
+
+    rtt.backoff();
+    EXPECT_EQ(rtt.timeout(), 500ms);
+    for (size_t i = 0; i < 10; i++) {
+        rtt.backoff();
+    }
+    EXPECT_EQ(rtt.timeout(), DEFAULT_MAX_RTO);
+
+    // a sample resets the backoff and fast devices are held to the minimum
+    for (size_t i = 0; i < 50; i++) {
+        rtt.add_sample(100us);
+    }
+    EXPECT_EQ(rtt.timeout(), DEFAULT_MIN_RTO);
+}
+
+TEST(rtt_estimator, percentiles_of_recent_samples) {
+    rtt_estimator rtt;
+    for (int i = 10; i > 0; i--) {
+        rtt.add_sample(std::chrono::milliseconds(i));
+    }
+    EXPECT_EQ(rtt.samples(), 10);
+    EXPECT_EQ(rtt.percentile(0.5), 5ms);
+    EXPECT_EQ(rtt.percentile(0.9), 9ms);
+    EXPECT_EQ(rtt.percentile(1), 10ms);
+    EXPECT_EQ(rtt.percentile(0), 1ms);
+
+    // only the last RTT_HISTORY_SIZE samples count
+    for (size_t i = 0; i < RTT_HISTORY_SIZE; i++) {
+        rtt.add_sample(20ms);
+    }
+    EXPECT_EQ(rtt.percentile(0), 20ms);
+}
+
+awaitable<void> retry_reads_only(asio::io_context& ctx, tcp_server& server,
+                                 tcp_client& client) {
+    asio::steady_timer timer(ctx, 50ms);
+    co_await timer.async_wait(use_awaitable);
+
+    // the first attempt times out and the retry is answered
+    slowNext = true;
+    auto [read, readError] = co_await client.send_request(
+        client.create_request(read_holding_registers_request{1, 0, 4}),
+        100ms);
+    EXPECT_FALSE(readError) << readError.message();
+    EXPECT_EQ(serverRequests[0x03], 2);
+
+    // writes are never sent twice
+    slowNext = true;
+    auto [write, writeError] = co_await client.send_request(
+        client.create_request(write_single_register_request{1, 0, 7}), 100ms);
+    EXPECT_EQ(writeError, cpool::error(modbus_client_error_code::read_timeout));
+
+    timer.expires_after(SLOW_WAIT * 2);
+    co_await timer.async_wait(use_awaitable);
+    EXPECT_EQ(serverRequests[0x06], 1);
+
+    server.stop();
+    ctx.stop();
+}
+
+TEST(tcp_client, retries_reads_only) {
+    serverRequests = {};
+    asio::io_context ctx(1);
+
+    server_config sconfig = server_config{std::string("0.0.0.0"), RETRY_PORT}
+                                .set_logging_handler(print_logging_handler);
+    tcp_server server(ctx.get_executor(),
+                      request_view_handler_t(retry_handler), sconfig);
+    co_spawn(ctx, server.start(), detached);
+
+    client_config cconfig = client_config("127.0.0.1", RETRY_PORT)
+                                .set_read_retries(2)
+                                .set_retry_backoff(10ms)
+                                .set_logging_handler(print_logging_handler);
+    tcp_client client(ctx.get_executor(), cconfig);
+
+    co_spawn(ctx, retry_reads_only(ctx, server, client), detached);
+    ctx.run_for(10s);
+}
+
+awaitable<void> hedge_slow_read(asio::io_context& ctx, tcp_server& server,
+                                tcp_client& client) {
+    asio::steady_timer timer(ctx, 50ms);
+    co_await timer.async_wait(use_awaitable);
+
+    // learn the round trip time
+    for (size_t i = 0; i < 10; i++) {
+        auto [response, error] = co_await client.send_request(
+            client.create_request(read_holding_registers_request{1, 0, 1}));
+        EXPECT_FALSE(error) << error.message();
+    }
+    EXPECT_EQ(client.rtt().samples(), 10);
+    EXPECT_LT(client.rtt().timeout(), DEFAULT_INITIAL_RTO);
+
+    // the slow read is answered by its copy on the other connection
+    slowNext = true;
+    auto start = chrono::steady_clock::now();
+    auto [response, error] = co_await client.send_request(
+        client.create_request(read_holding_registers_request{1, 0, 2}), 1s);
+    EXPECT_FALSE(error) << error.message();
+    EXPECT_LT(chrono::steady_clock::now() - start, SLOW_WAIT / 2);
+    EXPECT_EQ(response.function_code(),
+              function_code_t::read_holding_registers);
+    EXPECT_EQ(serverRequests[0x03], 12);
+
+    timer.expires_after(SLOW_WAIT * 2);
+    co_await timer.async_wait(use_awaitable);
+    server.stop();
+    ctx.stop();
+}
+
+TEST(tcp_client, hedges_slow_reads) {
+    serverRequests = {};
+    asio::io_context ctx(1);
+
+    server_config sconfig = server_config{std::string("0.0.0.0"), RETRY_PORT}
+                                .set_logging_handler(print_logging_handler);
+    tcp_server server(ctx.get_executor(),
+                      request_view_handler_t(retry_handler), sconfig);
+    co_spawn(ctx, server.start(), detached);
+
+    client_config cconfig = client_config("127.0.0.1", RETRY_PORT)
+                                .set_max_connections(2)
+                                .set_adaptive_timeout(true)
+                                .set_hedge_percentile(0.9)
+                                .set_logging_handler(print_logging_handler);
+    tcp_client client(ctx.get_executor(), cconfig);
+
+    co_spawn(ctx, hedge_slow_read(ctx, server, client), detached);
+    ctx.run_for(10s);
+}
+
+} // namespace
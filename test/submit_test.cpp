@@ -0,0 +1,148 @@
+#include "modbus/client.hpp"
+#include "modbus/client/mpsc_queue.hpp"
+#include "modbus/server.hpp"
+
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace modbus;
+using namespace std;
+
+const uint16_t SUBMIT_PORT = 5130;
+const size_t PRODUCERS = 4;
+const size_t REQUESTS_PER_PRODUCER = 50;
+
+TEST(mpsc_queue, preserves_order_per_producer) {
+    mpsc_queue<pair<size_t, size_t>> queue;
+    EXPECT_TRUE(queue.idle());
+    EXPECT_FALSE(queue.pop());
+
+    const size_t perProducer = 10000;
+    vector<thread> producers;
+    for (size_t p = 0; p < PRODUCERS; p++) {
+        producers.emplace_back([&queue, p]() {
+            for (size_t i = 0; i < perProducer; i++) {
+                queue.push({p, i});
+            }
+        });
+    }
+
+    // each producer's values arrive in the order they were pushed
+    vector<size_t> next(PRODUCERS, 0);
+    size_t popped = 0;
+    while (popped < PRODUCERS * perProducer) {
+        if (auto value = queue.pop()) {
+            EXPECT_EQ(value->second, next[value->first]);
+            next[value->first] = value->second + 1;
+            popped++;
+        }
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    EXPECT_TRUE(queue.idle());
+    EXPECT_FALSE(queue.pop());
+}
+
+TEST(mpsc_queue, destroys_values_left_in_queue) {
+    auto value = make_shared<int>(1);
+    {
+        mpsc_queue<shared_ptr<int>> queue;
+        queue.push(value);
+        queue.push(value);
+        EXPECT_EQ(value.use_count(), 3);
+    }
+    EXPECT_EQ(value.use_count(), 1);
+}
+
+awaitable<tcp_data_unit> echo_handler(tcp_data_unit_view request) {
+    auto read = request.pdu<read_holding_registers_request>();
+    if (!read) {
+        co_return tcp_data_unit(
+            request.transaction_id(),
+            exception_response(request.unit_id(), request.function_code(),
+                               exception_code_t::illegal_function));
+    }
+    co_return tcp_data_unit(
+        request.transaction_id(),
+        read_holding_registers_response(
+            request.unit_id(), vector<uint16_t>(read->length,
+                                                read->start_address)));
+}
+
+TEST(tcp_client, submit_from_foreign_threads) {
+    asio::io_context serverCtx(1);
+    server_config sconfig = server_config{std::string("0.0.0.0"), SUBMIT_PORT}
+                                .set_logging_handler(print_logging_handler);
+    tcp_server server(serverCtx.get_executor(),
+                      request_view_handler_t(echo_handler), sconfig);
+    co_spawn(serverCtx, server.start(), detached);
+    thread serverThread([&serverCtx]() { serverCtx.run_for(20s); });
+
+    // the client runs on a strand of an io_context with two threads
+    asio::io_context ctx(2);
+    auto work = asio::make_work_guard(ctx);
+    client_config cconfig = client_config("127.0.0.1", SUBMIT_PORT)
+                                .set_max_connections(2)
+                                .set_pipeline_depth(4)
+                                .set_logging_handler(print_logging_handler);
+    tcp_client client(asio::make_strand(ctx), cconfig);
+    vector<thread> runners;
+    for (size_t i = 0; i < 2; i++) {
+        runners.emplace_back([&ctx]() { ctx.run(); });
+    }
+
+    vector<thread> producers;
+    atomic<size_t> succeeded = 0;
+    for (size_t p = 0; p < PRODUCERS; p++) {
+        producers.emplace_back([&client, &succeeded, p]() {
+            vector<future<read_response_t>> responses;
+            for (size_t i = 0; i < REQUESTS_PER_PRODUCER; i++) {
+                responses.push_back(client.submit(
+                    client.create_request(read_holding_registers_request{
+                        1, (uint16_t)p, 2}),
+                    5s));
+            }
+            for (auto& response : responses) {
+                auto [unit, error] = response.get();
+                EXPECT_FALSE(error) << error.message();
+                auto read = unit.pdu<read_holding_registers_response>();
+                if (!error && read) {
+                    EXPECT_THAT(read->values, testing::ElementsAre(p, p));
+                    succeeded++;
+                }
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    EXPECT_EQ(succeeded, PRODUCERS * REQUESTS_PER_PRODUCER);
+
+    // handlers receive the response on the executor of the client
+    promise<bool> answered;
+    client.submit(
+        client.create_request(read_holding_registers_request{1, 0, 1}),
+        [&answered](read_response_t response) {
+            answered.set_value(!get<1>(response));
+        });
+    EXPECT_TRUE(answered.get_future().get());
+
+    work.reset();
+    ctx.stop();
+    for (auto& runner : runners) {
+        runner.join();
+    }
+    server.stop();
+    serverCtx.stop();
+    serverThread.join();
+}
+
+} // namespace
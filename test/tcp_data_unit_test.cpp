@@ -889,4 +889,19 @@ TEST(tcp_data_unit, exception_response_two_buffers) {
     EXPECT_EQ(*buffer, data);
 }
 
-} // namespace
\ No newline at end of file
+TEST(tcp_data_unit, oversized_length_field) {
+    // a buffer larger than a frame is cut at the length field
+    buffer_t data(MAX_APU_SIZE + 10, 0);
+    buffer_t frame{0x00, 0x17, 0x00, 0x00, 0x00, 0x03, 0x11, 0x81, 0x02};
+    std::copy(frame.begin(), frame.end(), data.begin());
+    tcp_data_unit dataUnit(data, data.size(), message_type::response);
+    EXPECT_EQ(*dataUnit.buffer(), frame);
+
+    // a length field larger than any frame is rejected rather than trusted
+    data[4] = 0x01;
+    data[5] = 0x00;
+    EXPECT_THROW(tcp_data_unit(data, data.size(), message_type::response),
+                 std::out_of_range);
+}
+
+} // namespace
@@ -0,0 +1,134 @@
+#include "modbus/core/requests.hpp"
+#include "modbus/core/responses.hpp"
+#include "modbus/core/tcp_data_unit.hpp"
+#include "modbus/core/tcp_data_unit_view.hpp"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace modbus;
+using namespace std;
+
+TEST(tcp_data_unit_view, empty) {
+    tcp_data_unit_view data_unit;
+    EXPECT_EQ(data_unit.type(), message_type::invalid_pdu_type);
+    EXPECT_TRUE(data_unit.buffer().empty());
+    EXPECT_THROW(data_unit.is_exception(), std::out_of_range);
+    EXPECT_THROW(data_unit.exception_code(), std::out_of_range);
+    EXPECT_THROW(data_unit.transaction_id(), std::out_of_range);
+    EXPECT_THROW(data_unit.message_length(), std::out_of_range);
+    EXPECT_THROW(data_unit.unit_id(), std::out_of_range);
+    EXPECT_THROW(data_unit.function_code(), std::out_of_range);
+    EXPECT_FALSE(data_unit.pdu<read_coils_request>());
+    EXPECT_FALSE(data_unit.pdu<exception_response>());
+}
+
+TEST(tcp_data_unit_view, read_coils_request) {
+    read_coils_request request = read_coils_request{17, 19, 37};
+    buffer_t data{0x00, 0x01, 0x00, 0x00, 0x00, 0x06,
+                  0x11, 0x01, 0x00, 0x13, 0x00, 0x25};
+
+    uint16_t transaction_id = 0x0001;
+
+    tcp_data_unit_view dataUnit(data, message_type::request);
+    EXPECT_EQ(dataUnit.transaction_id(), transaction_id);
+    EXPECT_EQ(dataUnit.message_length(), request.size());
+    EXPECT_EQ(dataUnit.unit_id(), request.unit_id);
+    EXPECT_EQ(dataUnit.function_code(), function_code_t::read_coils);
+    EXPECT_FALSE(dataUnit.is_exception());
+    EXPECT_EQ(dataUnit.exception_code(), exception_code_t::no_exception);
+
+    auto optionalRequest = dataUnit.pdu<read_coils_request>();
+    EXPECT_TRUE(optionalRequest);
+    EXPECT_EQ(request, optionalRequest.value());
+
+    auto request3 = dataUnit.pdu<read_discrete_inputs_request>();
+    EXPECT_FALSE(request3);
+
+    // the view references the caller's buffer
+    EXPECT_EQ(dataUnit.buffer().data(), data.data());
+    EXPECT_EQ(dataUnit.buffer().size(), data.size());
+}
+
+TEST(tcp_data_unit_view, oversized_buffer) {
+    write_multiple_registers_request request{17, 1, 2,
+                                             std::vector<uint16_t>{10, 258}};
+    buffer_t data{0x00, 0x0F, 0x00, 0x00, 0x00, 0x0B, 0x11, 0x10, 0x00,
+                  0x01, 0x00, 0x02, 0x04, 0x00, 0x0A, 0x01, 0x02};
+    buffer_t receiveBuffer(MAX_APU_SIZE, 0xFF);
+    std::copy(data.begin(), data.end(), receiveBuffer.begin());
+
+    tcp_data_unit_view dataUnit(receiveBuffer, message_type::request);
+    EXPECT_EQ(dataUnit.transaction_id(), 0x000F);
+    EXPECT_EQ(dataUnit.buffer().size(), data.size());
+
+    auto optionalRequest = dataUnit.pdu<write_multiple_registers_request>();
+    EXPECT_TRUE(optionalRequest);
+    EXPECT_EQ(request, optionalRequest.value());
+
+    // the request is a request, not a response
+    EXPECT_FALSE(dataUnit.pdu<write_multiple_registers_response>());
+}
+
+TEST(tcp_data_unit_view, exception_response) {
+    exception_response response{17, function_code_t::read_coils,
+                                exception_code_t::illegal_data_address};
+    buffer_t data{0x00, 0x17, 0x00, 0x00, 0x00, 0x03, 0x11, 0x81, 0x02};
+
+    tcp_data_unit_view dataUnit(data, message_type::response);
+    EXPECT_EQ(dataUnit.transaction_id(), 0x0017);
+    EXPECT_EQ(dataUnit.message_length(), response.size());
+    EXPECT_TRUE(dataUnit.is_exception());
+    EXPECT_EQ(dataUnit.exception_code(),
+              exception_code_t::illegal_data_address);
+
+    auto optionalResponse = dataUnit.pdu<exception_response>();
+    EXPECT_TRUE(optionalResponse);
+    EXPECT_EQ(response, optionalResponse.value());
+
+    EXPECT_FALSE(dataUnit.pdu<read_coils_response>());
+}
+
+TEST(tcp_data_unit_view, invalid_frames) {
+    buffer_t shortHeader{0x00, 0x01, 0x00, 0x00, 0x00};
+    EXPECT_THROW(tcp_data_unit_view(shortHeader, message_type::request),
+                 std::out_of_range);
+
+    buffer_t badProtocol{0x00, 0x01, 0x00, 0x01, 0x00, 0x06,
+                         0x11, 0x01, 0x00, 0x13, 0x00, 0x25};
+    EXPECT_THROW(tcp_data_unit_view(badProtocol, message_type::request),
+                 std::invalid_argument);
+
+    buffer_t truncated{0x00, 0x01, 0x00, 0x00, 0x00, 0x06,
+                       0x11, 0x01, 0x00, 0x13};
+    EXPECT_THROW(tcp_data_unit_view(truncated, message_type::request),
+                 std::out_of_range);
+
+    // the length field is checked against the largest frame, not the buffer
+    buffer_t oversized(MAX_APU_SIZE + 1);
+    oversized[5] = MAX_APU_SIZE - TCP_HEADER_SIZE + 1;
+    oversized[6] = 0x11;
+    oversized[7] = 0x03;
+    EXPECT_THROW(tcp_data_unit_view(oversized, message_type::request),
+                 std::out_of_range);
+}
+
+TEST(tcp_data_unit_view, to_tcp_data_unit) {
+    read_holding_registers_response response{
+        17, std::vector<uint16_t>{0x0FF0, 0x1234}};
+    tcp_data_unit original(0x0042, response);
+
+    tcp_data_unit_view view(original.bytes(), message_type::response);
+    tcp_data_unit copy(view);
+    EXPECT_EQ(copy.type(), message_type::response);
+    EXPECT_EQ(copy.transaction_id(), 0x0042);
+    EXPECT_EQ(*copy.buffer(), *original.buffer());
+
+    auto optionalResponse = copy.pdu<read_holding_registers_response>();
+    EXPECT_TRUE(optionalResponse);
+    EXPECT_EQ(response, optionalResponse.value());
+}
+
+} // namespace
@@ -0,0 +1,122 @@
+#include "modbus/core/encode.hpp"
+#include "modbus/core/requests.hpp"
+#include "modbus/core/tcp_framer.hpp"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace modbus;
+using namespace std;
+
+/// Three requests back to back.
+buffer_t make_stream() {
+    buffer_t stream(3 * MAX_APU_SIZE);
+    tcp_frame_writer writer(stream);
+    writer.append(1, read_coils_request{17, 19, 37});
+    writer.append(2, write_single_register_request{17, 1, 3});
+    writer.append(
+        3, write_multiple_registers_request{17, 1, 2,
+                                            vector<uint16_t>{0x000A, 0x0102}});
+    stream.resize(writer.size());
+    return stream;
+}
+
+TEST(tcp_framer, concatenated_frames) {
+    auto stream = make_stream();
+    tcp_framer framer(message_type::request);
+    EXPECT_EQ(framer.feed(stream), stream.size());
+
+    auto first = framer.next();
+    EXPECT_TRUE(first);
+    EXPECT_EQ(first->transaction_id(), 1);
+    EXPECT_EQ(first->pdu<read_coils_request>(),
+              (read_coils_request{17, 19, 37}));
+
+    auto second = framer.next();
+    EXPECT_TRUE(second);
+    EXPECT_EQ(second->transaction_id(), 2);
+    EXPECT_EQ(second->function_code(), function_code_t::write_single_register);
+
+    auto third = framer.next();
+    EXPECT_TRUE(third);
+    EXPECT_EQ(third->transaction_id(), 3);
+
+    EXPECT_FALSE(framer.next());
+    EXPECT_EQ(framer.buffered(), 0);
+    EXPECT_EQ(framer.error(), modbus_error_code::success);
+}
+
+TEST(tcp_framer, partial_frames) {
+    auto stream = make_stream();
+
+    // every possible chunk size, including splits inside the header
+    for (size_t chunk = 1; chunk <= stream.size(); chunk++) {
+        tcp_framer framer(message_type::request);
+        vector<uint16_t> transactionIds;
+
+        for (size_t offset = 0; offset < stream.size(); offset += chunk) {
+            auto bytes = span<const uint8_t>(stream).subspan(
+                offset, min(chunk, stream.size() - offset));
+
+            auto space = framer.prepare();
+            ASSERT_GE(space.size(), bytes.size());
+            copy(bytes.begin(), bytes.end(), space.begin());
+            framer.commit(bytes.size());
+
+            while (auto frame = framer.next()) {
+                transactionIds.push_back(frame->transaction_id());
+            }
+        }
+
+        EXPECT_THAT(transactionIds, testing::ElementsAre(1, 2, 3)) << chunk;
+        EXPECT_EQ(framer.buffered(), 0) << chunk;
+    }
+}
+
+TEST(tcp_framer, caller_storage) {
+    auto stream = make_stream();
+
+    // storage for a single frame at a time
+    buffer_t storage(16);
+    tcp_framer framer(storage, message_type::request);
+    EXPECT_EQ(framer.capacity(), 16);
+
+    span<const uint8_t> remaining(stream);
+    size_t frames = 0;
+    while (!remaining.empty() && framer.error() == modbus_error_code::success) {
+        remaining = remaining.subspan(framer.feed(remaining));
+        while (auto frame = framer.next()) {
+            EXPECT_EQ(frame->buffer().data(), storage.data());
+            frames++;
+        }
+    }
+    EXPECT_EQ(frames, 2);
+
+    // the last frame does not fit
+    EXPECT_EQ(framer.error(), modbus_error_code::invalid_length);
+}
+
+TEST(tcp_framer, malformed_stream) {
+    auto stream = make_stream();
+    stream[2] = 0x01;
+
+    tcp_framer framer(message_type::request);
+    framer.feed(stream);
+    EXPECT_FALSE(framer.next());
+    EXPECT_EQ(framer.error(), modbus_error_code::invalid_protocol_id);
+
+    // the stream cannot be resynchronized until it is reset
+    EXPECT_FALSE(framer.next());
+    framer.reset();
+    EXPECT_EQ(framer.buffered(), 0);
+    EXPECT_EQ(framer.error(), modbus_error_code::success);
+
+    buffer_t tooLong{0x00, 0x01, 0x00, 0x00, 0x01, 0x00, 0x11, 0x03};
+    framer.feed(tooLong);
+    EXPECT_FALSE(framer.next());
+    EXPECT_EQ(framer.error(), modbus_error_code::invalid_length);
+}
+
+} // namespace
@@ -0,0 +1,358 @@
+#include "modbus/client.hpp"
+#include "modbus/server.hpp"
+
+#include <array>
+#include <map>
+#include <random>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace modbus;
+using namespace std;
+
+const uint16_t PIPELINE_PORT = 5050;
+const uint16_t SLOW_ADDRESS = 100;
+const std::chrono::milliseconds SLOW_WAIT = 200ms;
+
+/// Answers read_holding_registers_request with registers that hold their own
+/// address. Reads of SLOW_ADDRESS are answered after SLOW_WAIT.
+awaitable<tcp_data_unit> echo_address_handler(tcp_data_unit_view request) {
+    auto optionalRequest = request.pdu<read_holding_registers_request>();
+    if (!optionalRequest) {
+        co_return tcp_data_unit(
+            request.transaction_id(),
+            exception_response(request.unit_id(), request.function_code(),
+                               exception_code_t::illegal_function));
+    }
+
+    auto pdu = optionalRequest.value();
+    if (pdu.start_address == SLOW_ADDRESS) {
+        asio::steady_timer timer(co_await asio::this_coro::executor,
+                                 SLOW_WAIT);
+        co_await timer.async_wait(use_awaitable);
+    }
+
+    vector<uint16_t> values(pdu.length);
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = pdu.start_address + i;
+    }
+    co_return tcp_data_unit(
+        request.transaction_id(),
+        read_holding_registers_response(pdu.unit_id, values));
+}
+
+awaitable<void> read_address(tcp_client& client, uint16_t address,
+                             size_t& completed) {
+    auto request =
+        client.create_request(read_holding_registers_request{1, address, 2});
+    auto [response, error] = co_await client.send_request(request, 1s);
+    EXPECT_FALSE(error) << error.message();
+    EXPECT_EQ(response.transaction_id(), request.transaction_id());
+
+    auto pdu = response.pdu<read_holding_registers_response>();
+    EXPECT_TRUE(pdu);
+    if (pdu) {
+        EXPECT_THAT(pdu->values, testing::ElementsAre(0, address, 0,
+                                                      (uint8_t)(address + 1)));
+    }
+    completed++;
+}
+
+awaitable<void> run_pipelined_requests(asio::io_context& ctx,
+                                       tcp_server& server, tcp_client& client,
+                                       size_t& completed) {
+    asio::steady_timer timer(ctx, 50ms);
+    co_await timer.async_wait(use_awaitable);
+
+    // more requests than the window, all on one connection
+    for (uint16_t address = 0; address < 32; address++) {
+        co_spawn(ctx, read_address(client, address, completed), detached);
+    }
+    while (completed < 32) {
+        timer.expires_after(10ms);
+        co_await timer.async_wait(use_awaitable);
+    }
+
+    server.stop();
+    ctx.stop();
+}
+
+awaitable<void> run_stale_response(asio::io_context& ctx, tcp_server& server,
+                                   tcp_client& client, size_t& completed) {
+    asio::steady_timer timer(ctx, 50ms);
+    co_await timer.async_wait(use_awaitable);
+
+    auto [response, error] = co_await client.send_request(
+        client.create_request(
+            read_holding_registers_request{1, SLOW_ADDRESS, 2}),
+        SLOW_WAIT / 4);
+    EXPECT_EQ(error.value(), (int)modbus_client_error_code::read_timeout);
+
+    // the late response to the first request must not be taken for the
+    // response to the second
+    co_await read_address(client, 7, completed);
+
+    server.stop();
+    ctx.stop();
+}
+
+awaitable<void> run_direct_pipeline(asio::io_context& ctx, tcp_server& server,
+                                    size_t& completed) {
+    asio::steady_timer timer(ctx, 50ms);
+    co_await timer.async_wait(use_awaitable);
+
+    cpool::tcp_connection connection(ctx.get_executor(), "127.0.0.1",
+                                     PIPELINE_PORT + 3);
+    auto connectError = co_await connection.async_connect();
+    EXPECT_FALSE(connectError) << connectError.message();
+    auto pipeline = make_shared<tcp_pipeline>(ctx.get_executor(), &connection,
+                                              4, print_logging_handler);
+
+    // each response is read back by the reader of the pipeline
+    for (uint16_t address = 0; address < 3; address++) {
+        tcp_data_unit request(address,
+                              read_holding_registers_request{1, address, 2});
+        array<uint8_t, MAX_APU_SIZE> buffer;
+        auto [response, error] = co_await pipeline->send_request(
+            request.view(), buffer, tcp_pipeline::clock_type::now() + 1s);
+        EXPECT_FALSE(error) << error.message();
+        EXPECT_EQ(response.transaction_id(), address);
+        auto pdu = response.pdu<read_holding_registers_response>();
+        EXPECT_TRUE(pdu);
+        if (pdu) {
+            EXPECT_THAT(pdu->values,
+                        testing::ElementsAre(0, address, 0,
+                                             (uint8_t)(address + 1)));
+            completed++;
+        }
+    }
+    EXPECT_FALSE(pipeline->failed());
+
+    server.stop();
+    ctx.stop();
+}
+
+awaitable<void> cancellable_read(tcp_client& client, uint16_t address,
+                                 cpool::error& result, bool& done) {
+    auto [response, error] = co_await client.send_request(
+        client.create_request(read_holding_registers_request{1, address, 2}),
+        1s);
+    result = error;
+    done = true;
+}
+
+awaitable<void> run_cancelled_requests(asio::io_context& ctx,
+                                       tcp_server& server, tcp_client& client,
+                                       size_t& completed) {
+    asio::steady_timer timer(ctx, 50ms);
+    co_await timer.async_wait(use_awaitable);
+
+    // the window holds one request, so the second waits for the first
+    asio::cancellation_signal slowSignal;
+    asio::cancellation_signal waitingSignal;
+    cpool::error slowError;
+    cpool::error waitingError;
+    bool slowDone = false;
+    bool waitingDone = false;
+    co_spawn(ctx, cancellable_read(client, SLOW_ADDRESS, slowError, slowDone),
+             asio::bind_cancellation_slot(slowSignal.slot(), detached));
+    co_spawn(ctx, cancellable_read(client, 7, waitingError, waitingDone),
+             asio::bind_cancellation_slot(waitingSignal.slot(), detached));
+
+    // a request waiting for a slot stops waiting
+    timer.expires_after(SLOW_WAIT / 10);
+    co_await timer.async_wait(use_awaitable);
+    waitingSignal.emit(asio::cancellation_type::terminal);
+    timer.expires_after(SLOW_WAIT / 10);
+    co_await timer.async_wait(use_awaitable);
+    EXPECT_TRUE(waitingDone);
+    EXPECT_EQ(waitingError.value(), (int)modbus_client_error_code::cancelled);
+    EXPECT_FALSE(slowDone);
+
+    // a request in flight gives up its slot long before its response
+    slowSignal.emit(asio::cancellation_type::terminal);
+    timer.expires_after(SLOW_WAIT / 10);
+    co_await timer.async_wait(use_awaitable);
+    EXPECT_TRUE(slowDone);
+    EXPECT_EQ(slowError.value(), (int)modbus_client_error_code::cancelled);
+
+    // the connection is still usable and the late response is dropped
+    co_await read_address(client, 7, completed);
+
+    // a response that arrives after its request was cancelled finds nothing
+    // waiting for it, and the next request is answered normally
+    asio::cancellation_signal lateSignal;
+    cpool::error lateError;
+    bool lateDone = false;
+    co_spawn(ctx, cancellable_read(client, SLOW_ADDRESS, lateError, lateDone),
+             asio::bind_cancellation_slot(lateSignal.slot(), detached));
+    timer.expires_after(SLOW_WAIT / 10);
+    co_await timer.async_wait(use_awaitable);
+    lateSignal.emit(asio::cancellation_type::terminal);
+    timer.expires_after(SLOW_WAIT * 2);
+    co_await timer.async_wait(use_awaitable);
+    EXPECT_TRUE(lateDone);
+    EXPECT_EQ(lateError.value(), (int)modbus_client_error_code::cancelled);
+    co_await read_address(client, 8, completed);
+
+    // a deadline bounds the request
+    auto request = client.create_request(
+        read_holding_registers_request{1, SLOW_ADDRESS, 2});
+    array<uint8_t, MAX_APU_SIZE> buffer;
+    auto [response, error] = co_await client.send_request(
+        request.view(), buffer,
+        tcp_pipeline::clock_type::now() + SLOW_WAIT / 4);
+    EXPECT_EQ(error.value(), (int)modbus_client_error_code::read_timeout);
+
+    server.stop();
+    ctx.stop();
+}
+
+TEST(transaction_table, insert_find_erase) {
+    int values[4];
+    transaction_table<int> table(4);
+    EXPECT_TRUE(table.insert(0xFFFE, &values[0]));
+    EXPECT_TRUE(table.insert(0xFFFF, &values[1]));
+    EXPECT_TRUE(table.insert(0x0000, &values[2]));
+    EXPECT_FALSE(table.insert(0xFFFF, &values[3]));
+    EXPECT_EQ(table.size(), 3);
+
+    // IDs are matched exactly across the wraparound
+    EXPECT_EQ(table.find(0xFFFF), &values[1]);
+    EXPECT_EQ(table.find(0x0000), &values[2]);
+    EXPECT_EQ(table.find(0x0001), nullptr);
+
+    EXPECT_TRUE(table.insert(0x0008, &values[3]));
+    EXPECT_TRUE(table.full());
+    EXPECT_FALSE(table.insert(0x0001, &values[3]));
+
+    EXPECT_EQ(table.erase(0xFFFF), &values[1]);
+    EXPECT_EQ(table.erase(0xFFFF), nullptr);
+    EXPECT_EQ(table.find(0x0008), &values[3]);
+
+    size_t cleared = 0;
+    table.clear([&](int*) { cleared++; });
+    EXPECT_EQ(cleared, 3);
+    EXPECT_TRUE(table.empty());
+    EXPECT_EQ(table.find(0x0000), nullptr);
+}
+
+TEST(transaction_table, random_operations) {
+    int value;
+    transaction_table<int> table(16);
+    map<uint16_t, int*> expected;
+    mt19937 random(1234);
+
+    // IDs that collide in the table exercise the probe sequences
+    for (size_t i = 0; i < 100000; i++) {
+        uint16_t transactionId = (random() % 64) * 8;
+        if (random() % 2) {
+            bool inserted = table.insert(transactionId, &value);
+            EXPECT_EQ(inserted, expected.size() < 16 &&
+                                    !expected.contains(transactionId));
+            if (inserted) {
+                expected[transactionId] = &value;
+            }
+        } else {
+            EXPECT_EQ(table.erase(transactionId) != nullptr,
+                      expected.erase(transactionId) == 1);
+        }
+
+        ASSERT_EQ(table.size(), expected.size());
+        for (auto [id, pointer] : expected) {
+            ASSERT_EQ(table.find(id), pointer);
+        }
+    }
+}
+
+TEST(tcp_pipeline, pipelined_requests) {
+    asio::io_context ctx(1);
+
+    server_config sconfig = server_config{std::string("0.0.0.0"),
+                                          PIPELINE_PORT}
+                                .set_logging_handler(print_logging_handler);
+    tcp_server server(ctx.get_executor(),
+                      request_view_handler_t(echo_address_handler), sconfig);
+    co_spawn(ctx, server.start(), detached);
+
+    client_config cconfig = client_config("127.0.0.1", PIPELINE_PORT)
+                                .set_pipeline_depth(8)
+                                .set_logging_handler(print_logging_handler);
+    tcp_client client(ctx.get_executor(), cconfig);
+
+    size_t completed = 0;
+    co_spawn(ctx, run_pipelined_requests(ctx, server, client, completed),
+             detached);
+
+    ctx.run_for(10s);
+    EXPECT_EQ(completed, 32);
+}
+
+TEST(tcp_pipeline, stale_responses_are_dropped) {
+    asio::io_context ctx(1);
+
+    server_config sconfig = server_config{std::string("0.0.0.0"),
+                                          PIPELINE_PORT + 1}
+                                .set_logging_handler(print_logging_handler);
+    tcp_server server(ctx.get_executor(),
+                      request_view_handler_t(echo_address_handler), sconfig);
+    co_spawn(ctx, server.start(), detached);
+
+    client_config cconfig = client_config("127.0.0.1", PIPELINE_PORT + 1)
+                                .set_pipeline_depth(4)
+                                .set_logging_handler(print_logging_handler);
+    tcp_client client(ctx.get_executor(), cconfig);
+
+    size_t completed = 0;
+    co_spawn(ctx, run_stale_response(ctx, server, client, completed),
+             detached);
+
+    ctx.run_for(10s);
+    EXPECT_EQ(completed, 1);
+}
+
+TEST(tcp_pipeline, cancelled_requests_free_their_slot) {
+    asio::io_context ctx(1);
+
+    server_config sconfig = server_config{std::string("0.0.0.0"),
+                                          PIPELINE_PORT + 2}
+                                .set_logging_handler(print_logging_handler);
+    tcp_server server(ctx.get_executor(),
+                      request_view_handler_t(echo_address_handler), sconfig);
+    co_spawn(ctx, server.start(), detached);
+
+    client_config cconfig = client_config("127.0.0.1", PIPELINE_PORT + 2)
+                                .set_max_connections(1)
+                                .set_pipeline_depth(1)
+                                .set_logging_handler(print_logging_handler);
+    tcp_client client(ctx.get_executor(), cconfig);
+
+    size_t completed = 0;
+    co_spawn(ctx, run_cancelled_requests(ctx, server, client, completed),
+             detached);
+
+    ctx.run_for(10s);
+    EXPECT_EQ(completed, 2);
+}
+
+TEST(tcp_pipeline, reads_responses) {
+    asio::io_context ctx(1);
+
+    server_config sconfig = server_config{std::string("0.0.0.0"),
+                                          PIPELINE_PORT + 3}
+                                .set_logging_handler(print_logging_handler);
+    tcp_server server(ctx.get_executor(),
+                      request_view_handler_t(echo_address_handler), sconfig);
+    co_spawn(ctx, server.start(), detached);
+
+    size_t completed = 0;
+    co_spawn(ctx, run_direct_pipeline(ctx, server, completed), detached);
+
+    ctx.run_for(10s);
+    EXPECT_EQ(completed, 3);
+}
+
+} // namespace
@@ -0,0 +1,251 @@
+#include "modbus/client.hpp"
+#include "modbus/server.hpp"
+
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace modbus;
+using namespace std;
+
+const uint16_t TYPED_PORT = 5100;
+const size_t TABLE_SIZE = 400;
+
+array<uint16_t, TABLE_SIZE> registers{};
+array<bool, TABLE_SIZE> coils{};
+
+tcp_data_unit illegal_address(tcp_data_unit_view request) {
+    return tcp_data_unit(
+        request.transaction_id(),
+        exception_response(request.unit_id(), request.function_code(),
+                           exception_code_t::illegal_data_address));
+}
+
+/// Serves the holding registers and coils held in the tables above.
+awaitable<tcp_data_unit> table_handler(tcp_data_unit_view request) {
+    auto id = request.transaction_id();
+    auto unit = request.unit_id();
+
+    if (auto read = request.pdu<read_holding_registers_request>()) {
+        if (read->start_address + read->length > TABLE_SIZE) {
+            co_return illegal_address(request);
+        }
+        vector<uint16_t> values(registers.begin() + read->start_address,
+                                registers.begin() + read->start_address +
+                                    read->length);
+        co_return tcp_data_unit(id,
+                                read_holding_registers_response(unit, values));
+    }
+    if (auto read = request.pdu<read_coils_request>()) {
+        span<const bool> values(coils.data() + read->start_address,
+                                read->length);
+        co_return tcp_data_unit(id, read_coils_response(unit, values));
+    }
+    if (auto write = request.pdu<write_single_register_request>()) {
+        registers[write->start_address] = write->value;
+        co_return tcp_data_unit(
+            id, write_single_register_response(unit, write->start_address,
+                                               write->value));
+    }
+    if (auto write = request.pdu<write_single_coil_request>()) {
+        coils[write->start_address] = write->value;
+        co_return tcp_data_unit(
+            id, write_single_coil_response(unit, write->start_address,
+                                           write->value));
+    }
+    if (auto write = request.pdu<write_multiple_registers_request_view>()) {
+        write->values.copy_to(span(registers).subspan(write->start_address));
+        co_return tcp_data_unit(
+            id, write_multiple_registers_response(unit, write->start_address,
+                                                  write->length));
+    }
+    if (auto write = request.pdu<write_multiple_coils_request_view>()) {
+        write->values.copy_to(
+            span(coils).subspan(write->start_address, write->length));
+        co_return tcp_data_unit(
+            id, write_multiple_coils_response(unit, write->start_address,
+                                              write->length));
+    }
+    co_return tcp_data_unit(
+        id, exception_response(unit, request.function_code(),
+                               exception_code_t::illegal_function));
+}
+
+awaitable<void> read_and_write(asio::io_context& ctx, tcp_server& server,
+                               tcp_client& client) {
+    asio::steady_timer timer(ctx, 50ms);
+    co_await timer.async_wait(use_awaitable);
+
+    array<uint16_t, 4> values = {1, 2, 0x1234, 0xFFFF};
+    auto error = co_await client.write_registers(1, 10, values);
+    EXPECT_FALSE(error) << error.message();
+    error = co_await client.write_single_register(1, 14, 5);
+    EXPECT_FALSE(error) << error.message();
+
+    array<uint16_t, 5> readValues{};
+    error = co_await client.read_holding_registers(1, 10, 5, readValues);
+    EXPECT_FALSE(error) << error.message();
+    EXPECT_THAT(readValues, testing::ElementsAre(1, 2, 0x1234, 0xFFFF, 5));
+
+    array<bool, 11> bits = {true, false, true, true, false, false,
+                            false, false, true, false, true};
+    error = co_await client.write_coils(1, 3, bits);
+    EXPECT_FALSE(error) << error.message();
+    error = co_await client.write_single_coil(1, 14, true);
+    EXPECT_FALSE(error) << error.message();
+
+    array<bool, 12> readBits{};
+    error = co_await client.read_coils(1, 3, 12, readBits);
+    EXPECT_FALSE(error) << error.message();
+    EXPECT_THAT(readBits, testing::ElementsAre(true, false, true, true, false,
+                                               false, false, false, true,
+                                               false, true, true));
+
+    // exception responses are returned as their exception code
+    error = co_await client.read_holding_registers(1, TABLE_SIZE, 1,
+                                                   readValues);
+    EXPECT_EQ(error, cpool::error(exception_code_t::illegal_data_address));
+    error = co_await client.read_input_registers(1, 0, 1, readValues);
+    EXPECT_EQ(error, cpool::error(exception_code_t::illegal_function));
+
+    // quantities are checked before anything is sent
+    error = co_await client.read_holding_registers(1, 0, 6, readValues);
+    EXPECT_EQ(error, cpool::error(modbus_error_code::invalid_quantity));
+    error = co_await client.write_registers(1, 0, span<const uint16_t>());
+    EXPECT_EQ(error, cpool::error(modbus_error_code::invalid_quantity));
+    unique_ptr<bool[]> manyBits(new bool[MAX_WRITE_BITS + 1]());
+    error = co_await client.write_coils(
+        1, 0, span<const bool>(manyBits.get(), MAX_WRITE_BITS + 1));
+    EXPECT_EQ(error, cpool::error(modbus_error_code::invalid_quantity));
+
+    // ranges larger than one request are split and read in order
+    for (size_t i = 0; i < TABLE_SIZE; i++) {
+        registers[i] = (uint16_t)i;
+    }
+    vector<uint16_t> range(300);
+    auto errors = co_await client.read_range(1, data_model_t::holding_register,
+                                             50, range);
+    EXPECT_TRUE(errors.empty());
+    for (size_t i = 0; i < range.size(); i++) {
+        EXPECT_EQ(range[i], 50 + i);
+    }
+
+    // requests past the end of the table fail on their own
+    vector<uint16_t> tail(300, 0xAAAA);
+    errors = co_await client.read_range(1, data_model_t::holding_register, 200,
+                                        tail);
+    EXPECT_EQ(errors.size(), 2);
+    if (errors.size() == 2) {
+        EXPECT_EQ(errors[0].address, 325);
+        EXPECT_EQ(errors[0].quantity, 125);
+        EXPECT_EQ(errors[0].error,
+                  cpool::error(exception_code_t::illegal_data_address));
+        EXPECT_EQ(errors[1].address, 450);
+        EXPECT_EQ(errors[1].quantity, 50);
+    }
+    EXPECT_EQ(tail[0], 200);
+    EXPECT_EQ(tail[124], 324);
+    EXPECT_EQ(tail[125], 0xAAAA);
+
+    errors = co_await client.read_range(1, data_model_t::holding_register,
+                                        0xFFFF, tail);
+    EXPECT_EQ(errors.size(), 1);
+    if (!errors.empty()) {
+        EXPECT_EQ(errors[0].error,
+                  cpool::error(modbus_error_code::invalid_quantity));
+    }
+
+    server.stop();
+    ctx.stop();
+}
+
+awaitable<void> warm_read(asio::io_context& ctx, tcp_server& server,
+                          tcp_client& client) {
+    auto error = co_await client.ready();
+    EXPECT_FALSE(error) << error.message();
+
+    array<uint16_t, 2> values{};
+    error = co_await client.read_holding_registers(1, 0, 2, values);
+    EXPECT_FALSE(error) << error.message();
+
+    server.stop();
+    ctx.stop();
+}
+
+awaitable<void> reconfigured_read(asio::io_context& ctx, tcp_server& server,
+                                  tcp_client& client, bool& finished) {
+    co_await warm_read(ctx, server, client);
+    finished = true;
+}
+
+TEST(tcp_client, typed_reads_and_writes) {
+    asio::io_context ctx(1);
+
+    server_config sconfig = server_config{std::string("0.0.0.0"), TYPED_PORT}
+                                .set_logging_handler(print_logging_handler);
+    tcp_server server(ctx.get_executor(),
+                      request_view_handler_t(table_handler), sconfig);
+    co_spawn(ctx, server.start(), detached);
+
+    client_config cconfig = client_config("127.0.0.1", TYPED_PORT)
+                                .set_logging_handler(print_logging_handler);
+    tcp_client client(ctx.get_executor(), cconfig);
+
+    co_spawn(ctx, read_and_write(ctx, server, client), detached);
+    ctx.run_for(10s);
+}
+
+TEST(tcp_client, warm_connections) {
+    asio::io_context ctx(1);
+
+    server_config sconfig =
+        server_config{std::string("0.0.0.0"), TYPED_PORT + 1}
+            .set_logging_handler(print_logging_handler);
+    tcp_server server(ctx.get_executor(),
+                      request_view_handler_t(table_handler), sconfig);
+    co_spawn(ctx, server.start(), detached);
+
+    client_config cconfig =
+        client_config("127.0.0.1", TYPED_PORT + 1)
+            .set_max_connections(2)
+            .set_warm_connections(2)
+            .set_socket_options(socket_options()
+                                    .set_keep_alive(true)
+                                    .set_keep_alive_idle(30s)
+                                    .set_receive_buffer_size(64 * 1024))
+            .set_logging_handler(print_logging_handler);
+    tcp_client client(ctx.get_executor(), cconfig);
+
+    co_spawn(ctx, warm_read(ctx, server, client), detached);
+    ctx.run_for(10s);
+}
+
+TEST(tcp_client, set_config_during_warm_up) {
+    asio::io_context ctx(1);
+
+    server_config sconfig =
+        server_config{std::string("0.0.0.0"), TYPED_PORT + 2}
+            .set_logging_handler(print_logging_handler);
+    tcp_server server(ctx.get_executor(),
+                      request_view_handler_t(table_handler), sconfig);
+    co_spawn(ctx, server.start(), detached);
+
+    client_config cconfig = client_config("127.0.0.1", TYPED_PORT + 2)
+                                .set_max_connections(2)
+                                .set_warm_connections(2)
+                                .set_logging_handler(print_logging_handler);
+    tcp_client client(ctx.get_executor(), cconfig);
+
+    // the first warm-up is still connecting when the pool is replaced
+    client.set_config(cconfig.set_warm_connections(1));
+
+    bool finished = false;
+    co_spawn(ctx, reconfigured_read(ctx, server, client, finished), detached);
+    ctx.run_for(10s);
+    EXPECT_TRUE(finished);
+}
+
+} // namespace
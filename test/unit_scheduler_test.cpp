@@ -0,0 +1,195 @@
+#include "modbus/client.hpp"
+#include "modbus/server.hpp"
+
+#include <array>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace modbus;
+using namespace std;
+
+const uint16_t SCHEDULER_PORT = 5060;
+const uint8_t SLOW_UNIT = 1;
+const uint8_t FAST_UNIT = 2;
+const std::chrono::milliseconds SLOW_WAIT = 100ms;
+
+/// The number of requests the server is handling for each unit.
+array<size_t, 256> serverInFlight{};
+/// The most requests the server handled at once for each unit.
+array<size_t, 256> serverMaxInFlight{};
+
+/// Answers read_holding_registers_request with zeroes. Requests to SLOW_UNIT
+/// are answered after SLOW_WAIT.
+awaitable<tcp_data_unit> unit_handler(tcp_data_unit_view request) {
+    auto optionalRequest = request.pdu<read_holding_registers_request>();
+    if (!optionalRequest) {
+        co_return tcp_data_unit(
+            request.transaction_id(),
+            exception_response(request.unit_id(), request.function_code(),
+                               exception_code_t::illegal_function));
+    }
+
+    uint8_t unitId = request.unit_id();
+    serverInFlight[unitId]++;
+    serverMaxInFlight[unitId] =
+        max(serverMaxInFlight[unitId], serverInFlight[unitId]);
+
+    asio::steady_timer timer(co_await asio::this_coro::executor,
+                             unitId == SLOW_UNIT ? SLOW_WAIT : 1ms);
+    co_await timer.async_wait(use_awaitable);
+
+    serverInFlight[unitId]--;
+    co_return tcp_data_unit(
+        request.transaction_id(),
+        read_holding_registers_response(
+            unitId, vector<uint16_t>(optionalRequest->length)));
+}
+
+awaitable<void> read_unit(unit_scheduler& scheduler, tcp_client& client,
+                          uint8_t unitId, vector<uint8_t>& completed) {
+    auto [response, error] = co_await scheduler.send_request(
+        client.create_request(read_holding_registers_request{unitId, 0, 1}),
+        5s);
+    EXPECT_FALSE(error) << error.message();
+    EXPECT_EQ(response.unit_id(), unitId);
+    completed.push_back(unitId);
+}
+
+awaitable<void> run_gateway(asio::io_context& ctx, tcp_server& server,
+                            tcp_client& client, unit_scheduler& scheduler,
+                            vector<uint8_t>& completed) {
+    asio::steady_timer timer(ctx, 50ms);
+    co_await timer.async_wait(use_awaitable);
+
+    // the slow unit is queued first but must not hold up the fast unit
+    for (size_t i = 0; i < 3; i++) {
+        co_spawn(ctx, read_unit(scheduler, client, SLOW_UNIT, completed),
+                 detached);
+    }
+    for (size_t i = 0; i < 3; i++) {
+        co_spawn(ctx, read_unit(scheduler, client, FAST_UNIT, completed),
+                 detached);
+    }
+
+    timer.expires_after(1ms);
+    co_await timer.async_wait(use_awaitable);
+    EXPECT_EQ(scheduler.in_flight(SLOW_UNIT), 1);
+    EXPECT_EQ(scheduler.queued(SLOW_UNIT), 2);
+    EXPECT_LE(scheduler.in_flight(), 2);
+
+    while (completed.size() < 6) {
+        timer.expires_after(10ms);
+        co_await timer.async_wait(use_awaitable);
+    }
+
+    server.stop();
+    ctx.stop();
+}
+
+awaitable<void> cancellable_read(unit_scheduler& scheduler, tcp_client& client,
+                                 cpool::error& result, bool& done) {
+    auto [response, error] = co_await scheduler.send_request(
+        client.create_request(read_holding_registers_request{SLOW_UNIT, 0, 1}),
+        5s);
+    result = error;
+    done = true;
+}
+
+awaitable<void> run_cancelled_turn(asio::io_context& ctx, tcp_server& server,
+                                   tcp_client& client,
+                                   unit_scheduler& scheduler,
+                                   vector<uint8_t>& completed) {
+    asio::steady_timer timer(ctx, 50ms);
+    co_await timer.async_wait(use_awaitable);
+
+    // the second request waits for the turn of the first
+    co_spawn(ctx, read_unit(scheduler, client, SLOW_UNIT, completed),
+             detached);
+    asio::cancellation_signal signal;
+    cpool::error cancelledError;
+    bool cancelledDone = false;
+    co_spawn(ctx,
+             cancellable_read(scheduler, client, cancelledError,
+                              cancelledDone),
+             asio::bind_cancellation_slot(signal.slot(), detached));
+    timer.expires_after(1ms);
+    co_await timer.async_wait(use_awaitable);
+    EXPECT_EQ(scheduler.queued(SLOW_UNIT), 1);
+
+    // a cancelled request leaves the queue and is never granted a turn
+    signal.emit(asio::cancellation_type::terminal);
+    timer.expires_after(1ms);
+    co_await timer.async_wait(use_awaitable);
+    EXPECT_TRUE(cancelledDone);
+    EXPECT_EQ(cancelledError.value(),
+              (int)modbus_client_error_code::cancelled);
+    EXPECT_EQ(scheduler.queued(SLOW_UNIT), 0);
+
+    // the unit still takes requests once the first is answered
+    co_await read_unit(scheduler, client, SLOW_UNIT, completed);
+    EXPECT_EQ(completed.size(), 2);
+    EXPECT_EQ(scheduler.in_flight(), 0);
+
+    server.stop();
+    ctx.stop();
+}
+
+TEST(unit_scheduler, units_do_not_block_each_other) {
+    asio::io_context ctx(1);
+
+    server_config sconfig =
+        server_config{std::string("0.0.0.0"), SCHEDULER_PORT}
+            .set_logging_handler(print_logging_handler);
+    tcp_server server(ctx.get_executor(), request_view_handler_t(unit_handler),
+                      sconfig);
+    co_spawn(ctx, server.start(), detached);
+
+    // each connection to the server is handled in order, like a gateway that
+    // can hold two requests at once
+    client_config cconfig = client_config("127.0.0.1", SCHEDULER_PORT)
+                                .set_max_connections(2)
+                                .set_logging_handler(print_logging_handler);
+    tcp_client client(ctx.get_executor(), cconfig);
+    unit_scheduler scheduler(client);
+
+    vector<uint8_t> completed;
+    co_spawn(ctx, run_gateway(ctx, server, client, scheduler, completed),
+             detached);
+
+    ctx.run_for(10s);
+    EXPECT_THAT(completed, testing::ElementsAre(FAST_UNIT, FAST_UNIT, FAST_UNIT,
+                                                SLOW_UNIT, SLOW_UNIT,
+                                                SLOW_UNIT));
+    EXPECT_EQ(serverMaxInFlight[SLOW_UNIT], 1);
+    EXPECT_EQ(serverMaxInFlight[FAST_UNIT], 1);
+}
+
+TEST(unit_scheduler, cancelled_requests_leave_the_queue) {
+    asio::io_context ctx(1);
+
+    server_config sconfig =
+        server_config{std::string("0.0.0.0"), SCHEDULER_PORT + 1}
+            .set_logging_handler(print_logging_handler);
+    tcp_server server(ctx.get_executor(), request_view_handler_t(unit_handler),
+                      sconfig);
+    co_spawn(ctx, server.start(), detached);
+
+    client_config cconfig = client_config("127.0.0.1", SCHEDULER_PORT + 1)
+                                .set_logging_handler(print_logging_handler);
+    tcp_client client(ctx.get_executor(), cconfig);
+    unit_scheduler scheduler(client);
+
+    vector<uint8_t> completed;
+    co_spawn(ctx,
+             run_cancelled_turn(ctx, server, client, scheduler, completed),
+             detached);
+
+    ctx.run_for(10s);
+    EXPECT_THAT(completed, testing::ElementsAre(SLOW_UNIT, SLOW_UNIT));
+}
+
+} // namespace
@@ -0,0 +1,112 @@
+#include "modbus/core/encode.hpp"
+#include "modbus/core/visit.hpp"
+
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace modbus;
+using namespace std;
+
+template <typename... F> struct overloaded : F... { using F::operator()...; };
+template <typename... F> overloaded(F...) -> overloaded<F...>;
+
+/// Encodes a single frame.
+buffer_t make_frame(const auto& pdu) {
+    buffer_t frame(MAX_APU_SIZE);
+    tcp_frame_writer writer(frame);
+    writer.append(1, pdu);
+    frame.resize(writer.size());
+    return frame;
+}
+
+tcp_data_unit_view view_of(const buffer_t& frame, message_type type) {
+    auto view = decode_frame(frame, type);
+    EXPECT_TRUE(view);
+    return *view;
+}
+
+TEST(visit, requests) {
+    auto visitor = overloaded{
+        [](const read_holding_registers_request& request) {
+            return "read " + to_string(request.length);
+        },
+        [](const write_multiple_registers_request_view& request) {
+            return "write " + to_string(request.values.size());
+        },
+        [](const exception_response& response) {
+            return "exception " + to_string((int)response.exception_code);
+        },
+        [](const auto&) { return string("other"); },
+    };
+
+    auto read = make_frame(read_holding_registers_request{17, 19, 37});
+    EXPECT_EQ(visit(view_of(read, message_type::request), visitor), "read 37");
+
+    auto write = make_frame(write_multiple_registers_request{
+        17, 1, 2, vector<uint16_t>{0x000A, 0x0102}});
+    EXPECT_EQ(visit(view_of(write, message_type::request), visitor),
+              "write 2");
+
+    auto coil = make_frame(write_single_coil_request{17, 1, true});
+    EXPECT_EQ(visit(view_of(coil, message_type::request), visitor), "other");
+
+    tcp_data_unit dataUnit(1, read_holding_registers_request{17, 19, 5});
+    EXPECT_EQ(visit(dataUnit, visitor), "read 5");
+}
+
+TEST(visit, illegal_requests) {
+    exception_response result;
+    auto visitor = overloaded{
+        [&](const exception_response& response) { result = response; },
+        [](const auto&) { FAIL(); },
+    };
+
+    // report slave id is not supported
+    buffer_t unsupported{0x00, 0x01, 0x00, 0x00, 0x00, 0x02, 0x11, 0x11};
+    visit(view_of(unsupported, message_type::request), visitor);
+    EXPECT_EQ(result.unit_id, 0x11);
+    EXPECT_EQ(result.function_code(), (function_code_t)0x11);
+    EXPECT_EQ(result.exception_code, exception_code_t::illegal_function);
+
+    // too many registers
+    auto tooMany = make_frame(read_holding_registers_request{17, 0, 126});
+    visit(view_of(tooMany, message_type::request), visitor);
+    EXPECT_EQ(result.function_code(), function_code_t::read_holding_registers);
+    EXPECT_EQ(result.exception_code, exception_code_t::illegal_data_value);
+}
+
+TEST(visit, responses) {
+    vector<uint16_t> registers;
+    exception_response exception;
+    auto visitor = overloaded{
+        [&](const read_holding_registers_response_view& response) {
+            registers = response.values.to_vector();
+            return true;
+        },
+        [&](const exception_response& response) {
+            exception = response;
+            return false;
+        },
+        [](const auto&) { return false; },
+    };
+
+    auto read = make_frame(
+        read_holding_registers_response{17, vector<uint16_t>{0x0102, 0x0304}});
+    EXPECT_TRUE(visit(view_of(read, message_type::response), visitor));
+    EXPECT_THAT(registers, testing::ElementsAre(0x0102, 0x0304));
+
+    auto error = make_frame(
+        exception_response{17, function_code_t::read_holding_registers,
+                           exception_code_t::illegal_data_address});
+    EXPECT_FALSE(visit(view_of(error, message_type::response), visitor));
+    EXPECT_EQ(exception.function_code(),
+              function_code_t::read_holding_registers);
+    EXPECT_EQ(exception.exception_code,
+              exception_code_t::illegal_data_address);
+}
+
+} // namespace
@@ -0,0 +1,333 @@
+#include "modbus/client.hpp"
+#include "modbus/server.hpp"
+
+#include <array>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace modbus;
+using namespace std;
+
+const uint16_t WRITE_QUEUE_PORT = 5110;
+const size_t TABLE_SIZE = 0x10000;
+
+array<uint16_t, TABLE_SIZE> registers{};
+array<bool, TABLE_SIZE> coils{};
+/// The number of requests the server received by function code.
+array<size_t, 256> requestCount{};
+/// The time the server takes to answer a request.
+std::chrono::milliseconds serverDelay(0);
+
+void reset_server() {
+    registers.fill(0);
+    coils.fill(false);
+    requestCount.fill(0);
+    serverDelay = 0ms;
+}
+
+/// Stores writes in the tables above.
+awaitable<tcp_data_unit> write_handler(tcp_data_unit_view request) {
+    auto id = request.transaction_id();
+    auto unit = request.unit_id();
+    requestCount[(uint8_t)request.function_code()]++;
+    if (serverDelay > 0ms) {
+        asio::steady_timer timer(co_await asio::this_coro::executor,
+                                 serverDelay);
+        co_await timer.async_wait(use_awaitable);
+    }
+
+    if (auto write = request.pdu<write_single_register_request>()) {
+        registers[write->start_address] = write->value;
+        co_return tcp_data_unit(
+            id, write_single_register_response(unit, write->start_address,
+                                               write->value));
+    }
+    if (auto write = request.pdu<write_single_coil_request>()) {
+        coils[write->start_address] = write->value;
+        co_return tcp_data_unit(
+            id, write_single_coil_response(unit, write->start_address,
+                                           write->value));
+    }
+    if (auto write = request.pdu<write_multiple_registers_request_view>()) {
+        write->values.copy_to(span(registers).subspan(write->start_address));
+        co_return tcp_data_unit(
+            id, write_multiple_registers_response(unit, write->start_address,
+                                                  write->length));
+    }
+    if (auto write = request.pdu<write_multiple_coils_request_view>()) {
+        write->values.copy_to(
+            span(coils).subspan(write->start_address, write->length));
+        co_return tcp_data_unit(
+            id, write_multiple_coils_response(unit, write->start_address,
+                                              write->length));
+    }
+    co_return tcp_data_unit(
+        id, exception_response(unit, request.function_code(),
+                               exception_code_t::illegal_function));
+}
+
+awaitable<void> queue_register(write_queue& queue, uint16_t address,
+                               uint16_t value, size_t& completed) {
+    auto error = co_await queue.write_register(1, address, value, 5s);
+    EXPECT_FALSE(error) << error.message();
+    completed++;
+}
+
+awaitable<void> queue_coil(write_queue& queue, uint16_t address, bool value,
+                           size_t& completed) {
+    auto error =
+        co_await queue.write(write_single_coil_request{1, address, value}, 5s);
+    EXPECT_FALSE(error) << error.message();
+    completed++;
+}
+
+/// Writes a register and records how the write ended.
+awaitable<void> queue_result(write_queue& queue, uint16_t address,
+                             uint16_t value, cpool::error& result,
+                             bool& done) {
+    result = co_await queue.write_register(1, address, value, 5s);
+    done = true;
+}
+
+/// Runs test against a server on port and a queue with a 5ms window.
+void run_queue(uint16_t port,
+               std::function<awaitable<void>(asio::io_context&, write_queue&)>
+                   test) {
+    reset_server();
+    asio::io_context ctx(1);
+
+    server_config sconfig = server_config{std::string("0.0.0.0"), port}
+                                .set_logging_handler(print_logging_handler);
+    tcp_server server(ctx.get_executor(),
+                      request_view_handler_t(write_handler), sconfig);
+    co_spawn(ctx, server.start(), detached);
+
+    client_config cconfig = client_config("127.0.0.1", port)
+                                .set_logging_handler(print_logging_handler);
+    tcp_client client(ctx.get_executor(), cconfig);
+    write_queue queue(client, 5ms);
+
+    auto run = [&]() -> awaitable<void> {
+        asio::steady_timer timer(ctx, 50ms);
+        co_await timer.async_wait(use_awaitable);
+        co_await test(ctx, queue);
+        server.stop();
+        ctx.stop();
+    };
+    co_spawn(ctx, run(), detached);
+    ctx.run_for(10s);
+}
+
+/// Waits until the writes of the current window have been answered.
+awaitable<void> settle(asio::io_context& ctx) {
+    asio::steady_timer timer(ctx, 100ms);
+    co_await timer.async_wait(use_awaitable);
+}
+
+awaitable<void> coalesce(asio::io_context& ctx, tcp_server& server,
+                         write_queue& queue) {
+    asio::steady_timer timer(ctx, 50ms);
+    co_await timer.async_wait(use_awaitable);
+
+    // registers 10 to 19 are one run; 15 is written twice
+    size_t completed = 0;
+    for (uint16_t i = 0; i < 10; i++) {
+        co_spawn(ctx, queue_register(queue, 10 + i, 100 + i, completed),
+                 detached);
+    }
+    co_spawn(ctx, queue_register(queue, 15, 999, completed), detached);
+    co_spawn(ctx, queue_register(queue, 50, 7, completed), detached);
+    for (uint16_t i = 0; i < 4; i++) {
+        co_spawn(ctx, queue_coil(queue, 20 + i, i % 2 == 0, completed),
+                 detached);
+    }
+
+    timer.expires_after(500ms);
+    co_await timer.async_wait(use_awaitable);
+
+    EXPECT_EQ(completed, 16);
+    EXPECT_EQ(queue.queued(), 0);
+    EXPECT_EQ(queue.requests_sent(), 3);
+    EXPECT_EQ(requestCount[(uint8_t)function_code_t::write_multiple_registers],
+              1);
+    EXPECT_EQ(requestCount[(uint8_t)function_code_t::write_single_register],
+              1);
+    EXPECT_EQ(requestCount[(uint8_t)function_code_t::write_multiple_coils], 1);
+
+    EXPECT_THAT(span(registers).subspan(10, 10),
+                testing::ElementsAre(100, 101, 102, 103, 104, 999, 106, 107,
+                                     108, 109));
+    EXPECT_EQ(registers[50], 7);
+    EXPECT_THAT(span(coils).subspan(20, 4),
+                testing::ElementsAre(true, false, true, false));
+
+    server.stop();
+    ctx.stop();
+}
+
+TEST(write_queue, merges_contiguous_writes) {
+    asio::io_context ctx(1);
+
+    server_config sconfig =
+        server_config{std::string("0.0.0.0"), WRITE_QUEUE_PORT}
+            .set_logging_handler(print_logging_handler);
+    tcp_server server(ctx.get_executor(),
+                      request_view_handler_t(write_handler), sconfig);
+    co_spawn(ctx, server.start(), detached);
+
+    client_config cconfig = client_config("127.0.0.1", WRITE_QUEUE_PORT)
+                                .set_logging_handler(print_logging_handler);
+    tcp_client client(ctx.get_executor(), cconfig);
+    write_queue queue(client, 5ms);
+
+    co_spawn(ctx, coalesce(ctx, server, queue), detached);
+    ctx.run_for(10s);
+}
+
+TEST(write_queue, cancelled_writes_are_not_sent) {
+    run_queue(WRITE_QUEUE_PORT + 1, [](asio::io_context& ctx,
+                                       write_queue& queue) -> awaitable<void> {
+        size_t completed = 0;
+        co_spawn(ctx, queue_register(queue, 30, 1, completed), detached);
+
+        // a later write to the same address and a write of its own
+        asio::cancellation_signal replaced;
+        cpool::error replacedError;
+        bool replacedDone = false;
+        co_spawn(ctx,
+                 queue_result(queue, 30, 2, replacedError, replacedDone),
+                 asio::bind_cancellation_slot(replaced.slot(), detached));
+        asio::cancellation_signal alone;
+        cpool::error aloneError;
+        bool aloneDone = false;
+        co_spawn(ctx, queue_result(queue, 40, 3, aloneError, aloneDone),
+                 asio::bind_cancellation_slot(alone.slot(), detached));
+
+        asio::steady_timer timer(ctx, 1ms);
+        co_await timer.async_wait(use_awaitable);
+        EXPECT_EQ(queue.queued(), 2);
+
+        // writes cancelled before the window closes are not sent
+        replaced.emit(asio::cancellation_type::terminal);
+        alone.emit(asio::cancellation_type::terminal);
+        timer.expires_after(1ms);
+        co_await timer.async_wait(use_awaitable);
+        EXPECT_TRUE(replacedDone);
+        EXPECT_EQ(replacedError.value(),
+                  (int)modbus_client_error_code::cancelled);
+        EXPECT_TRUE(aloneDone);
+        EXPECT_EQ(aloneError.value(),
+                  (int)modbus_client_error_code::cancelled);
+        EXPECT_EQ(queue.queued(), 1);
+
+        co_await settle(ctx);
+        EXPECT_EQ(completed, 1);
+        EXPECT_EQ(queue.requests_sent(), 1);
+        EXPECT_EQ(registers[30], 1);
+        EXPECT_EQ(registers[40], 0);
+
+        // a write cancelled after its window closed still reaches the device
+        serverDelay = 20ms;
+        asio::cancellation_signal sent;
+        cpool::error sentError;
+        bool sentDone = false;
+        co_spawn(ctx, queue_result(queue, 60, 5, sentError, sentDone),
+                 asio::bind_cancellation_slot(sent.slot(), detached));
+        timer.expires_after(10ms);
+        co_await timer.async_wait(use_awaitable);
+        sent.emit(asio::cancellation_type::terminal);
+        timer.expires_after(1ms);
+        co_await timer.async_wait(use_awaitable);
+        EXPECT_TRUE(sentDone);
+        EXPECT_EQ(sentError.value(), (int)modbus_client_error_code::cancelled);
+
+        co_await settle(ctx);
+        EXPECT_EQ(queue.requests_sent(), 2);
+        EXPECT_EQ(registers[60], 5);
+    });
+}
+
+TEST(write_queue, runs_are_split_at_the_request_limits) {
+    run_queue(WRITE_QUEUE_PORT + 2, [](asio::io_context& ctx,
+                                       write_queue& queue) -> awaitable<void> {
+        size_t completed = 0;
+        for (uint16_t i = 0; i <= MAX_WRITE_REGISTERS; i++) {
+            co_spawn(ctx, queue_register(queue, i, i + 1, completed),
+                     detached);
+        }
+        for (uint16_t i = 0; i < MAX_WRITE_BITS + 2; i++) {
+            co_spawn(ctx, queue_coil(queue, i, true, completed), detached);
+        }
+
+        co_await settle(ctx);
+        EXPECT_EQ(completed, MAX_WRITE_REGISTERS + MAX_WRITE_BITS + 3);
+        EXPECT_EQ(queue.requests_sent(), 4);
+        EXPECT_EQ(
+            requestCount[(uint8_t)function_code_t::write_multiple_registers],
+            1);
+        EXPECT_EQ(
+            requestCount[(uint8_t)function_code_t::write_single_register], 1);
+        EXPECT_EQ(
+            requestCount[(uint8_t)function_code_t::write_multiple_coils], 2);
+        EXPECT_EQ(registers[MAX_WRITE_REGISTERS - 1], MAX_WRITE_REGISTERS);
+        EXPECT_EQ(registers[MAX_WRITE_REGISTERS], MAX_WRITE_REGISTERS + 1);
+        EXPECT_TRUE(coils[MAX_WRITE_BITS + 1]);
+    });
+}
+
+TEST(write_queue, runs_end_at_the_last_address) {
+    run_queue(WRITE_QUEUE_PORT + 3, [](asio::io_context& ctx,
+                                       write_queue& queue) -> awaitable<void> {
+        // the coils of a unit follow its registers in the batch, but are not
+        // contiguous with them
+        size_t completed = 0;
+        co_spawn(ctx, queue_register(queue, 0xFFFE, 1, completed), detached);
+        co_spawn(ctx, queue_register(queue, 0xFFFF, 2, completed), detached);
+        co_spawn(ctx, queue_coil(queue, 0, true, completed), detached);
+        co_spawn(ctx, queue_coil(queue, 1, true, completed), detached);
+
+        co_await settle(ctx);
+        EXPECT_EQ(completed, 4);
+        EXPECT_EQ(queue.requests_sent(), 2);
+        EXPECT_EQ(
+            requestCount[(uint8_t)function_code_t::write_multiple_registers],
+            1);
+        EXPECT_EQ(
+            requestCount[(uint8_t)function_code_t::write_multiple_coils], 1);
+        EXPECT_EQ(registers[0xFFFF], 2);
+        EXPECT_TRUE(coils[1]);
+    });
+}
+
+TEST(write_queue, writes_during_a_send_open_a_new_window) {
+    run_queue(WRITE_QUEUE_PORT + 4, [](asio::io_context& ctx,
+                                       write_queue& queue) -> awaitable<void> {
+        serverDelay = 20ms;
+        size_t completed = 0;
+        co_spawn(ctx, queue_register(queue, 70, 1, completed), detached);
+
+        // the first window has closed and its write is in flight
+        asio::steady_timer timer(ctx, 10ms);
+        co_await timer.async_wait(use_awaitable);
+        EXPECT_EQ(queue.requests_sent(), 1);
+        EXPECT_EQ(completed, 0);
+
+        co_spawn(ctx, queue_register(queue, 70, 2, completed), detached);
+        co_spawn(ctx, queue_register(queue, 71, 3, completed), detached);
+        timer.expires_after(1ms);
+        co_await timer.async_wait(use_awaitable);
+        EXPECT_EQ(queue.queued(), 2);
+
+        co_await settle(ctx);
+        EXPECT_EQ(completed, 3);
+        EXPECT_EQ(queue.requests_sent(), 2);
+        EXPECT_EQ(registers[70], 2);
+        EXPECT_EQ(registers[71], 3);
+    });
+}
+
+} // namespace